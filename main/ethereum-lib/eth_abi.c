@@ -1,155 +1,481 @@
 #include "eth_abi.h"
-#include "eth_rpc.h"  // 添加对eth_rpc.h的引用
+#include "eth_keccak.h"
+#include "eth_hex.h"
+#include "eth_uint256.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <esp_log.h>
+#include <freertos/FreeRTOS.h>
 #include <mbedtls/md.h>
 
 static const char *TAG = "ETH_ABI";
 
-// 填充到32字节边界的辅助函数
-static void pad_to_32_bytes(uint8_t* buffer, size_t data_len) {
-    size_t padding_len = 32 - (data_len % 32);
-    if (padding_len < 32) {
-        memset(buffer + data_len, 0, padding_len);
+// 本地计算Keccak256哈希，取前4个字节作为函数选择器
+esp_err_t abi_encode_function_selector(web3_context_t* context, const char* signature, uint8_t selector[4]) {
+    (void)context; // 不再需要通过节点的web3_sha3计算哈希
+    
+    if (!signature || !selector) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    uint8_t hash[ETH_KECCAK256_HASH_LEN];
+    eth_keccak256((const uint8_t*)signature, strlen(signature), hash);
+    memcpy(selector, hash, 4);
+    
+    return ESP_OK;
+}
+
+// 函数选择器缓存条目
+typedef struct {
+    bool used;
+    bool pinned;                 // 预注册条目，不参与淘汰
+    uint32_t hash;               // 签名的FNV-1a哈希，用于快速比较
+    uint32_t last_used;          // LRU计数
+    uint8_t selector[4];
+    char signature[ABI_SELECTOR_CACHE_MAX_SIGNATURE];
+} abi_selector_cache_entry_t;
+
+static abi_selector_cache_entry_t s_selector_cache[ABI_SELECTOR_CACHE_SIZE];
+static abi_selector_cache_stats_t s_selector_stats;
+static uint32_t s_selector_clock;
+static portMUX_TYPE s_selector_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t signature_hash(const char* signature, size_t* len) {
+    uint32_t hash = 2166136261u;
+    size_t i = 0;
+    for (; signature[i]; i++) {
+        hash ^= (uint8_t)signature[i];
+        hash *= 16777619u;
+    }
+    *len = i;
+    return hash;
+}
+
+// 在缓存中查找签名，调用者需持有锁
+static abi_selector_cache_entry_t* selector_cache_find(const char* signature, uint32_t hash) {
+    for (size_t i = 0; i < ABI_SELECTOR_CACHE_SIZE; i++) {
+        abi_selector_cache_entry_t* entry = &s_selector_cache[i];
+        if (entry->used && entry->hash == hash && strcmp(entry->signature, signature) == 0) {
+            return entry;
+        }
     }
+    return NULL;
 }
 
-// 将普通字符串转换为十六进制字符串
-static char* string_to_hex(const char* input) {
-    if (!input) return NULL;
+// 写入缓存，调用者需持有锁。没有空位时淘汰最久未使用的非预注册条目
+static abi_selector_cache_entry_t* selector_cache_insert(const char* signature, size_t len, uint32_t hash,
+                                                         const uint8_t selector[4], bool pinned) {
+    abi_selector_cache_entry_t* victim = NULL;
+    for (size_t i = 0; i < ABI_SELECTOR_CACHE_SIZE; i++) {
+        abi_selector_cache_entry_t* entry = &s_selector_cache[i];
+        if (!entry->used) {
+            victim = entry;
+            break;
+        }
+        if (!entry->pinned && (!victim || entry->last_used < victim->last_used)) {
+            victim = entry;
+        }
+    }
+    
+    if (!victim) {
+        return NULL;
+    }
     
-    size_t len = strlen(input);
-    char* hex = malloc(len * 2 + 3); // "0x" + (每个字符2位十六进制) + null终止符
+    if (victim->used) {
+        s_selector_stats.evictions++;
+    } else {
+        s_selector_stats.entries++;
+    }
     
-    if (!hex) return NULL;
+    victim->used = true;
+    victim->pinned = pinned;
+    victim->hash = hash;
+    victim->last_used = ++s_selector_clock;
+    memcpy(victim->selector, selector, 4);
+    memcpy(victim->signature, signature, len + 1);
+    return victim;
+}
+
+esp_err_t abi_get_function_selector(const char* signature, uint8_t selector[4]) {
+    if (!signature || !selector) {
+        return ESP_ERR_INVALID_ARG;
+    }
     
-    strcpy(hex, "0x");
+    size_t len = 0;
+    uint32_t hash = signature_hash(signature, &len);
+    bool cacheable = len < ABI_SELECTOR_CACHE_MAX_SIGNATURE;
     
-    for (size_t i = 0; i < len; i++) {
-        sprintf(hex + 2 + i*2, "%02x", (unsigned char)input[i]);
+    if (cacheable) {
+        taskENTER_CRITICAL(&s_selector_lock);
+        abi_selector_cache_entry_t* entry = selector_cache_find(signature, hash);
+        if (entry) {
+            entry->last_used = ++s_selector_clock;
+            memcpy(selector, entry->selector, 4);
+            s_selector_stats.hits++;
+            taskEXIT_CRITICAL(&s_selector_lock);
+            return ESP_OK;
+        }
+        s_selector_stats.misses++;
+        taskEXIT_CRITICAL(&s_selector_lock);
+    } else {
+        taskENTER_CRITICAL(&s_selector_lock);
+        s_selector_stats.misses++;
+        taskEXIT_CRITICAL(&s_selector_lock);
     }
     
-    return hex;
+    // 哈希计算放在临界区之外
+    esp_err_t err = abi_encode_function_selector(NULL, signature, selector);
+    if (err != ESP_OK || !cacheable) {
+        return err;
+    }
+    
+    taskENTER_CRITICAL(&s_selector_lock);
+    if (!selector_cache_find(signature, hash)) {
+        selector_cache_insert(signature, len, hash, selector, false);
+    }
+    taskEXIT_CRITICAL(&s_selector_lock);
+    
+    return ESP_OK;
 }
 
-// 使用以太坊节点的web3_sha3方法计算Keccak256哈希值
-esp_err_t abi_encode_function_selector(web3_context_t* context, const char* signature, uint8_t selector[4]) {
-    if (!context || !signature || !selector) {
+esp_err_t abi_selector_cache_register(const char* signature) {
+    if (!signature) {
         return ESP_ERR_INVALID_ARG;
     }
     
-    // 将函数签名转换为十六进制字符串
-    char* hex_signature = string_to_hex(signature);
-    if (!hex_signature) {
-        ESP_LOGE(TAG, "Failed to convert signature to hex");
-        return ESP_ERR_NO_MEM;
+    size_t len = 0;
+    uint32_t hash = signature_hash(signature, &len);
+    if (len >= ABI_SELECTOR_CACHE_MAX_SIGNATURE) {
+        ESP_LOGE(TAG, "Signature too long for selector cache: %s", signature);
+        return ESP_ERR_INVALID_SIZE;
     }
     
-    // 使用web3_sha3 RPC方法计算哈希
-    char hash_str[70] = {0}; // 足够存储"0x"前缀+64个十六进制字符+null终止符
-    esp_err_t err = eth_get_web3_sha3(context, hex_signature, hash_str, sizeof(hash_str));
-    free(hex_signature);
-    
+    uint8_t selector[4];
+    esp_err_t err = abi_encode_function_selector(NULL, signature, selector);
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to calculate function selector hash: %s", esp_err_to_name(err));
         return err;
     }
     
-    // 将十六进制字符串转换为二进制数据 (跳过"0x"前缀)
-    for (int i = 0; i < 4; i++) {
-        uint8_t byte = 0;
-        sscanf(&hash_str[2 + i*2], "%2hhx", &byte);
-        selector[i] = byte;
+    taskENTER_CRITICAL(&s_selector_lock);
+    abi_selector_cache_entry_t* entry = selector_cache_find(signature, hash);
+    if (entry) {
+        entry->pinned = true;
+    } else {
+        entry = selector_cache_insert(signature, len, hash, selector, true);
     }
+    taskEXIT_CRITICAL(&s_selector_lock);
     
+    if (!entry) {
+        ESP_LOGE(TAG, "Selector cache full of registered entries, cannot register %s", signature);
+        return ESP_ERR_NO_MEM;
+    }
+    
+    ESP_LOGI(TAG, "Registered selector %02x%02x%02x%02x for %s",
+             selector[0], selector[1], selector[2], selector[3], signature);
     return ESP_OK;
 }
 
-esp_err_t abi_encode_param(const abi_param_t* param, uint8_t* output, size_t output_len, size_t* bytes_written) {
-    if (!param || !output || !bytes_written || output_len < 32) {
-        return ESP_ERR_INVALID_ARG;
+void abi_selector_cache_get_stats(abi_selector_cache_stats_t* stats) {
+    if (!stats) {
+        return;
     }
     
-    *bytes_written = 0;
+    taskENTER_CRITICAL(&s_selector_lock);
+    *stats = s_selector_stats;
+    taskEXIT_CRITICAL(&s_selector_lock);
+}
+
+void abi_selector_cache_clear(void) {
+    taskENTER_CRITICAL(&s_selector_lock);
+    memset(s_selector_cache, 0, sizeof(s_selector_cache));
+    memset(&s_selector_stats, 0, sizeof(s_selector_stats));
+    s_selector_clock = 0;
+    taskEXIT_CRITICAL(&s_selector_lock);
+}
+
+/*
+    编码分两遍：
+    1. abi_measure 递归校验参数并计算编码后的精确长度 (不写数据)
+    2. abi_write_value 按已知长度一次写完，头部的偏移量在写入时即可确定，
+       不需要回填，也不需要预先清零输出缓冲区
+
+    元组和数组的编码规则相同: 先是头部 (静态元素直接编码，动态元素写偏移量)，
+    再依次是动态元素的内容，偏移量相对于该元组/数组头部的起始位置。
+*/
+
+#define ABI_WORD_SIZE 32
+
+static size_t abi_padded_len(size_t len) {
+    return (len + ABI_WORD_SIZE - 1) / ABI_WORD_SIZE * ABI_WORD_SIZE;
+}
+
+// bytesN的N: 优先取size (位数)，兼容只设置length的旧用法
+static size_t abi_fixed_bytes_len(const abi_param_t* param) {
+    return param->size ? param->size / 8 : param->length;
+}
+
+static bool abi_is_dynamic(const abi_param_t* param) {
+    switch (param->type) {
+        case ABI_TYPE_STRING:
+            return true;
+        case ABI_TYPE_BYTES:
+            return param->is_dynamic || param->length > 32;
+        case ABI_TYPE_ARRAY:
+            if (param->size == 0) {
+                return true;  // T[]
+            }
+            /* fall through */
+        case ABI_TYPE_TUPLE: {
+            // T[k]和元组只有在包含动态元素时才是动态类型
+            const abi_param_t* elems = (const abi_param_t*)param->value;
+            for (size_t i = 0; i < param->length; i++) {
+                if (abi_is_dynamic(&elems[i])) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        default:
+            return false;
+    }
+}
+
+static bool abi_size_add(size_t* total, size_t n) {
+    if (*total > SIZE_MAX - n) {
+        return false;
+    }
+    *total += n;
+    return true;
+}
+
+static esp_err_t abi_measure(const abi_param_t* param, unsigned depth, size_t* size);
+
+// 计算元组/数组元素序列的编码长度 (头部 + 动态元素内容)
+static esp_err_t abi_measure_sequence(const abi_param_t* elems, size_t count, unsigned depth, size_t* size) {
+    if (count > 0 && !elems) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (depth >= ABI_MAX_NESTING_DEPTH) {
+        ESP_LOGE(TAG, "ABI type nested deeper than %d levels", ABI_MAX_NESTING_DEPTH);
+        return ESP_ERR_INVALID_ARG;
+    }
     
-    // 清零输出缓冲区
-    memset(output, 0, 32);
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t elem_size = 0;
+        esp_err_t err = abi_measure(&elems[i], depth + 1, &elem_size);
+        if (err != ESP_OK) {
+            return err;
+        }
+        if (abi_is_dynamic(&elems[i]) && !abi_size_add(&total, ABI_WORD_SIZE)) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        if (!abi_size_add(&total, elem_size)) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+    }
     
+    *size = total;
+    return ESP_OK;
+}
+
+// 校验单个参数并计算其编码长度 (动态类型为内容部分的长度，不含头部偏移量)
+static esp_err_t abi_measure(const abi_param_t* param, unsigned depth, size_t* size) {
     switch (param->type) {
         case ABI_TYPE_UINT:
         case ABI_TYPE_INT:
-            {
-                // 整数类型 - 右对齐
-                size_t bytes = param->size / 8;
-                if (bytes > 32) bytes = 32;
-                
-                // 复制数据到输出缓冲区的右侧
-                memcpy(output + (32 - bytes), param->value, bytes);
-                *bytes_written = 32;
+            if (!param->value || param->size == 0 || param->size > 256 || param->size % 8 != 0) {
+                ESP_LOGE(TAG, "Invalid integer size: %d", param->size);
+                return ESP_ERR_INVALID_ARG;
             }
-            break;
+            *size = ABI_WORD_SIZE;
+            return ESP_OK;
             
         case ABI_TYPE_ADDRESS:
-            // 地址类型 - 20字节，右对齐
-            memcpy(output + 12, param->value, 20);
-            *bytes_written = 32;
-            break;
-            
         case ABI_TYPE_BOOL:
-            // 布尔类型 - 1字节，右对齐
-            output[31] = (*(bool*)param->value) ? 1 : 0;
-            *bytes_written = 32;
-            break;
+            if (!param->value) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            *size = ABI_WORD_SIZE;
+            return ESP_OK;
             
         case ABI_TYPE_BYTES:
-            if (param->length <= 32) {
-                // 定长字节数组，左对齐
-                memcpy(output, param->value, param->length);
-                *bytes_written = 32;
-            } else {
-                // 动态字节数组需要特殊处理
-                // 这里只实现长度编码
-                // 实际数据需要在调用abi_encode_params中处理
-                if (output_len < 32) {
-                    return ESP_ERR_INVALID_SIZE;
+            if (!abi_is_dynamic(param)) {
+                size_t n = abi_fixed_bytes_len(param);
+                if (n == 0 || n > 32 || param->length > n || (param->length > 0 && !param->value)) {
+                    ESP_LOGE(TAG, "Invalid bytesN: N=%d, length=%d", (int)n, (int)param->length);
+                    return ESP_ERR_INVALID_ARG;
                 }
-                
-                // 编码长度
-                uint32_t len = param->length;
-                for (int i = 0; i < 32; i++) {
-                    output[31-i] = (len >> (i*8)) & 0xFF;
-                }
-                *bytes_written = 32; // 仅返回长度编码部分的大小
+                *size = ABI_WORD_SIZE;
+                return ESP_OK;
             }
-            break;
-            
+            /* fall through */
         case ABI_TYPE_STRING:
-            // 字符串类型 - 动态类型
-            // 这里只实现长度编码
-            if (output_len < 32) {
+            if (param->length > 0 && !param->value) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            if (param->length > SIZE_MAX - 2 * ABI_WORD_SIZE) {
                 return ESP_ERR_INVALID_SIZE;
             }
+            *size = ABI_WORD_SIZE + abi_padded_len(param->length);
+            return ESP_OK;
             
-            // 编码长度
-            uint32_t len = param->length;
-            for (int i = 0; i < 32; i++) {
-                output[31-i] = (len >> (i*8)) & 0xFF;
+        case ABI_TYPE_ARRAY: {
+            if (param->size != 0 && param->length != param->size) {
+                ESP_LOGE(TAG, "Fixed array length mismatch: T[%d] with %d elements",
+                         param->size, (int)param->length);
+                return ESP_ERR_INVALID_ARG;
             }
-            *bytes_written = 32; // 仅返回长度编码部分的大小
-            break;
+            esp_err_t err = abi_measure_sequence((const abi_param_t*)param->value, param->length, depth, size);
+            if (err == ESP_OK && param->size == 0 && !abi_size_add(size, ABI_WORD_SIZE)) {
+                err = ESP_ERR_INVALID_SIZE;  // T[]的长度字
+            }
+            return err;
+        }
             
-        case ABI_TYPE_ARRAY:
-            // 数组类型 - 简化处理
-            ESP_LOGE(TAG, "Array type not fully implemented");
-            return ESP_ERR_NOT_SUPPORTED;
+        case ABI_TYPE_TUPLE:
+            return abi_measure_sequence((const abi_param_t*)param->value, param->length, depth, size);
             
         default:
-            ESP_LOGE(TAG, "Unknown ABI type");
+            ESP_LOGE(TAG, "Unknown ABI type: %d", param->type);
             return ESP_ERR_INVALID_ARG;
     }
+}
+
+// 静态参数在头部占用的长度 (基本类型32字节，静态元组/定长数组为全部元素)
+static size_t abi_static_size(const abi_param_t* param) {
+    if (param->type != ABI_TYPE_ARRAY && param->type != ABI_TYPE_TUPLE) {
+        return ABI_WORD_SIZE;
+    }
+    const abi_param_t* elems = (const abi_param_t*)param->value;
+    size_t total = 0;
+    for (size_t i = 0; i < param->length; i++) {
+        total += abi_static_size(&elems[i]);
+    }
+    return total;
+}
+
+// 写入一个32字节大端序无符号整数 (长度、偏移量)
+static void abi_write_word(uint8_t* out, uint64_t value) {
+    memset(out, 0, ABI_WORD_SIZE - 8);
+    for (int i = 0; i < 8; i++) {
+        out[ABI_WORD_SIZE - 1 - i] = (uint8_t)(value >> (i * 8));
+    }
+}
+
+static size_t abi_write_value(const abi_param_t* param, uint8_t* out);
+
+// 写入元组/数组元素序列，返回写入的字节数
+static size_t abi_write_sequence(const abi_param_t* elems, size_t count, uint8_t* out) {
+    size_t head_size = 0;
+    for (size_t i = 0; i < count; i++) {
+        head_size += abi_is_dynamic(&elems[i]) ? ABI_WORD_SIZE : abi_static_size(&elems[i]);
+    }
+    
+    size_t head = 0;
+    size_t tail = head_size;
+    for (size_t i = 0; i < count; i++) {
+        if (abi_is_dynamic(&elems[i])) {
+            abi_write_word(out + head, tail);
+            head += ABI_WORD_SIZE;
+            tail += abi_write_value(&elems[i], out + tail);
+        } else {
+            head += abi_write_value(&elems[i], out + head);
+        }
+    }
+    return tail;
+}
+
+// 写入单个参数，返回写入的字节数。调用前已由abi_measure校验参数并确认缓冲区足够
+static size_t abi_write_value(const abi_param_t* param, uint8_t* out) {
+    switch (param->type) {
+        case ABI_TYPE_UINT:
+        case ABI_TYPE_INT: {
+            // 大端序整数右对齐，intN为负数时高位补0xFF做符号扩展
+            size_t bytes = param->size / 8;
+            const uint8_t* value = (const uint8_t*)param->value;
+            uint8_t fill = (param->type == ABI_TYPE_INT && (value[0] & 0x80)) ? 0xFF : 0x00;
+            memset(out, fill, ABI_WORD_SIZE - bytes);
+            memcpy(out + (ABI_WORD_SIZE - bytes), value, bytes);
+            return ABI_WORD_SIZE;
+        }
+            
+        case ABI_TYPE_ADDRESS:
+            // 地址类型 - 20字节，右对齐
+            memset(out, 0, 12);
+            memcpy(out + 12, param->value, 20);
+            return ABI_WORD_SIZE;
+            
+        case ABI_TYPE_BOOL:
+            memset(out, 0, ABI_WORD_SIZE - 1);
+            out[ABI_WORD_SIZE - 1] = (*(const bool*)param->value) ? 1 : 0;
+            return ABI_WORD_SIZE;
+            
+        case ABI_TYPE_BYTES:
+            if (!abi_is_dynamic(param)) {
+                // bytesN - 左对齐，右侧补0
+                if (param->length > 0) {
+                    memcpy(out, param->value, param->length);
+                }
+                memset(out + param->length, 0, ABI_WORD_SIZE - param->length);
+                return ABI_WORD_SIZE;
+            }
+            /* fall through */
+        case ABI_TYPE_STRING: {
+            // 长度 + 数据 (右侧补0到32字节边界)
+            size_t padded = abi_padded_len(param->length);
+            abi_write_word(out, param->length);
+            if (param->length > 0) {
+                memcpy(out + ABI_WORD_SIZE, param->value, param->length);
+            }
+            memset(out + ABI_WORD_SIZE + param->length, 0, padded - param->length);
+            return ABI_WORD_SIZE + padded;
+        }
+            
+        case ABI_TYPE_ARRAY:
+            if (param->size == 0) {
+                // T[] - 元素个数 + 按元组编码的元素
+                abi_write_word(out, param->length);
+                return ABI_WORD_SIZE + abi_write_sequence((const abi_param_t*)param->value, param->length,
+                                                          out + ABI_WORD_SIZE);
+            }
+            return abi_write_sequence((const abi_param_t*)param->value, param->length, out);
+            
+        case ABI_TYPE_TUPLE:
+            return abi_write_sequence((const abi_param_t*)param->value, param->length, out);
+            
+        default:
+            return 0;
+    }
+}
+
+esp_err_t abi_encoded_size(const abi_param_t* params, size_t param_count, size_t* size) {
+    if ((!params && param_count > 0) || !size) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    return abi_measure_sequence(params, param_count, 0, size);
+}
+
+esp_err_t abi_encode_param(const abi_param_t* param, uint8_t* output, size_t output_len, size_t* bytes_written) {
+    if (!param || !output || !bytes_written) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    *bytes_written = 0;
     
+    size_t size = 0;
+    esp_err_t err = abi_measure(param, 0, &size);
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (size > output_len) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    
+    *bytes_written = abi_write_value(param, output);
     return ESP_OK;
 }
 
@@ -160,13 +486,6 @@ esp_err_t abi_encode_params(const abi_param_t* params, size_t param_count, uint8
     
     *bytes_written = 0;
     
-    // 计算头部长度 (每个参数32字节)
-    size_t head_size = param_count * 32;
-    
-    // 检查缓冲区大小
-    if (output_len < head_size) {
-        return ESP_ERR_INVALID_SIZE;
-    }
     /*
     
     [头部区域]
@@ -179,104 +498,41 @@ esp_err_t abi_encode_params(const abi_param_t* params, size_t param_count, uint8
     128-159字节: 参数b的数据("hello"加填充)   - 再存实际数据(右侧填充0至32字节)
     
     */
-    // 先处理静态参数
-    size_t dynamic_data_offset = head_size;
-    size_t current_offset = 0;
-    
-    // 第一遍: 计算动态数据偏移量
-    for (size_t i = 0; i < param_count; i++) {
-        const abi_param_t* param = &params[i];
-        
-        if (param->is_dynamic || 
-            (param->type == ABI_TYPE_STRING) || 
-            (param->type == ABI_TYPE_BYTES && param->length > 32)) {
-            // 动态参数: 在头部保存偏移量
-            dynamic_data_offset += (param->type == ABI_TYPE_STRING || param->type == ABI_TYPE_BYTES) ? 
-                                   32 + ((param->length + 31) / 32) * 32 : 32;
-        }
+    size_t size = 0;
+    esp_err_t err = abi_measure_sequence(params, param_count, 0, &size);
+    if (err != ESP_OK) {
+        return err;
     }
-    
-    // 第二遍: 编码参数
-    size_t current_dynamic_offset = head_size;
-    
-    for (size_t i = 0; i < param_count; i++) {
-        const abi_param_t* param = &params[i];
-        
-        if (!param->is_dynamic && 
-            !(param->type == ABI_TYPE_STRING) && 
-            !(param->type == ABI_TYPE_BYTES && param->length > 32)) {
-            // 静态参数: 直接编码
-            size_t param_size = 0;
-            esp_err_t err = abi_encode_param(param, output + current_offset, output_len - current_offset, &param_size);
-            if (err != ESP_OK) {
-                return err;
-            }
-            current_offset += param_size;
-        } else {
-            // 动态参数: 在头部保存偏移量
-            // 编码偏移量 (相对于开始位置)
-            for (int j = 0; j < 32; j++) {
-                output[current_offset + 31-j] = (current_dynamic_offset >> (j*8)) & 0xFF;
-            }
-            current_offset += 32;
-            
-            // 处理动态数据
-            if (current_dynamic_offset + 32 > output_len) {
-                return ESP_ERR_INVALID_SIZE;
-            }
-            
-            if (param->type == ABI_TYPE_STRING || param->type == ABI_TYPE_BYTES) {
-                // 编码长度
-                for (int j = 0; j < 32; j++) {
-                    output[current_dynamic_offset + 31-j] = (param->length >> (j*8)) & 0xFF;
-                }
-                current_dynamic_offset += 32;
-                
-                // 编码数据
-                if (current_dynamic_offset + param->length > output_len) {
-                    return ESP_ERR_INVALID_SIZE;
-                }
-                
-                memcpy(output + current_dynamic_offset, param->value, param->length);
-                size_t padded_len = ((param->length + 31) / 32) * 32;
-                
-                // 填充到32字节边界
-                pad_to_32_bytes(output + current_dynamic_offset, param->length);
-                current_dynamic_offset += padded_len;
-            }
-        }
+    if (size > output_len) {
+        ESP_LOGE(TAG, "Output buffer too small: need %d, have %d", (int)size, (int)output_len);
+        return ESP_ERR_INVALID_SIZE;
     }
     
-    *bytes_written = current_dynamic_offset > head_size ? current_dynamic_offset : current_offset;
+    *bytes_written = abi_write_sequence(params, param_count, output);
     return ESP_OK;
 }
 
-esp_err_t abi_encode_function_call(web3_context_t* context, const char* signature, 
-                                const abi_param_t* params, size_t param_count, 
-                                uint8_t* output, size_t output_len, size_t* bytes_written) {
-    if (!context || !signature || !output || !bytes_written) {
+esp_err_t abi_encode_call_with_selector(const uint8_t selector[4], const abi_param_t* params, size_t param_count,
+                                       uint8_t* output, size_t output_len, size_t* bytes_written) {
+    if (!selector || !output || !bytes_written) {
         return ESP_ERR_INVALID_ARG;
     }
     
-    // Initialize bytes written to zero
     *bytes_written = 0;
     
-    // 确保输出缓冲区足够大
-    if (output_len < 4) {
-        return ESP_ERR_INVALID_SIZE;
+    // 先计算精确长度，确保输出缓冲区足够大
+    size_t params_size = 0;
+    if (param_count > 0 && params) {
+        esp_err_t err = abi_measure_sequence(params, param_count, 0, &params_size);
+        if (err != ESP_OK) {
+            return err;
+        }
     }
-    
-    // Clear the entire output buffer first
-    memset(output, 0, output_len);
-    
-    // 计算函数选择器 (使用更新后的函数签名)
-    uint8_t selector[4] = {0};
-    esp_err_t err = abi_encode_function_selector(context, signature, selector);
-    if (err != ESP_OK) {
-        return err;
+    if (output_len < 4 || params_size > output_len - 4) {
+        ESP_LOGE(TAG, "Output buffer too small: need %d, have %d", (int)(4 + params_size), (int)output_len);
+        return ESP_ERR_INVALID_SIZE;
     }
     
-    // 复制选择器到输出
     memcpy(output, selector, 4);
     
     // 如果没有参数，直接返回
@@ -285,32 +541,36 @@ esp_err_t abi_encode_function_call(web3_context_t* context, const char* signatur
         return ESP_OK;
     }
     
-    // 编码参数
-    size_t params_size = 0;
-    err = abi_encode_params(params, param_count, output + 4, output_len - 4, &params_size);
+    *bytes_written = 4 + abi_write_sequence(params, param_count, output + 4);
+    return ESP_OK;
+}
+
+esp_err_t abi_encode_function_call(web3_context_t* context, const char* signature, 
+                                const abi_param_t* params, size_t param_count, 
+                                uint8_t* output, size_t output_len, size_t* bytes_written) {
+    (void)context;
+    
+    if (!signature || !output || !bytes_written) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    // 获取函数选择器 (优先使用缓存)
+    uint8_t selector[4];
+    esp_err_t err = abi_get_function_selector(signature, selector);
     if (err != ESP_OK) {
+        *bytes_written = 0;
         return err;
     }
     
-    *bytes_written = 4 + params_size;
-    return ESP_OK;
+    return abi_encode_call_with_selector(selector, params, param_count, output, output_len, bytes_written);
 }
 
 esp_err_t abi_binary_to_hex(const uint8_t* binary, size_t binary_len, char* hex, size_t hex_len) {
-    if (!binary || !hex || hex_len < (binary_len * 2 + 3)) {
+    if (!binary || !hex || hex_len < ETH_HEX_ENCODED_LEN(binary_len)) {
         return ESP_ERR_INVALID_ARG;
     }
     
-    // 添加0x前缀
-    hex[0] = '0';
-    hex[1] = 'x';
-    
-    // 转换二进制为十六进制
-    for (size_t i = 0; i < binary_len; i++) {
-        sprintf(hex + 2 + i*2, "%02x", binary[i]);
-    }
-    
-    return ESP_OK;
+    return eth_hex_encode(binary, binary_len, hex, hex_len, true);
 }
 
 // 将十六进制字符串转换为二进制数据
@@ -319,58 +579,571 @@ esp_err_t abi_hex_to_binary(const char* hex, uint8_t* binary, size_t binary_len,
         return ESP_ERR_INVALID_ARG;
     }
     
-    *bytes_written = 0;
+    esp_err_t err = eth_hex_decode(hex, strlen(hex), binary, binary_len, bytes_written);
+    if (err == ESP_ERR_INVALID_SIZE) {
+        ESP_LOGE(TAG, "Binary buffer too small: need %d, have %d", (int)(strlen(hex) / 2), (int)binary_len);
+    } else if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Invalid hex string: %.16s...", hex);
+    }
+    return err;
+}
+
+/*
+    类型化解码
+
+    按类型签名 (如 "(uint256,address,string,bytes32[])") 解析ABI编码数据，
+    结果是指向调用者缓冲区的视图，不复制数据也不分配内存。
+    abi_decode 会先校验整棵类型树的偏移量和长度，之后的访问不会越界。
+*/
+
+// 解析后的类型描述
+typedef struct {
+    abi_type_t type;
+    uint16_t size;       // intN/uintN的位数，bytesN的N*8 (动态bytes为0)，定长数组的k (动态数组为0)
+    const char* inner;   // 数组的元素类型，或元组的成员列表 (不含括号)
+    size_t inner_len;
+    size_t count;        // 元组成员数
+} abi_type_info_t;
+
+// 取出元组成员列表中的下一个成员，*pos前进到下一个成员的开头
+static bool abi_next_component(const char* list, size_t list_len, size_t* pos,
+                               const char** comp, size_t* comp_len) {
+    if (*pos >= list_len) {
+        return false;
+    }
     
-    // 跳过0x前缀
-    if (strncmp(hex, "0x", 2) == 0) {
-        hex += 2;
+    size_t start = *pos;
+    int depth = 0;
+    size_t i = start;
+    for (; i < list_len; i++) {
+        char c = list[i];
+        if (c == '(' || c == '[') {
+            depth++;
+        } else if (c == ')' || c == ']') {
+            depth--;
+        } else if (c == ',' && depth == 0) {
+            break;
+        }
     }
     
-    size_t hex_len = strlen(hex);
-    if (hex_len % 2 != 0) {
-        ESP_LOGE(TAG, "Invalid hex string length (must be even)");
+    *comp = list + start;
+    *comp_len = i - start;
+    *pos = i + 1;
+    return true;
+}
+
+// 解析十进制数字，len为0或超过max时返回false
+static bool abi_parse_uint(const char* s, size_t len, unsigned max, unsigned* out) {
+    if (len == 0 || len > 5) {
+        return false;
+    }
+    unsigned v = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (s[i] < '0' || s[i] > '9') {
+            return false;
+        }
+        v = v * 10 + (unsigned)(s[i] - '0');
+    }
+    if (v > max) {
+        return false;
+    }
+    *out = v;
+    return true;
+}
+
+static bool abi_type_is(const char* t, size_t len, const char* name) {
+    size_t n = strlen(name);
+    return len == n && memcmp(t, name, n) == 0;
+}
+
+static esp_err_t abi_parse_type(const char* t, size_t len, abi_type_info_t* info) {
+    memset(info, 0, sizeof(*info));
+    if (len == 0) {
         return ESP_ERR_INVALID_ARG;
     }
     
-    size_t expected_binary_len = hex_len / 2;
-    if (binary_len < expected_binary_len) {
-        ESP_LOGE(TAG, "Binary buffer too small: need %d, have %d", expected_binary_len, binary_len);
-        return ESP_ERR_INVALID_SIZE;
+    // T[] / T[k]，最后一个后缀决定数组类型
+    if (t[len - 1] == ']') {
+        size_t lb = len - 1;
+        while (lb > 0 && t[lb] != '[') {
+            lb--;
+        }
+        if (t[lb] != '[' || lb == 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        unsigned k = 0;
+        size_t digits = len - 2 - lb;
+        if (digits > 0 && (!abi_parse_uint(t + lb + 1, digits, UINT16_MAX, &k) || k == 0)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        info->type = ABI_TYPE_ARRAY;
+        info->size = (uint16_t)k;
+        info->inner = t;
+        info->inner_len = lb;
+        return ESP_OK;
+    }
+    
+    // (T1,T2,...)
+    if (t[0] == '(') {
+        if (len < 3 || t[len - 1] != ')' || t[len - 2] == ',') {
+            return ESP_ERR_INVALID_ARG;  // 不接受空元组和空成员
+        }
+        info->type = ABI_TYPE_TUPLE;
+        info->inner = t + 1;
+        info->inner_len = len - 2;
+        size_t pos = 0;
+        const char* comp;
+        size_t comp_len;
+        while (abi_next_component(info->inner, info->inner_len, &pos, &comp, &comp_len)) {
+            if (comp_len == 0) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            info->count++;
+        }
+        return ESP_OK;
     }
     
-    for (size_t i = 0; i < expected_binary_len; i++) {
-        char byte_str[3] = {hex[i*2], hex[i*2+1], 0};
-        unsigned int byte_val;
-        if (sscanf(byte_str, "%02x", &byte_val) != 1) {
-            ESP_LOGE(TAG, "Invalid hex characters at position %d: %s", i*2, byte_str);
+    unsigned bits = 256;
+    if (abi_type_is(t, len, "address")) {
+        info->type = ABI_TYPE_ADDRESS;
+        info->size = 160;
+    } else if (abi_type_is(t, len, "bool")) {
+        info->type = ABI_TYPE_BOOL;
+        info->size = 8;
+    } else if (abi_type_is(t, len, "string")) {
+        info->type = ABI_TYPE_STRING;
+    } else if (abi_type_is(t, len, "bytes")) {
+        info->type = ABI_TYPE_BYTES;
+    } else if (len > 5 && memcmp(t, "bytes", 5) == 0) {
+        if (!abi_parse_uint(t + 5, len - 5, 32, &bits) || bits == 0) {
             return ESP_ERR_INVALID_ARG;
         }
-        binary[i] = (uint8_t)byte_val;
+        info->type = ABI_TYPE_BYTES;
+        info->size = (uint16_t)(bits * 8);
+    } else if (len >= 4 && memcmp(t, "uint", 4) == 0) {
+        if (len > 4 && (!abi_parse_uint(t + 4, len - 4, 256, &bits) || bits == 0 || bits % 8 != 0)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        info->type = ABI_TYPE_UINT;
+        info->size = (uint16_t)bits;
+    } else if (len >= 3 && memcmp(t, "int", 3) == 0) {
+        if (len > 3 && (!abi_parse_uint(t + 3, len - 3, 256, &bits) || bits == 0 || bits % 8 != 0)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        info->type = ABI_TYPE_INT;
+        info->size = (uint16_t)bits;
+    } else {
+        ESP_LOGE(TAG, "Unsupported ABI type: %.*s", (int)len, t);
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+// 计算类型在头部占用的长度: 动态类型为32字节的偏移量，静态类型为完整编码长度
+static esp_err_t abi_type_head(const char* t, size_t len, unsigned depth, size_t* head, bool* dynamic) {
+    if (depth >= ABI_MAX_NESTING_DEPTH) {
+        ESP_LOGE(TAG, "ABI type nested deeper than %d levels", ABI_MAX_NESTING_DEPTH);
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    abi_type_info_t info;
+    esp_err_t err = abi_parse_type(t, len, &info);
+    if (err != ESP_OK) {
+        return err;
     }
     
-    *bytes_written = expected_binary_len;
+    *head = ABI_WORD_SIZE;
+    *dynamic = false;
+    switch (info.type) {
+        case ABI_TYPE_STRING:
+            *dynamic = true;
+            return ESP_OK;
+        case ABI_TYPE_BYTES:
+            *dynamic = info.size == 0;
+            return ESP_OK;
+        case ABI_TYPE_ARRAY: {
+            size_t elem_head;
+            bool elem_dynamic;
+            err = abi_type_head(info.inner, info.inner_len, depth + 1, &elem_head, &elem_dynamic);
+            if (err != ESP_OK) {
+                return err;
+            }
+            if (info.size == 0 || elem_dynamic) {
+                *dynamic = true;
+            } else {
+                *head = elem_head * info.size;
+            }
+            return ESP_OK;
+        }
+        case ABI_TYPE_TUPLE: {
+            size_t total = 0;
+            size_t pos = 0;
+            const char* comp;
+            size_t comp_len;
+            while (abi_next_component(info.inner, info.inner_len, &pos, &comp, &comp_len)) {
+                size_t comp_head;
+                bool comp_dynamic;
+                err = abi_type_head(comp, comp_len, depth + 1, &comp_head, &comp_dynamic);
+                if (err != ESP_OK) {
+                    return err;
+                }
+                total += comp_head;
+                *dynamic |= comp_dynamic;
+            }
+            if (!*dynamic) {
+                *head = total;
+            }
+            return ESP_OK;
+        }
+        default:
+            return ESP_OK;
+    }
+}
+
+// 元组/数组所有元素的头部总长度
+static esp_err_t abi_container_head(const abi_type_info_t* info, size_t* total) {
+    size_t head;
+    bool dynamic;
+    if (info->type == ABI_TYPE_ARRAY) {
+        esp_err_t err = abi_type_head(info->inner, info->inner_len, 0, &head, &dynamic);
+        if (err != ESP_OK) {
+            return err;
+        }
+        *total = dynamic ? ABI_WORD_SIZE : head;  // 单个元素的头部长度，由调用者乘以元素个数
+        return ESP_OK;
+    }
+    
+    size_t sum = 0;
+    size_t pos = 0;
+    const char* comp;
+    size_t comp_len;
+    while (abi_next_component(info->inner, info->inner_len, &pos, &comp, &comp_len)) {
+        esp_err_t err = abi_type_head(comp, comp_len, 0, &head, &dynamic);
+        if (err != ESP_OK) {
+            return err;
+        }
+        sum += dynamic ? ABI_WORD_SIZE : head;
+    }
+    *total = sum;
     return ESP_OK;
 }
 
-// 从ABI编码数据中提取32字节的整数值
-static uint64_t abi_extract_uint64(const uint8_t* data, size_t offset, size_t data_len) {
-    // 添加边界检查
-    if (!data || offset + 32 > data_len) {
-        ESP_LOGE(TAG, "Invalid data pointer or offset out of bounds: offset=%d, data_len=%d", 
-                 offset, data_len);
-        return 0;
+// 读取32字节大端序的长度/偏移量，高位非零时返回false
+static bool abi_read_word_size(const uint8_t* word, size_t* out) {
+    for (int i = 0; i < ABI_WORD_SIZE - 8; i++) {
+        if (word[i] != 0) {
+            return false;
+        }
+    }
+    uint64_t v = 0;
+    for (int i = ABI_WORD_SIZE - 8; i < ABI_WORD_SIZE; i++) {
+        v = (v << 8) | word[i];
+    }
+    if (v > SIZE_MAX) {
+        return false;
+    }
+    *out = (size_t)v;
+    return true;
+}
+
+static bool abi_all_bytes(const uint8_t* p, size_t n, uint8_t v) {
+    for (size_t i = 0; i < n; i++) {
+        if (p[i] != v) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 从编码区域region开始解析一个值，region到end之间为可用数据
+static esp_err_t abi_decode_region(const char* t, size_t len, const uint8_t* region, const uint8_t* end,
+                                   abi_value_t* out) {
+    abi_type_info_t info;
+    esp_err_t err = abi_parse_type(t, len, &info);
+    if (err != ESP_OK) {
+        return err;
     }
     
-    uint64_t value = 0;
+    size_t avail = (size_t)(end - region);
+    out->type = info.type;
+    out->size = info.size;
+    out->type_str = t;
+    out->type_len = len;
+    out->end = end;
     
-    // 提取最后8字节 (小端序)
-    for (int i = 0; i < 8; i++) {
-        if (offset + 32 - 8 + i < data_len) { // 安全检查
-            value = (value << 8) | data[offset + 32 - 8 + i];
+    bool is_word = info.type == ABI_TYPE_UINT || info.type == ABI_TYPE_INT || info.type == ABI_TYPE_ADDRESS ||
+                   info.type == ABI_TYPE_BOOL || (info.type == ABI_TYPE_BYTES && info.size != 0);
+    if (is_word && avail < ABI_WORD_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    
+    switch (info.type) {
+        case ABI_TYPE_UINT:
+        case ABI_TYPE_INT: {
+            // 窄于256位的整数，高位必须是0 (uintN) 或符号扩展 (intN)
+            size_t pad = ABI_WORD_SIZE - info.size / 8;
+            uint8_t fill = (info.type == ABI_TYPE_INT && (region[pad] & 0x80)) ? 0xFF : 0x00;
+            if (!abi_all_bytes(region, pad, fill)) {
+                return ESP_ERR_INVALID_RESPONSE;
+            }
+            out->data = region;
+            out->length = ABI_WORD_SIZE;
+            return ESP_OK;
+        }
+            
+        case ABI_TYPE_ADDRESS:
+            if (!abi_all_bytes(region, 12, 0)) {
+                return ESP_ERR_INVALID_RESPONSE;
+            }
+            out->data = region + 12;
+            out->length = 20;
+            return ESP_OK;
+            
+        case ABI_TYPE_BOOL:
+            if (!abi_all_bytes(region, ABI_WORD_SIZE - 1, 0) || region[ABI_WORD_SIZE - 1] > 1) {
+                return ESP_ERR_INVALID_RESPONSE;
+            }
+            out->data = region + ABI_WORD_SIZE - 1;
+            out->length = 1;
+            return ESP_OK;
+            
+        case ABI_TYPE_BYTES:
+            if (info.size != 0) {
+                size_t n = info.size / 8;
+                if (!abi_all_bytes(region + n, ABI_WORD_SIZE - n, 0)) {
+                    return ESP_ERR_INVALID_RESPONSE;
+                }
+                out->data = region;
+                out->length = n;
+                return ESP_OK;
+            }
+            /* fall through */
+        case ABI_TYPE_STRING: {
+            size_t n;
+            if (avail < ABI_WORD_SIZE) {
+                return ESP_ERR_INVALID_SIZE;
+            }
+            if (!abi_read_word_size(region, &n) || n > avail - ABI_WORD_SIZE) {
+                ESP_LOGE(TAG, "Dynamic data out of bounds: length field exceeds %d bytes", (int)(avail - ABI_WORD_SIZE));
+                return ESP_ERR_INVALID_SIZE;
+            }
+            out->data = region + ABI_WORD_SIZE;
+            out->length = n;
+            return ESP_OK;
+        }
+            
+        case ABI_TYPE_ARRAY: {
+            size_t elem_head;
+            err = abi_container_head(&info, &elem_head);
+            if (err != ESP_OK) {
+                return err;
+            }
+            size_t count = info.size;
+            if (info.size == 0) {
+                // T[]: 元素个数 + 元素编码
+                if (avail < ABI_WORD_SIZE || !abi_read_word_size(region, &count)) {
+                    return ESP_ERR_INVALID_SIZE;
+                }
+                region += ABI_WORD_SIZE;
+                avail -= ABI_WORD_SIZE;
+            }
+            if (count > avail / elem_head) {
+                ESP_LOGE(TAG, "Array of %d elements exceeds data", (int)count);
+                return ESP_ERR_INVALID_SIZE;
+            }
+            out->data = region;
+            out->length = count;
+            return ESP_OK;
         }
+            
+        case ABI_TYPE_TUPLE: {
+            size_t head;
+            err = abi_container_head(&info, &head);
+            if (err != ESP_OK) {
+                return err;
+            }
+            if (head > avail) {
+                return ESP_ERR_INVALID_SIZE;
+            }
+            out->data = region;
+            out->length = info.count;
+            return ESP_OK;
+        }
+            
+        default:
+            return ESP_ERR_INVALID_ARG;
+    }
+}
+
+esp_err_t abi_value_at(const abi_value_t* container, size_t index, abi_value_t* out) {
+    if (!container || !out ||
+        (container->type != ABI_TYPE_ARRAY && container->type != ABI_TYPE_TUPLE)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (index >= container->length) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    
+    abi_type_info_t info;
+    esp_err_t err = abi_parse_type(container->type_str, container->type_len, &info);
+    if (err != ESP_OK) {
+        return err;
+    }
+    
+    // 找到元素的类型和头部位置
+    const char* elem = info.inner;
+    size_t elem_len = info.inner_len;
+    size_t head_pos = 0;
+    size_t head;
+    bool dynamic;
+    if (info.type == ABI_TYPE_ARRAY) {
+        err = abi_type_head(elem, elem_len, 0, &head, &dynamic);
+        if (err != ESP_OK) {
+            return err;
+        }
+        head_pos = index * (dynamic ? ABI_WORD_SIZE : head);
+    } else {
+        size_t pos = 0;
+        for (size_t i = 0; abi_next_component(info.inner, info.inner_len, &pos, &elem, &elem_len); i++) {
+            err = abi_type_head(elem, elem_len, 0, &head, &dynamic);
+            if (err != ESP_OK) {
+                return err;
+            }
+            if (i == index) {
+                break;
+            }
+            head_pos += dynamic ? ABI_WORD_SIZE : head;
+        }
+    }
+    
+    const uint8_t* base = container->data;
+    size_t avail = (size_t)(container->end - base);
+    if (!dynamic) {
+        if (head_pos > avail || head > avail - head_pos) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        return abi_decode_region(elem, elem_len, base + head_pos, container->end, out);
+    }
+    
+    // 动态元素: 头部是相对于容器起点的偏移量
+    size_t offset;
+    if (head_pos > avail || avail - head_pos < ABI_WORD_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (!abi_read_word_size(base + head_pos, &offset) || offset > avail) {
+        ESP_LOGE(TAG, "Offset out of bounds at element %d", (int)index);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    return abi_decode_region(elem, elem_len, base + offset, container->end, out);
+}
+
+// 递归检查所有元素的偏移量和长度
+static esp_err_t abi_validate(const abi_value_t* value, unsigned depth) {
+    if (value->type != ABI_TYPE_ARRAY && value->type != ABI_TYPE_TUPLE) {
+        return ESP_OK;
+    }
+    if (depth >= ABI_MAX_NESTING_DEPTH) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (size_t i = 0; i < value->length; i++) {
+        abi_value_t elem;
+        esp_err_t err = abi_value_at(value, i, &elem);
+        if (err == ESP_OK) {
+            err = abi_validate(&elem, depth + 1);
+        }
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t abi_decode(const char* types, const uint8_t* data, size_t data_len, abi_value_t* out) {
+    if (!types || (!data && data_len > 0) || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    size_t len = strlen(types);
+    if (len < 2 || types[0] != '(' || types[len - 1] != ')') {
+        ESP_LOGE(TAG, "Decode types must be a tuple: %s", types);
+        return ESP_ERR_INVALID_ARG;
     }
     
-    return value;
+    // 检查整个类型签名 (语法和嵌套深度)
+    size_t head;
+    bool dynamic;
+    esp_err_t err = abi_type_head(types, len, 0, &head, &dynamic);
+    if (err != ESP_OK) {
+        return err;
+    }
+    
+    // 返回值整体按元组编码，顶层没有偏移量
+    err = abi_decode_region(types, len, data, data + data_len, out);
+    if (err == ESP_OK) {
+        err = abi_validate(out, 0);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to decode %s from %d bytes: %s", types, (int)data_len, esp_err_to_name(err));
+    }
+    return err;
+}
+
+esp_err_t abi_value_to_uint256(const abi_value_t* value, uint256_t* out) {
+    if (!value || !out || value->type != ABI_TYPE_UINT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return uint256_from_be_bytes(value->data, ABI_WORD_SIZE, out);
+}
+
+esp_err_t abi_value_to_int256(const abi_value_t* value, uint256_t* magnitude, bool* negative) {
+    if (!value || !magnitude || !negative ||
+        (value->type != ABI_TYPE_INT && value->type != ABI_TYPE_UINT)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    uint256_t v;
+    uint256_from_be_bytes(value->data, ABI_WORD_SIZE, &v);
+    *negative = value->type == ABI_TYPE_INT && (value->data[0] & 0x80);
+    if (*negative) {
+        // 补码取绝对值: 2^256 - v
+        uint256_t zero = UINT256_ZERO;
+        uint256_sub(&zero, &v, &v);
+    }
+    *magnitude = v;
+    return ESP_OK;
+}
+
+esp_err_t abi_value_to_u64(const abi_value_t* value, uint64_t* out) {
+    uint256_t v;
+    esp_err_t err = abi_value_to_uint256(value, &v);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return uint256_to_u64(&v, out) ? ESP_OK : ESP_ERR_INVALID_SIZE;
+}
+
+esp_err_t abi_value_to_i64(const abi_value_t* value, int64_t* out) {
+    uint256_t magnitude;
+    bool negative;
+    esp_err_t err = abi_value_to_int256(value, &magnitude, &negative);
+    if (err != ESP_OK || !out) {
+        return err != ESP_OK ? err : ESP_ERR_INVALID_ARG;
+    }
+    
+    uint64_t m;
+    if (!uint256_to_u64(&magnitude, &m) || m > (negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    *out = negative ? (int64_t)(0 - m) : (int64_t)m;
+    return ESP_OK;
+}
+
+esp_err_t abi_value_to_bool(const abi_value_t* value, bool* out) {
+    if (!value || !out || value->type != ABI_TYPE_BOOL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *out = value->data[0] != 0;
+    return ESP_OK;
 }
 
 // 从ABI编码数据中解码字符串
@@ -385,52 +1158,35 @@ esp_err_t abi_decode_string(const uint8_t* data, size_t data_len, size_t offset,
     
     // 安全检查
     if (offset >= data_len) {
-        ESP_LOGE(TAG, "String offset out of bounds: %d >= %d", offset, data_len);
+        ESP_LOGE(TAG, "String offset out of bounds: %d >= %d", (int)offset, (int)data_len);
         return ESP_ERR_INVALID_SIZE;
     }
     
-    // 字符串的位置偏移量
-    uint64_t string_pos = abi_extract_uint64(data, offset, data_len);
-    ESP_LOGI(TAG, "String position offset: %llu", string_pos);
-    
-    // 确保偏移量在合理范围内
-    if (string_pos >= data_len) {
-        ESP_LOGE(TAG, "String offset out of bounds: %llu >= %d", string_pos, data_len);
+    // offset处是字符串相对于数据起点的偏移量
+    size_t string_pos;
+    if (offset + ABI_WORD_SIZE > data_len || !abi_read_word_size(data + offset, &string_pos) ||
+        string_pos > data_len) {
+        ESP_LOGE(TAG, "String position out of bounds");
         return ESP_ERR_INVALID_SIZE;
     }
     
-    // 字符串长度
-    uint64_t string_len = abi_extract_uint64(data, string_pos, data_len);
-    ESP_LOGI(TAG, "String length: %llu", string_len);
-    
-    // 确保字符串长度在合理范围内 
-    if (string_len == 0) {
-        // 空字符串
-        output[0] = '\0';
-        return ESP_OK;
-    }
-    
-    if (string_pos + 32 + string_len > data_len) {
-        ESP_LOGE(TAG, "String data out of bounds: %llu + 32 + %llu > %d", 
-                 string_pos, string_len, data_len);
-        return ESP_ERR_INVALID_SIZE;
+    abi_value_t str;
+    esp_err_t err = abi_decode_region("string", 6, data + string_pos, data + data_len, &str);
+    if (err != ESP_OK) {
+        return err;
     }
     
-    // 确保字符串长度合理 (防止异常大的值)
-    if (string_len > 10240) { // 10KB 上限
-        ESP_LOGE(TAG, "String length too large: %llu", string_len);
-        return ESP_ERR_INVALID_SIZE;
-    }
+    size_t string_len = str.length;
     
     // 确保输出缓冲区足够大
     if (string_len + 1 > output_len) {
-        ESP_LOGW(TAG, "Output buffer too small: %llu + 1 > %d, truncating", 
-                 string_len, output_len);
+        ESP_LOGW(TAG, "Output buffer too small: %d + 1 > %d, truncating", 
+                 (int)string_len, (int)output_len);
         string_len = output_len - 1;
     }
     
     // 复制字符串数据
-    memcpy(output, data + string_pos + 32, string_len);
+    memcpy(output, str.data, string_len);
     output[string_len] = '\0'; // 添加字符串结束符
     
     return ESP_OK;
@@ -447,7 +1203,7 @@ esp_err_t abi_decode_returns(const uint8_t* data, size_t data_len,
     *decoded_count = 0;
     
     // 记录数据长度和内容前几个字节用于调试
-    ESP_LOGI(TAG, "Decoding ABI data, length: %d bytes", data_len);
+    ESP_LOGI(TAG, "Decoding ABI data, length: %d bytes", (int)data_len);
     if (data_len >= 32) {
         ESP_LOGI(TAG, "First 32 bytes: %02x %02x %02x %02x ...", 
                  data[0], data[1], data[2], data[3]);
@@ -461,7 +1217,7 @@ esp_err_t abi_decode_returns(const uint8_t* data, size_t data_len,
         // 确保头部在数据范围内
         if (head_pos + 32 > data_len) {
             ESP_LOGE(TAG, "Return value head out of bounds: %d + 32 > %d", 
-                     head_pos, data_len);
+                     (int)head_pos, (int)data_len);
             break; // 继续处理已解码的值，而不是返回错误
         }
         
@@ -469,28 +1225,28 @@ esp_err_t abi_decode_returns(const uint8_t* data, size_t data_len,
         outputs[i].type = ABI_TYPE_STRING; // 默认假设是字符串 (可以根据需要拓展)
         outputs[i].is_dynamic = true;
         
-        // 分配内存并解码字符串
-        size_t str_buffer_size = 2048; // 增加缓冲区大小，确保足够空间
-        outputs[i].value.string = malloc(str_buffer_size);
+        // 先取得字符串视图，再按实际长度分配
+        abi_value_t str = {0};
+        size_t string_pos;
+        esp_err_t err = ESP_ERR_INVALID_SIZE;
+        if (abi_read_word_size(data + head_pos, &string_pos) && string_pos <= data_len) {
+            err = abi_decode_region("string", 6, data + string_pos, data + data_len, &str);
+        }
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to decode string at index %d: %s", 
+                     (int)i, esp_err_to_name(err));
+            str.length = 0;  // 设为空字符串，让上层函数处理
+        }
         
+        outputs[i].value.string = malloc(str.length + 1);
         if (!outputs[i].value.string) {
             ESP_LOGE(TAG, "Failed to allocate memory for string");
             break; // 继续处理已解码的值
         }
-        
-        // 初始化字符串缓冲区
-        memset(outputs[i].value.string, 0, str_buffer_size);
-        
-        // 解码字符串
-        esp_err_t err = abi_decode_string(data, data_len, head_pos, 
-                                       outputs[i].value.string, str_buffer_size);
-        
-        if (err != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to decode string at index %d: %s", 
-                     i, esp_err_to_name(err));
-            // 不释放内存，让上层函数处理
-            outputs[i].value.string[0] = '\0'; // 设为空字符串
+        if (str.length > 0) {
+            memcpy(outputs[i].value.string, str.data, str.length);
         }
+        outputs[i].value.string[str.length] = '\0';
         
         outputs[i].length = strlen(outputs[i].value.string);
         (*decoded_count)++;
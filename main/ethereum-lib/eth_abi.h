@@ -16,6 +16,7 @@
 #include <stddef.h>
 #include <esp_err.h>
 #include "web3.h"  // Add this include to make web3_context_t available
+#include "eth_uint256.h"
 
 /**
  * @brief 以太坊ABI数据类型
@@ -25,21 +26,26 @@ typedef enum {
     ABI_TYPE_INT,      // 有符号整数 (int8至int256)
     ABI_TYPE_ADDRESS,  // 地址 (20字节)
     ABI_TYPE_BOOL,     // 布尔值
-    ABI_TYPE_BYTES,    // 定长字节数组 (bytes1至bytes32)
+    ABI_TYPE_BYTES,    // 字节数组 (定长bytes1至bytes32，或动态bytes)
     ABI_TYPE_STRING,   // 字符串
-    ABI_TYPE_ARRAY,    // 数组 (简化处理)
+    ABI_TYPE_ARRAY,    // 数组 (动态T[]或定长T[k])
+    ABI_TYPE_TUPLE,    // 元组 (Solidity结构体)
 } abi_type_t;
 
+#ifndef ABI_MAX_NESTING_DEPTH
+#define ABI_MAX_NESTING_DEPTH 8  // 元组/数组最大嵌套层数，限制编码递归深度
+#endif
+
 /**
  * @brief ABI参数结构体
  */
 typedef struct {
     abi_type_t type;      // 参数类型
-    uint16_t size;        // 类型大小 (位数，如uint256则为256)
+    uint16_t size;        // 类型大小 (位数，如uint256则为256，bytesN为N*8)；数组为定长k，动态数组为0
     bool is_array;        // 是否为数组类型
-    bool is_dynamic;      // 是否为动态类型(string, bytes, 动态数组)
-    const void* value;    // 参数值指针
-    size_t length;        // 对于数组/字符串/bytes，表示长度
+    bool is_dynamic;      // 是否为动态类型(string, bytes, 动态数组)，元组和定长数组由元素决定
+    const void* value;    // 参数值指针 (整数为size/8字节大端序；数组和元组指向abi_param_t元素数组)
+    size_t length;        // 对于字符串/bytes为字节数，对于数组/元组为元素个数
 } abi_param_t;
 
 /**
@@ -61,19 +67,104 @@ typedef struct {
     bool is_dynamic;        // 是否为动态类型
 } abi_decoded_value_t;
 
+/**
+ * @brief 类型化解码得到的值 (指向调用者缓冲区的视图，不持有内存)
+ *
+ * data/length的含义随类型而定:
+ * - uintN/intN: 32字节大端序字，用abi_value_to_uint256等函数读取
+ * - address: 20字节地址；bool: 1字节；bytesN: N字节
+ * - string/bytes: 内容本身 (string不以'\0'结尾)
+ * - 数组/元组: length为元素个数，用abi_value_at访问元素
+ */
+typedef struct {
+    abi_type_t type;        // 值的类型
+    uint16_t size;          // intN/uintN的位数，bytesN的N*8，定长数组的k (动态数组为0)
+    const uint8_t* data;    // 数据视图
+    size_t length;          // 数据长度或元素个数
+    const char* type_str;   // 类型描述 (指向传给abi_decode的签名字符串)
+    size_t type_len;        // 类型描述长度
+    const uint8_t* end;     // 编码数据的结尾，用于元素访问时的边界检查
+} abi_value_t;
+
 /**
  * @brief 计算函数选择器 - 函数选择器是函数签名的Keccak256哈希值的前4个字节
  * 
- * @param context web3上下文
+ * 哈希在本地计算，不发起网络请求
+ * 
+ * @param context web3上下文 (未使用，可为NULL，保留以兼容旧接口)
  * @param signature 函数签名 (如 "transfer(address,uint256)")
  * @param selector 输出的选择器 (4字节)
  * @return esp_err_t ESP_OK成功，其他值失败
  */
 esp_err_t abi_encode_function_selector(web3_context_t* context, const char* signature, uint8_t selector[4]);
 
+#ifndef ABI_SELECTOR_CACHE_SIZE
+#define ABI_SELECTOR_CACHE_SIZE 16          // 选择器缓存条目数
+#endif
+#define ABI_SELECTOR_CACHE_MAX_SIGNATURE 96 // 可缓存的最长函数签名 (含结束符)
+
+/**
+ * @brief 选择器缓存统计
+ */
+typedef struct {
+    uint32_t hits;        // 命中次数
+    uint32_t misses;      // 未命中次数 (需要计算哈希)
+    uint32_t evictions;   // 因缓存已满被淘汰的条目数
+    uint32_t entries;     // 当前缓存条目数
+} abi_selector_cache_stats_t;
+
+/**
+ * @brief 获取函数选择器，优先从缓存读取
+ * 
+ * 未命中时计算Keccak256并写入缓存 (LRU淘汰，预注册条目不会被淘汰)。
+ * 超过ABI_SELECTOR_CACHE_MAX_SIGNATURE的签名直接计算，不进入缓存。
+ * 
+ * @param signature 函数签名 (如 "hasChallenge(uint256)")
+ * @param selector 输出的选择器 (4字节)
+ * @return esp_err_t ESP_OK成功，其他值失败
+ */
+esp_err_t abi_get_function_selector(const char* signature, uint8_t selector[4]);
+
+/**
+ * @brief 预注册函数选择器，通常在初始化时调用
+ * 
+ * 预注册的条目常驻缓存，热路径上的调用不会再计算哈希。
+ * 
+ * @param signature 函数签名
+ * @return esp_err_t ESP_OK成功，缓存已被预注册条目占满时返回ESP_ERR_NO_MEM
+ */
+esp_err_t abi_selector_cache_register(const char* signature);
+
+/**
+ * @brief 读取选择器缓存统计
+ * 
+ * @param stats 输出的统计信息
+ */
+void abi_selector_cache_get_stats(abi_selector_cache_stats_t* stats);
+
+/**
+ * @brief 清空选择器缓存 (包括预注册条目) 并重置统计
+ */
+void abi_selector_cache_clear(void);
+
+/**
+ * @brief 计算参数按元组编码后的精确长度 (不含4字节函数选择器)
+ * 
+ * 同时校验参数描述，调用者可以据此一次分配好输出缓冲区。
+ * 
+ * @param params 参数数组
+ * @param param_count 参数数量
+ * @param size 输出的编码长度
+ * @return esp_err_t ESP_OK成功，参数描述无效返回ESP_ERR_INVALID_ARG
+ */
+esp_err_t abi_encoded_size(const abi_param_t* params, size_t param_count, size_t* size);
+
 /**
  * @brief 对单个参数进行ABI编码
  * 
+ * 静态类型输出32字节 (静态元组/定长数组为全部元素)，
+ * 动态类型输出完整内容 (长度 + 数据，或数组的元素个数 + 元素编码)。
+ * 
  * @param param 参数描述
  * @param output 输出缓冲区
  * @param output_len 输出缓冲区大小
@@ -88,6 +179,8 @@ esp_err_t abi_encode_param(const abi_param_t* param,
 /**
  * @brief 对多个参数进行ABI编码
  * 
+ * 支持嵌套的元组、T[]、T[k]和动态类型，先计算精确长度再一次写完。
+ * 
  * @param params 参数数组
  * @param param_count 参数数量
  * @param output 输出缓冲区
@@ -104,7 +197,7 @@ esp_err_t abi_encode_params(const abi_param_t* params,
 /**
  * @brief 创建完整的合约函数调用数据
  * 
- * @param context web3上下文
+ * @param context web3上下文 (未使用，可为NULL)
  * @param signature 函数签名
  * @param params 参数数组
  * @param param_count 参数数量
@@ -121,6 +214,26 @@ esp_err_t abi_encode_function_call(web3_context_t* context,
                                  size_t output_len, 
                                  size_t* bytes_written);
 
+/**
+ * @brief 用已知的函数选择器创建合约函数调用数据
+ * 
+ * 选择器在编译期已确定时使用 (如abigen生成的绑定)，运行时不计算哈希。
+ * 
+ * @param selector 函数选择器 (4字节)
+ * @param params 参数数组
+ * @param param_count 参数数量
+ * @param output 输出缓冲区
+ * @param output_len 输出缓冲区大小
+ * @param bytes_written 实际写入的字节数
+ * @return esp_err_t ESP_OK成功，缓冲区不足返回ESP_ERR_INVALID_SIZE
+ */
+esp_err_t abi_encode_call_with_selector(const uint8_t selector[4],
+                                        const abi_param_t* params,
+                                        size_t param_count,
+                                        uint8_t* output,
+                                        size_t output_len,
+                                        size_t* bytes_written);
+
 /**
  * @brief 将编码后的二进制数据转换为十六进制字符串
  * 
@@ -146,6 +259,70 @@ esp_err_t abi_binary_to_hex(const uint8_t* binary,
  */
 esp_err_t abi_hex_to_binary(const char* hex, uint8_t* binary, size_t binary_len, size_t* bytes_written);
 
+/**
+ * @brief 按类型签名解码ABI数据 (零拷贝，不分配内存)
+ *
+ * 解码前会校验所有偏移量、长度和数值填充，成功后访问任意元素都不会越界。
+ *
+ *     abi_value_t ret, amount, name;
+ *     abi_decode("(uint256,address,string,bytes32[])", data, data_len, &ret);
+ *     abi_value_at(&ret, 0, &amount);
+ *     abi_value_at(&ret, 2, &name);    // name.data/name.length指向data中的字符串
+ *
+ * @param types 元组形式的类型签名，必须以括号包围，如 "(uint256,string)"
+ * @param data ABI编码数据 (解码结果引用该缓冲区，使用期间需保持有效)
+ * @param data_len 数据长度
+ * @param out 输出的元组视图
+ * @return esp_err_t ESP_OK成功，类型签名无效返回ESP_ERR_INVALID_ARG，
+ *         偏移量或长度越界返回ESP_ERR_INVALID_SIZE，数值填充不合规返回ESP_ERR_INVALID_RESPONSE
+ */
+esp_err_t abi_decode(const char* types, const uint8_t* data, size_t data_len, abi_value_t* out);
+
+/**
+ * @brief 访问元组或数组的第index个元素
+ *
+ * @param container abi_decode或本函数得到的元组/数组
+ * @param index 元素序号
+ * @param out 输出的元素视图
+ * @return esp_err_t ESP_OK成功，越界返回ESP_ERR_NOT_FOUND，container不是元组/数组返回ESP_ERR_INVALID_ARG
+ */
+esp_err_t abi_value_at(const abi_value_t* container, size_t index, abi_value_t* out);
+
+/**
+ * @brief 读取uintN值
+ *
+ * @return esp_err_t ESP_OK成功，类型不是uintN返回ESP_ERR_INVALID_ARG
+ */
+esp_err_t abi_value_to_uint256(const abi_value_t* value, uint256_t* out);
+
+/**
+ * @brief 读取intN值，输出绝对值和符号 (也接受uintN)
+ *
+ * @return esp_err_t ESP_OK成功，类型不是整数返回ESP_ERR_INVALID_ARG
+ */
+esp_err_t abi_value_to_int256(const abi_value_t* value, uint256_t* magnitude, bool* negative);
+
+/**
+ * @brief 读取uintN值到64位整数
+ *
+ * @return esp_err_t ESP_OK成功，类型不是uintN返回ESP_ERR_INVALID_ARG，超过64位返回ESP_ERR_INVALID_SIZE
+ */
+esp_err_t abi_value_to_u64(const abi_value_t* value, uint64_t* out);
+
+/**
+ * @brief 读取intN值到64位有符号整数 (也接受uintN)
+ *
+ * @return esp_err_t ESP_OK成功，类型不是整数返回ESP_ERR_INVALID_ARG，超出int64范围返回ESP_ERR_INVALID_SIZE
+ */
+esp_err_t abi_value_to_i64(const abi_value_t* value, int64_t* out);
+
+/**
+ * @brief 读取bool值
+ *
+ * @return esp_err_t ESP_OK成功，类型不是bool返回ESP_ERR_INVALID_ARG
+ */
+esp_err_t abi_value_to_bool(const abi_value_t* value, bool* out);
+
 /**
  * @brief 从ABI编码数据中解码字符串
  *
@@ -160,7 +337,9 @@ esp_err_t abi_decode_string(const uint8_t* data, size_t data_len, size_t offset,
                             char* output, size_t output_len);
 
 /**
- * @brief 从ABI编码数据中解码多个返回值
+ * @brief 从ABI编码数据中解码多个返回值 (假定都是字符串，每个值单独分配内存)
+ *
+ * 新代码请使用abi_decode，直接得到指向data的视图。
  *
  * @param data ABI编码的二进制数据
  * @param data_len 数据长度
@@ -187,5 +366,9 @@ void abi_free_decoded_value(abi_decoded_value_t* value);
 #define ABI_BOOL(val) { .type = ABI_TYPE_BOOL, .size = 8, .is_array = false, .is_dynamic = false, .value = (val), .length = 0 }
 #define ABI_BYTES(val, len) { .type = ABI_TYPE_BYTES, .size = 0, .is_array = false, .is_dynamic = true, .value = (val), .length = (len) }
 #define ABI_STRING(val) { .type = ABI_TYPE_STRING, .size = 0, .is_array = false, .is_dynamic = true, .value = (val), .length = strlen((const char*)(val)) }
+#define ABI_BYTES_FIXED(val, n) { .type = ABI_TYPE_BYTES, .size = (n) * 8, .is_array = false, .is_dynamic = false, .value = (val), .length = (n) }
+#define ABI_ARRAY(elems, count) { .type = ABI_TYPE_ARRAY, .size = 0, .is_array = true, .is_dynamic = true, .value = (elems), .length = (count) }
+#define ABI_FIXED_ARRAY(elems, count) { .type = ABI_TYPE_ARRAY, .size = (count), .is_array = true, .is_dynamic = false, .value = (elems), .length = (count) }
+#define ABI_TUPLE(fields, count) { .type = ABI_TYPE_TUPLE, .size = 0, .is_array = false, .is_dynamic = false, .value = (fields), .length = (count) }
 
 #endif /* ETH_ABI_H */
@@ -0,0 +1,515 @@
+/*
+    ABI编码的C++17封装 (仅头文件)
+
+    函数选择器由constexpr Keccak-256在编译期计算；参数类型作为模板参数给出，
+    编码代码按类型列表展开，静态类型的头部直接写入，运行时没有类型分派，
+    也不需要手工构造abi_param_t数组。
+
+    namespace abi = eth::abi;
+
+    // 签名与类型列表不一致时编译失败
+    constexpr abi::function<abi::address, abi::uint256> transfer("transfer(address,uint256)");
+    static_assert(transfer.selector()[0] == 0xa9, "");
+
+    uint256_t amount;
+    uint256_set_u64(&amount, 1000);
+    transfer.encode(out, sizeof(out), &written, to, amount);
+
+    // 只编码参数 (不含选择器)
+    abi::encode<abi::uint256, abi::address, abi::string>(out, sizeof(out), &written, id, owner, "name");
+
+    支持的类型: uint8..uint256、int8..int256、address、boolean、bytes1..bytes32、bytes、string。
+    元组和数组仍使用eth_abi.h的abi_param_t接口；返回值用abi_decode解码。
+
+*/
+
+#ifndef ETH_ABI_HPP
+#define ETH_ABI_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+extern "C" {
+#include "eth_abi.h"
+#include "eth_uint256.h"
+}
+
+namespace eth {
+namespace abi {
+
+constexpr size_t word_size = 32;
+
+using selector_t = std::array<uint8_t, 4>;
+using hash_t = std::array<uint8_t, 32>;
+
+/**
+ * @brief 只读字节视图，作为bytes参数 (指针 + 长度)
+ */
+struct byte_view {
+    const uint8_t* data;
+    size_t size;
+
+    constexpr byte_view(const uint8_t* d, size_t n) : data(d), size(n) {}
+    template <size_t N>
+    constexpr byte_view(const std::array<uint8_t, N>& a) : data(a.data()), size(N) {}
+    template <size_t N>
+    constexpr byte_view(const uint8_t (&a)[N]) : data(a), size(N) {}
+};
+
+namespace detail {
+
+// ---------------------------------------------------------------------------
+// constexpr Keccak-256，与eth_keccak.c的置换相同
+
+constexpr uint64_t keccak_round_constants[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
+    0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
+    0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+    0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+constexpr uint8_t keccak_rho[24] = {
+    1,  3,  6,  10, 15, 21, 28, 36, 45, 55, 2,  14,
+    27, 41, 56, 8,  25, 43, 62, 18, 39, 61, 20, 44
+};
+
+constexpr uint8_t keccak_pi[24] = {
+    10, 7,  11, 17, 18, 3, 5,  16, 8,  21, 24, 4,
+    15, 23, 19, 13, 12, 2, 20, 14, 22, 9,  6,  1
+};
+
+constexpr size_t keccak_rate = 136;
+
+constexpr uint64_t rotl64(uint64_t x, unsigned n) {
+    return (x << n) | (x >> (64 - n));
+}
+
+constexpr void keccak_f1600(uint64_t (&st)[25]) {
+    for (int round = 0; round < 24; round++) {
+        uint64_t bc[5] = {};
+        for (int i = 0; i < 5; i++) {
+            bc[i] = st[i] ^ st[i + 5] ^ st[i + 10] ^ st[i + 15] ^ st[i + 20];
+        }
+        for (int i = 0; i < 5; i++) {
+            uint64_t t = bc[(i + 4) % 5] ^ rotl64(bc[(i + 1) % 5], 1);
+            for (int j = 0; j < 25; j += 5) {
+                st[j + i] ^= t;
+            }
+        }
+
+        uint64_t t = st[1];
+        for (int i = 0; i < 24; i++) {
+            int j = keccak_pi[i];
+            uint64_t tmp = st[j];
+            st[j] = rotl64(t, keccak_rho[i]);
+            t = tmp;
+        }
+
+        for (int j = 0; j < 25; j += 5) {
+            for (int i = 0; i < 5; i++) {
+                bc[i] = st[j + i];
+            }
+            for (int i = 0; i < 5; i++) {
+                st[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
+            }
+        }
+
+        st[0] ^= keccak_round_constants[round];
+    }
+}
+
+constexpr hash_t keccak256(std::string_view data) {
+    uint64_t st[25] = {};
+    size_t pos = 0;
+    for (char c : data) {
+        st[pos / 8] ^= (uint64_t)(uint8_t)c << (8 * (pos % 8));
+        if (++pos == keccak_rate) {
+            keccak_f1600(st);
+            pos = 0;
+        }
+    }
+    st[pos / 8] ^= (uint64_t)0x01 << (8 * (pos % 8));
+    st[(keccak_rate - 1) / 8] ^= (uint64_t)0x80 << (8 * ((keccak_rate - 1) % 8));
+    keccak_f1600(st);
+
+    hash_t hash = {};
+    for (size_t i = 0; i < hash.size(); i++) {
+        hash[i] = (uint8_t)(st[i / 8] >> (8 * (i % 8)));
+    }
+    return hash;
+}
+
+// ---------------------------------------------------------------------------
+// 类型名 (用于编译期核对签名)
+
+struct type_name {
+    char str[12];
+    size_t len;
+
+    constexpr std::string_view view() const { return std::string_view(str, len); }
+};
+
+constexpr type_name make_name(std::string_view prefix, unsigned bits) {
+    type_name name = {};
+    for (char c : prefix) {
+        name.str[name.len++] = c;
+    }
+    if (bits > 0) {
+        char digits[4] = {};
+        size_t n = 0;
+        for (; bits > 0; bits /= 10) {
+            digits[n++] = (char)('0' + bits % 10);
+        }
+        while (n > 0) {
+            name.str[name.len++] = digits[--n];
+        }
+    }
+    return name;
+}
+
+template <typename... Ts>
+constexpr bool signature_matches(std::string_view signature) {
+    size_t open = signature.find('(');
+    if (open == std::string_view::npos || open == 0 || signature.back() != ')') {
+        return false;
+    }
+    std::string_view params = signature.substr(open + 1, signature.size() - open - 2);
+
+    const std::string_view names[sizeof...(Ts) + 1] = { Ts::name.view()..., std::string_view() };
+    size_t pos = 0;
+    for (size_t i = 0; i < sizeof...(Ts); i++) {
+        if (i > 0) {
+            if (pos >= params.size() || params[pos] != ',') {
+                return false;
+            }
+            pos++;
+        }
+        if (params.substr(pos, names[i].size()) != names[i]) {
+            return false;
+        }
+        pos += names[i].size();
+    }
+    return pos == params.size();
+}
+
+// 非constexpr函数：在常量求值中被调用即产生编译错误
+inline void signature_does_not_match_parameter_types() {}
+
+// ---------------------------------------------------------------------------
+// 字写入
+
+constexpr size_t padded_len(size_t len) {
+    return (len + word_size - 1) / word_size * word_size;
+}
+
+// 64位值写成32字节大端字，fill为高位填充字节 (有符号负数为0xff)
+inline void put_u64_word(uint8_t* out, uint64_t v, uint8_t fill = 0) {
+    memset(out, fill, word_size - 8);
+    for (int i = word_size - 1; i >= (int)(word_size - 8); i--, v >>= 8) {
+        out[i] = (uint8_t)v;
+    }
+}
+
+inline void put_bytes_padded(uint8_t* out, const void* data, size_t len) {
+    if (len > 0) {
+        memcpy(out, data, len);
+    }
+    memset(out + len, 0, padded_len(len) - len);
+}
+
+}  // namespace detail
+
+// ---------------------------------------------------------------------------
+// ABI类型。每个类型提供:
+//   name            规范类型名
+//   arg_type        C++参数类型
+//   dynamic         是否为动态类型
+//   check(v)        值是否在类型范围内
+//   write(out, v)   静态类型写入32字节头部
+//   tail_size(v) / write_tail(out, v)  动态类型的尾部
+
+template <unsigned N>
+struct uint_t {
+    static_assert(N >= 8 && N <= 256 && N % 8 == 0, "uintN: N must be a multiple of 8 in [8, 256]");
+    using arg_type = std::conditional_t<(N <= 64), uint64_t, const uint256_t&>;
+    static constexpr bool dynamic = false;
+    static constexpr detail::type_name name = detail::make_name("uint", N);
+
+    static bool check(arg_type v) {
+        if constexpr (N < 64) {
+            return (v >> N) == 0;
+        } else if constexpr (N == 64 || N == 256) {
+            (void)v;
+            return true;
+        } else {
+            return uint256_bit_length(&v) <= N;
+        }
+    }
+
+    static void write(uint8_t* out, arg_type v) {
+        if constexpr (N <= 64) {
+            detail::put_u64_word(out, v);
+        } else {
+            uint256_to_be_bytes(&v, out);
+        }
+    }
+};
+
+/**
+ * @brief intN，N > 64时参数为32字节大端补码
+ */
+template <unsigned N>
+struct int_t {
+    static_assert(N >= 8 && N <= 256 && N % 8 == 0, "intN: N must be a multiple of 8 in [8, 256]");
+    using arg_type = std::conditional_t<(N <= 64), int64_t, const uint8_t*>;
+    static constexpr bool dynamic = false;
+    static constexpr detail::type_name name = detail::make_name("int", N);
+
+    static bool check(arg_type v) {
+        if constexpr (N < 64) {
+            return v >= -(INT64_C(1) << (N - 1)) && v < (INT64_C(1) << (N - 1));
+        } else if constexpr (N == 64) {
+            (void)v;
+            return true;
+        } else {
+            if (!v) {
+                return false;
+            }
+            // 高位字节必须全部是符号扩展
+            constexpr size_t skip = word_size - N / 8;
+            uint8_t fill = (v[skip] & 0x80) ? 0xff : 0x00;
+            for (size_t i = 0; i < skip; i++) {
+                if (v[i] != fill) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    static void write(uint8_t* out, arg_type v) {
+        if constexpr (N <= 64) {
+            detail::put_u64_word(out, (uint64_t)v, v < 0 ? 0xff : 0x00);
+        } else {
+            memcpy(out, v, word_size);
+        }
+    }
+};
+
+struct address {
+    using arg_type = const uint8_t*;  // 20字节，可直接传eth_address_t
+    static constexpr bool dynamic = false;
+    static constexpr detail::type_name name = detail::make_name("address", 0);
+
+    static bool check(arg_type v) { return v != nullptr; }
+
+    static void write(uint8_t* out, arg_type v) {
+        memset(out, 0, word_size - 20);
+        memcpy(out + word_size - 20, v, 20);
+    }
+};
+
+struct boolean {
+    using arg_type = bool;
+    static constexpr bool dynamic = false;
+    static constexpr detail::type_name name = detail::make_name("bool", 0);
+
+    static bool check(arg_type) { return true; }
+
+    static void write(uint8_t* out, arg_type v) { detail::put_u64_word(out, v ? 1 : 0); }
+};
+
+/**
+ * @brief 定长bytesN (左对齐，右侧补0)
+ */
+template <unsigned N>
+struct bytes_t {
+    static_assert(N >= 1 && N <= 32, "bytesN: N must be in [1, 32]");
+    using arg_type = const uint8_t*;
+    static constexpr bool dynamic = false;
+    static constexpr detail::type_name name = detail::make_name("bytes", N);
+
+    static bool check(arg_type v) { return v != nullptr; }
+
+    static void write(uint8_t* out, arg_type v) { detail::put_bytes_padded(out, v, N); }
+};
+
+struct bytes {
+    using arg_type = byte_view;
+    static constexpr bool dynamic = true;
+    static constexpr detail::type_name name = detail::make_name("bytes", 0);
+
+    static bool check(arg_type v) { return v.data || v.size == 0; }
+
+    static size_t tail_size(arg_type v) { return word_size + detail::padded_len(v.size); }
+
+    static void write_tail(uint8_t* out, arg_type v) {
+        detail::put_u64_word(out, v.size);
+        detail::put_bytes_padded(out + word_size, v.data, v.size);
+    }
+};
+
+struct string {
+    using arg_type = std::string_view;
+    static constexpr bool dynamic = true;
+    static constexpr detail::type_name name = detail::make_name("string", 0);
+
+    static bool check(arg_type v) { return v.data() || v.empty(); }
+
+    static size_t tail_size(arg_type v) { return word_size + detail::padded_len(v.size()); }
+
+    static void write_tail(uint8_t* out, arg_type v) {
+        detail::put_u64_word(out, v.size());
+        detail::put_bytes_padded(out + word_size, v.data(), v.size());
+    }
+};
+
+using uint8 = uint_t<8>;
+using uint16 = uint_t<16>;
+using uint32 = uint_t<32>;
+using uint64 = uint_t<64>;
+using uint128 = uint_t<128>;
+using uint256 = uint_t<256>;
+using int8 = int_t<8>;
+using int16 = int_t<16>;
+using int32 = int_t<32>;
+using int64 = int_t<64>;
+using int128 = int_t<128>;
+using int256 = int_t<256>;
+using bytes4 = bytes_t<4>;
+using bytes32 = bytes_t<32>;
+
+namespace detail {
+
+template <typename T>
+size_t tail_size(typename T::arg_type v) {
+    if constexpr (T::dynamic) {
+        return T::tail_size(v);
+    } else {
+        (void)v;
+        return 0;
+    }
+}
+
+// 写入一个参数: 静态类型写头部；动态类型在头部写偏移量，数据追加到尾部
+template <typename T>
+void write_param(uint8_t* base, uint8_t*& head, size_t& tail, typename T::arg_type v) {
+    if constexpr (T::dynamic) {
+        put_u64_word(head, tail);
+        T::write_tail(base + tail, v);
+        tail += T::tail_size(v);
+    } else {
+        T::write(head, v);
+    }
+    head += word_size;
+}
+
+}  // namespace detail
+
+/**
+ * @brief 计算参数编码后的精确字节数 (不含选择器)
+ */
+template <typename... Ts>
+size_t encoded_size(typename Ts::arg_type... args) {
+    return sizeof...(Ts) * word_size + (detail::tail_size<Ts>(args) + ... + 0);
+}
+
+/**
+ * @brief 按类型列表编码参数 (不含选择器)
+ *
+ * @return esp_err_t ESP_OK成功，值超出类型范围返回ESP_ERR_INVALID_ARG，
+ *         缓冲区不足返回ESP_ERR_INVALID_SIZE
+ */
+template <typename... Ts>
+esp_err_t encode(uint8_t* out, size_t out_len, size_t* written, typename Ts::arg_type... args) {
+    if (!out || !written) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *written = 0;
+    if (!(Ts::check(args) && ... && true)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t total = encoded_size<Ts...>(args...);
+    if (total > out_len) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    [[maybe_unused]] uint8_t* head = out;
+    [[maybe_unused]] size_t tail = sizeof...(Ts) * word_size;
+    (detail::write_param<Ts>(out, head, tail, args), ...);
+    *written = total;
+    return ESP_OK;
+}
+
+/**
+ * @brief 编译期计算函数选择器
+ */
+constexpr selector_t selector(std::string_view signature) {
+    hash_t hash = detail::keccak256(signature);
+    return selector_t{ { hash[0], hash[1], hash[2], hash[3] } };
+}
+
+/**
+ * @brief 类型化的合约函数
+ *
+ * 声明为constexpr时，选择器在编译期计算，签名的参数部分与Ts不一致则编译失败。
+ */
+template <typename... Ts>
+class function {
+public:
+    constexpr explicit function(std::string_view signature) : selector_(abi::selector(signature)) {
+        if (!detail::signature_matches<Ts...>(signature)) {
+            detail::signature_does_not_match_parameter_types();
+        }
+    }
+
+    constexpr const selector_t& selector() const { return selector_; }
+
+    /**
+     * @brief 调用数据的精确字节数 (选择器 + 参数)
+     */
+    size_t encoded_size(typename Ts::arg_type... args) const {
+        return selector_.size() + abi::encoded_size<Ts...>(args...);
+    }
+
+    /**
+     * @brief 编码调用数据 (选择器 + 参数)
+     *
+     * @return esp_err_t 同abi::encode
+     */
+    esp_err_t encode(uint8_t* out, size_t out_len, size_t* written, typename Ts::arg_type... args) const {
+        if (!out || !written) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        *written = 0;
+        if (out_len < selector_.size()) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+
+        size_t params_len = 0;
+        esp_err_t err = abi::encode<Ts...>(out + selector_.size(), out_len - selector_.size(), &params_len, args...);
+        if (err != ESP_OK) {
+            return err;
+        }
+        memcpy(out, selector_.data(), selector_.size());
+        *written = selector_.size() + params_len;
+        return ESP_OK;
+    }
+
+private:
+    selector_t selector_;
+};
+
+}  // namespace abi
+}  // namespace eth
+
+#endif /* ETH_ABI_HPP */
@@ -0,0 +1,320 @@
+#include "eth_abi_index.h"
+#include "eth_abi.h"
+#include "eth_json.h"
+#include "eth_keccak.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <esp_log.h>
+
+static const char *TAG = "ETH_ABI_INDEX";
+
+/*
+    加载分两遍扫描同一段JSON：
+    1. 只计算条目数和字符串总长度
+    2. 一次分配条目表、哈希表和字符串区，再写入内容
+    字符串构造器在buf为NULL时只计数，两遍共用同一套代码。
+*/
+
+typedef struct {
+    char* buf;      // 为NULL时只计算长度
+    size_t len;
+} str_builder_t;
+
+static void sb_put(str_builder_t* sb, const char* s, size_t n) {
+    if (sb->buf) {
+        memcpy(sb->buf + sb->len, s, n);
+    }
+    sb->len += n;
+}
+
+static void sb_put_token(str_builder_t* sb, const eth_json_token_t* token) {
+    sb_put(sb, token->start, token->len);
+}
+
+static esp_err_t append_params(str_builder_t* sb, const eth_json_token_t* params, unsigned depth, size_t* count);
+
+// 写出单个参数的规范类型，tuple展开为 (T1,T2,...) 并保留数组后缀
+static esp_err_t append_type(str_builder_t* sb, const eth_json_token_t* param, unsigned depth) {
+    eth_json_token_t type;
+    if (param->type != ETH_JSON_OBJECT ||
+        eth_json_object_get(param, "type", &type) != ESP_OK || type.type != ETH_JSON_STRING) {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+
+    if (type.len < 5 || memcmp(type.start, "tuple", 5) != 0) {
+        sb_put_token(sb, &type);
+        return ESP_OK;
+    }
+
+    eth_json_token_t components;
+    if (eth_json_object_get(param, "components", &components) != ESP_OK) {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    size_t count = 0;
+    esp_err_t err = append_params(sb, &components, depth + 1, &count);
+    if (err == ESP_OK) {
+        sb_put(sb, type.start + 5, type.len - 5);  // "tuple[2][]" 的后缀
+    }
+    return err;
+}
+
+// 写出参数列表 "(T1,T2,...)"
+static esp_err_t append_params(str_builder_t* sb, const eth_json_token_t* params, unsigned depth, size_t* count) {
+    if (depth >= ABI_MAX_NESTING_DEPTH) {
+        ESP_LOGE(TAG, "ABI type nested deeper than %d levels", ABI_MAX_NESTING_DEPTH);
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+
+    sb_put(sb, "(", 1);
+    *count = 0;
+    if (params && params->type == ETH_JSON_ARRAY) {
+        const char* cursor = NULL;
+        eth_json_token_t param;
+        esp_err_t err;
+        while ((err = eth_json_array_next(params, &cursor, &param)) == ESP_OK) {
+            if (*count > 0) {
+                sb_put(sb, ",", 1);
+            }
+            err = append_type(sb, &param, depth);
+            if (err != ESP_OK) {
+                return err;
+            }
+            (*count)++;
+        }
+        if (err != ESP_ERR_NOT_FOUND) {
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+    } else if (params && params->type != ETH_JSON_NONE) {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    sb_put(sb, ")", 1);
+    return ESP_OK;
+}
+
+static bool entry_kind(const eth_json_token_t* type, abi_entry_kind_t* kind) {
+    if (eth_json_token_equals(type, "function")) {
+        *kind = ABI_ENTRY_FUNCTION;
+    } else if (eth_json_token_equals(type, "event")) {
+        *kind = ABI_ENTRY_EVENT;
+    } else if (eth_json_token_equals(type, "error")) {
+        *kind = ABI_ENTRY_ERROR;
+    } else {
+        return false;  // constructor / fallback / receive
+    }
+    return true;
+}
+
+// 扫描ABI数组。entries为NULL时只统计条目数和字符串长度
+static esp_err_t scan_abi(const eth_json_token_t* abi, abi_index_entry_t* entries, char* arena,
+                          size_t* entry_count, size_t* arena_len) {
+    str_builder_t sb = { .buf = arena, .len = 0 };
+    size_t n = 0;
+    const char* cursor = NULL;
+    eth_json_token_t item;
+    esp_err_t err;
+
+    while ((err = eth_json_array_next(abi, &cursor, &item)) == ESP_OK) {
+        eth_json_token_t type, name, inputs, outputs;
+        abi_entry_kind_t kind;
+        if (item.type != ETH_JSON_OBJECT ||
+            eth_json_object_get(&item, "type", &type) != ESP_OK) {
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+        if (!entry_kind(&type, &kind)) {
+            continue;
+        }
+        if (eth_json_object_get(&item, "name", &name) != ESP_OK || name.type != ETH_JSON_STRING) {
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+        eth_json_object_get(&item, "inputs", &inputs);
+        eth_json_object_get(&item, "outputs", &outputs);
+
+        // 名称、签名 (名称 + 输入类型)、输出类型依次存放，都以'\0'结尾
+        size_t name_pos = sb.len;
+        sb_put_token(&sb, &name);
+        sb_put(&sb, "", 1);
+        size_t sig_pos = sb.len;
+        sb_put_token(&sb, &name);
+        size_t input_count = 0;
+        if ((err = append_params(&sb, &inputs, 0, &input_count)) != ESP_OK) {
+            return err;
+        }
+        size_t sig_len = sb.len - sig_pos;
+        sb_put(&sb, "", 1);
+        size_t out_pos = sb.len;
+        size_t output_count = 0;
+        if ((err = append_params(&sb, kind == ABI_ENTRY_FUNCTION ? &outputs : NULL, 0, &output_count)) != ESP_OK) {
+            return err;
+        }
+        sb_put(&sb, "", 1);
+
+        if (input_count > UINT8_MAX || output_count > UINT8_MAX) {
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+
+        if (entries) {
+            abi_index_entry_t* entry = &entries[n];
+            entry->name = arena + name_pos;
+            entry->signature = arena + sig_pos;
+            entry->inputs = arena + sig_pos + name.len;
+            entry->outputs = arena + out_pos;
+            entry->kind = (uint8_t)kind;
+            entry->input_count = (uint8_t)input_count;
+            entry->output_count = (uint8_t)output_count;
+
+            uint8_t hash[ETH_KECCAK256_HASH_LEN];
+            eth_keccak256((const uint8_t*)entry->signature, sig_len, hash);
+            memcpy(entry->selector, hash, 4);
+        }
+        n++;
+    }
+
+    if (err != ESP_ERR_NOT_FOUND) {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    *entry_count = n;
+    *arena_len = sb.len;
+    return ESP_OK;
+}
+
+static uint32_t name_hash(const char* name) {
+    uint32_t hash = 2166136261u;
+    for (; *name; name++) {
+        hash ^= (uint8_t)*name;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t selector_hash(const uint8_t selector[4]) {
+    // 选择器本身就是哈希值，直接使用
+    return ((uint32_t)selector[0] << 24) | ((uint32_t)selector[1] << 16) |
+           ((uint32_t)selector[2] << 8) | selector[3];
+}
+
+static void table_insert(uint16_t* table, size_t table_size, uint32_t hash, size_t entry_index) {
+    size_t mask = table_size - 1;
+    size_t slot = hash & mask;
+    while (table[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    table[slot] = (uint16_t)(entry_index + 1);
+}
+
+esp_err_t abi_index_load(abi_index_t* index, const char* json, size_t len) {
+    if (!index || !json) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(index, 0, sizeof(*index));
+
+    // 编译产物是 {"abi":[...], "bytecode":...}，只取abi字段，字节码等其余部分不再扫描
+    eth_json_token_t root, abi;
+    if (eth_json_parse(json, len, &root) != ESP_OK) {
+        ESP_LOGE(TAG, "Invalid ABI JSON");
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    if (root.type == ETH_JSON_OBJECT) {
+        if (eth_json_object_get(&root, "abi", &abi) != ESP_OK) {
+            ESP_LOGE(TAG, "No 'abi' field in contract artifact");
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+    } else {
+        abi = root;
+    }
+    if (abi.type != ETH_JSON_ARRAY) {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+
+    size_t count = 0;
+    size_t arena_len = 0;
+    esp_err_t err = scan_abi(&abi, NULL, NULL, &count, &arena_len);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Malformed ABI entry");
+        return err;
+    }
+    if (count >= UINT16_MAX) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    // 哈希表负载不超过1/2
+    size_t table_size = 8;
+    while (table_size < count * 2) {
+        table_size <<= 1;
+    }
+
+    size_t entries_size = count * sizeof(abi_index_entry_t);
+    size_t tables_size = 2 * table_size * sizeof(uint16_t);
+    size_t total = entries_size + tables_size + arena_len;
+    uint8_t* mem = calloc(1, total);
+    if (!mem) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    abi_index_entry_t* entries = (abi_index_entry_t*)mem;
+    uint16_t* by_name = (uint16_t*)(mem + entries_size);
+    uint16_t* by_selector = by_name + table_size;
+    char* arena = (char*)(by_selector + table_size);
+
+    size_t filled = 0;
+    err = scan_abi(&abi, entries, arena, &filled, &arena_len);
+    if (err != ESP_OK || filled != count) {
+        free(mem);
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        table_insert(by_name, table_size, name_hash(entries[i].name), i);
+        table_insert(by_selector, table_size, selector_hash(entries[i].selector), i);
+    }
+
+    index->entries = entries;
+    index->count = count;
+    index->by_name = by_name;
+    index->by_selector = by_selector;
+    index->table_size = table_size;
+    index->memory_used = total;
+
+    ESP_LOGI(TAG, "ABI index: %d entries, %d bytes", (int)count, (int)total);
+    return ESP_OK;
+}
+
+const abi_index_entry_t* abi_index_find(const abi_index_t* index, abi_entry_kind_t kind, const char* name) {
+    if (!index || !index->entries || !name) {
+        return NULL;
+    }
+
+    // 同名的重载条目按插入顺序排在探测序列中，先遇到的是ABI中的第一个
+    size_t mask = index->table_size - 1;
+    for (size_t slot = name_hash(name) & mask; index->by_name[slot] != 0; slot = (slot + 1) & mask) {
+        const abi_index_entry_t* entry = &index->entries[index->by_name[slot] - 1];
+        if (entry->kind == kind && strcmp(entry->name, name) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+const abi_index_entry_t* abi_index_find_selector(const abi_index_t* index, abi_entry_kind_t kind,
+                                                 const uint8_t selector[4]) {
+    if (!index || !index->entries || !selector) {
+        return NULL;
+    }
+
+    size_t mask = index->table_size - 1;
+    for (size_t slot = selector_hash(selector) & mask; index->by_selector[slot] != 0; slot = (slot + 1) & mask) {
+        const abi_index_entry_t* entry = &index->entries[index->by_selector[slot] - 1];
+        if (entry->kind == kind && memcmp(entry->selector, selector, 4) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+void abi_index_free(abi_index_t* index) {
+    if (!index) {
+        return;
+    }
+    free(index->entries);  // 条目表、哈希表和字符串是同一块内存
+    memset(index, 0, sizeof(*index));
+}
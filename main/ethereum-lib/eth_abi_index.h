@@ -0,0 +1,93 @@
+/*
+    合约ABI索引
+
+    直接在ABI JSON (可以是flash中嵌入的原始文件) 上扫描一次，生成紧凑的
+    函数/事件/错误表，不构建cJSON树。每个条目包含名称、规范签名、选择器
+    以及输入/输出类型描述，类型描述可以直接传给abi_decode。
+
+    abi_index_t index;
+    abi_index_load(&index, json, json_len);
+    const abi_index_entry_t* fn = abi_index_find(&index, ABI_ENTRY_FUNCTION, "addFarm");
+    // fn->signature = "addFarm((uint256,uint256))", fn->inputs = "((uint256,uint256))"
+
+    按名称或选择器查找都是哈希表查找，耗时与条目数无关。
+
+*/
+
+#ifndef ETH_ABI_INDEX_H
+#define ETH_ABI_INDEX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <esp_err.h>
+
+/**
+ * @brief ABI条目类型
+ */
+typedef enum {
+    ABI_ENTRY_FUNCTION,
+    ABI_ENTRY_EVENT,
+    ABI_ENTRY_ERROR,
+} abi_entry_kind_t;
+
+/**
+ * @brief ABI索引中的一个条目，字符串都存放在索引自己的内存中
+ */
+typedef struct {
+    const char* name;        // 名称，如 "addFarm"
+    const char* signature;   // 规范签名，如 "addFarm((uint256,uint256))"
+    const char* inputs;      // 输入类型元组，如 "((uint256,uint256))" (指向signature中名称之后的部分)
+    const char* outputs;     // 输出类型元组，如 "(string)"，没有输出时为 "()"
+    uint8_t selector[4];     // 签名Keccak256的前4字节 (事件为topic0的前4字节)
+    uint8_t kind;            // abi_entry_kind_t
+    uint8_t input_count;     // 输入参数个数
+    uint8_t output_count;    // 输出值个数
+} abi_index_entry_t;
+
+/**
+ * @brief ABI索引
+ */
+typedef struct {
+    abi_index_entry_t* entries;  // 条目表
+    size_t count;                // 条目数
+    uint16_t* by_name;           // 按名称的开放寻址哈希表 (存条目下标+1，0为空)
+    uint16_t* by_selector;       // 按选择器的开放寻址哈希表
+    size_t table_size;           // 哈希表大小 (2的幂)
+    size_t memory_used;          // 索引占用的内存字节数
+} abi_index_t;
+
+/**
+ * @brief 扫描ABI JSON并建立索引
+ *
+ * 接受ABI数组本身，或者Hardhat/Foundry编译产物 (含"abi"字段的对象)。
+ * 构造函数、fallback和receive条目会被跳过。条目表和所有字符串一次分配。
+ *
+ * @param index 输出的索引
+ * @param json ABI JSON文本 (不要求以'\0'结尾，加载后不再引用)
+ * @param len 文本长度
+ * @return esp_err_t ESP_OK成功，JSON格式错误返回ESP_ERR_INVALID_RESPONSE，
+ *         内存不足返回ESP_ERR_NO_MEM
+ */
+esp_err_t abi_index_load(abi_index_t* index, const char* json, size_t len);
+
+/**
+ * @brief 按名称查找条目 (重载函数返回ABI中的第一个)
+ *
+ * @return const abi_index_entry_t* 未找到返回NULL
+ */
+const abi_index_entry_t* abi_index_find(const abi_index_t* index, abi_entry_kind_t kind, const char* name);
+
+/**
+ * @brief 按选择器查找条目 (如根据调用数据或日志topic0识别函数/事件)
+ *
+ * @return const abi_index_entry_t* 未找到返回NULL
+ */
+const abi_index_entry_t* abi_index_find_selector(const abi_index_t* index, abi_entry_kind_t kind,
+                                                 const uint8_t selector[4]);
+
+/**
+ * @brief 释放索引
+ */
+void abi_index_free(abi_index_t* index);
+
+#endif /* ETH_ABI_INDEX_H */
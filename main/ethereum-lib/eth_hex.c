@@ -0,0 +1,103 @@
+#include "eth_hex.h"
+#include <string.h>
+
+// 每个字节对应的两个十六进制字符，编码时一次查表取出一对
+static const char hex_pairs[513] =
+    "000102030405060708090a0b0c0d0e0f"
+    "101112131415161718191a1b1c1d1e1f"
+    "202122232425262728292a2b2c2d2e2f"
+    "303132333435363738393a3b3c3d3e3f"
+    "404142434445464748494a4b4c4d4e4f"
+    "505152535455565758595a5b5c5d5e5f"
+    "606162636465666768696a6b6c6d6e6f"
+    "707172737475767778797a7b7c7d7e7f"
+    "808182838485868788898a8b8c8d8e8f"
+    "909192939495969798999a9b9c9d9e9f"
+    "a0a1a2a3a4a5a6a7a8a9aaabacadaeaf"
+    "b0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+    "c0c1c2c3c4c5c6c7c8c9cacbcccdcecf"
+    "d0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+    "e0e1e2e3e4e5e6e7e8e9eaebecedeeef"
+    "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+// 字符到半字节的映射，非十六进制字符为0xFF
+const uint8_t eth_hex_nibble_table[256] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+       0,    1,    2,    3,    4,    5,    6,    7,    8,    9, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff,   10,   11,   12,   13,   14,   15, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff,   10,   11,   12,   13,   14,   15, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
+
+void eth_hex_encode_raw(const uint8_t* bin, size_t bin_len, char* hex) {
+    for (size_t i = 0; i < bin_len; i++) {
+        memcpy(hex + 2 * i, hex_pairs + 2 * bin[i], 2);
+    }
+}
+
+bool eth_hex_decode_raw(const char* hex, size_t bin_len, uint8_t* bin) {
+    // 循环内不分支: 非法字符的0xFF累积到bad中，最后统一检查
+    uint8_t bad = 0;
+    for (size_t i = 0; i < bin_len; i++) {
+        uint8_t hi = eth_hex_nibble_table[(uint8_t)hex[2 * i]];
+        uint8_t lo = eth_hex_nibble_table[(uint8_t)hex[2 * i + 1]];
+        bad |= hi | lo;
+        bin[i] = (uint8_t)((hi << 4) | (lo & 0x0F));
+    }
+    return (bad & 0xF0) == 0;
+}
+
+esp_err_t eth_hex_encode(const uint8_t* bin, size_t bin_len, char* hex, size_t hex_len, bool with_prefix) {
+    if ((!bin && bin_len > 0) || !hex) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t prefix_len = with_prefix ? 2 : 0;
+    if (hex_len < prefix_len + bin_len * 2 + 1) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    if (with_prefix) {
+        hex[0] = '0';
+        hex[1] = 'x';
+    }
+    eth_hex_encode_raw(bin, bin_len, hex + prefix_len);
+    hex[prefix_len + bin_len * 2] = '\0';
+    return ESP_OK;
+}
+
+esp_err_t eth_hex_decode(const char* hex, size_t hex_len, uint8_t* bin, size_t bin_len, size_t* bytes_written) {
+    if (!hex || (!bin && bin_len > 0) || !bytes_written) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *bytes_written = 0;
+
+    if (hex_len >= 2 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) {
+        hex += 2;
+        hex_len -= 2;
+    }
+    if (hex_len % 2 != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (bin_len < hex_len / 2) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (!eth_hex_decode_raw(hex, hex_len / 2, bin)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *bytes_written = hex_len / 2;
+    return ESP_OK;
+}
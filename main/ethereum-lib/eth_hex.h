@@ -0,0 +1,85 @@
+/*
+    十六进制编解码
+
+    全库共用的查表实现，替代逐字节的 sprintf("%02x") / sscanf("%02x")。
+    编码每个字节查一次表写出两个字符；解码每个字符查一次表，循环内
+    没有分支，非法字符在结束时统一报告。
+
+    eth_hex_encode / eth_hex_decode 处理"0x"前缀、长度检查和结尾的'\0'；
+    *_raw 版本只做转换，供已知长度的热路径 (如流式解码) 使用。
+
+*/
+
+#ifndef ETH_HEX_H
+#define ETH_HEX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <esp_err.h>
+
+// 编码n字节所需的缓冲区大小 ("0x" + 2n个字符 + '\0')
+#define ETH_HEX_ENCODED_LEN(n) ((n) * 2 + 3)
+
+// 字符到半字节的映射表，非十六进制字符为0xFF
+extern const uint8_t eth_hex_nibble_table[256];
+
+/**
+ * @brief 单个十六进制字符的值
+ *
+ * @return int 0-15，非十六进制字符返回-1
+ */
+static inline int eth_hex_nibble(char c) {
+    uint8_t v = eth_hex_nibble_table[(uint8_t)c];
+    return v == 0xFF ? -1 : v;
+}
+
+/**
+ * @brief 将二进制数据编码为小写十六进制字符 (不加前缀，不写'\0')
+ *
+ * @param bin 二进制数据
+ * @param bin_len 数据长度
+ * @param hex 输出缓冲区，至少2 * bin_len字节
+ */
+void eth_hex_encode_raw(const uint8_t* bin, size_t bin_len, char* hex);
+
+/**
+ * @brief 将2 * bin_len个十六进制字符解码为二进制 (不处理前缀)
+ *
+ * 大小写均可。返回false时bin中的内容无意义。
+ *
+ * @param hex 十六进制字符
+ * @param bin_len 输出字节数
+ * @param bin 输出缓冲区
+ * @return bool 全部字符合法返回true
+ */
+bool eth_hex_decode_raw(const char* hex, size_t bin_len, uint8_t* bin);
+
+/**
+ * @brief 将二进制数据编码为以'\0'结尾的十六进制字符串
+ *
+ * @param bin 二进制数据
+ * @param bin_len 数据长度
+ * @param hex 输出缓冲区
+ * @param hex_len 缓冲区大小
+ * @param with_prefix 是否添加"0x"前缀
+ * @return esp_err_t ESP_OK成功，缓冲区不足返回ESP_ERR_INVALID_SIZE
+ */
+esp_err_t eth_hex_encode(const uint8_t* bin, size_t bin_len, char* hex, size_t hex_len, bool with_prefix);
+
+/**
+ * @brief 将十六进制字符串解码为二进制数据
+ *
+ * 可以带"0x"/"0X"前缀，长度必须为偶数。
+ *
+ * @param hex 十六进制字符串 (不要求以'\0'结尾)
+ * @param hex_len 字符串长度 (包括前缀)
+ * @param bin 输出缓冲区
+ * @param bin_len 缓冲区大小
+ * @param bytes_written 实际写入的字节数
+ * @return esp_err_t ESP_OK成功，长度为奇数或含非法字符返回ESP_ERR_INVALID_ARG，
+ *         缓冲区不足返回ESP_ERR_INVALID_SIZE
+ */
+esp_err_t eth_hex_decode(const char* hex, size_t hex_len, uint8_t* bin, size_t bin_len, size_t* bytes_written);
+
+#endif /* ETH_HEX_H */
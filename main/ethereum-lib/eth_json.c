@@ -0,0 +1,598 @@
+#include "eth_json.h"
+#include "eth_hex.h"
+#include <string.h>
+
+// 对象/数组允许的最大嵌套深度 (用位栈记录括号类型)
+#define ETH_JSON_MAX_DEPTH 64
+
+static const char* skip_ws(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) {
+        p++;
+    }
+    return p;
+}
+
+// p指向开头的引号，返回闭合引号之后的位置
+static const char* scan_string(const char* p, const char* end) {
+    for (p++; p < end; p++) {
+        if (*p == '\\') {
+            p++;
+        } else if (*p == '"') {
+            return p + 1;
+        } else if ((unsigned char)*p < 0x20) {
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+// 跳过对象或数组，不递归: 用位栈记录每一层是 '{' 还是 '['
+static const char* scan_container(const char* p, const char* end) {
+    uint64_t stack = 0;
+    int depth = 0;
+
+    while (p < end) {
+        char c = *p;
+        if (c == '"') {
+            p = scan_string(p, end);
+            if (!p) {
+                return NULL;
+            }
+            continue;
+        }
+        if (c == '{' || c == '[') {
+            if (depth == ETH_JSON_MAX_DEPTH) {
+                return NULL;
+            }
+            stack = (stack << 1) | (c == '{');
+            depth++;
+        } else if (c == '}' || c == ']') {
+            if (depth == 0 || (stack & 1) != (c == '}')) {
+                return NULL;
+            }
+            stack >>= 1;
+            if (--depth == 0) {
+                return p + 1;
+            }
+        }
+        p++;
+    }
+    return NULL;
+}
+
+static const char* scan_literal(const char* p, const char* end, const char* literal) {
+    size_t len = strlen(literal);
+    if ((size_t)(end - p) < len || memcmp(p, literal, len) != 0) {
+        return NULL;
+    }
+    return p + len;
+}
+
+// 识别p处的值并返回其后的位置，失败返回NULL
+static const char* scan_value(const char* p, const char* end, eth_json_token_t* token) {
+    const char* next = NULL;
+
+    p = skip_ws(p, end);
+    if (p >= end) {
+        return NULL;
+    }
+
+    switch (*p) {
+        case '"':
+            next = scan_string(p, end);
+            if (next) {
+                token->type = ETH_JSON_STRING;
+                token->start = p + 1;
+                token->len = (size_t)(next - p) - 2;
+            }
+            return next;
+        case '{':
+        case '[':
+            token->type = *p == '{' ? ETH_JSON_OBJECT : ETH_JSON_ARRAY;
+            next = scan_container(p, end);
+            break;
+        case 't':
+            token->type = ETH_JSON_TRUE;
+            next = scan_literal(p, end, "true");
+            break;
+        case 'f':
+            token->type = ETH_JSON_FALSE;
+            next = scan_literal(p, end, "false");
+            break;
+        case 'n':
+            token->type = ETH_JSON_NULL;
+            next = scan_literal(p, end, "null");
+            break;
+        default:
+            if (*p != '-' && (*p < '0' || *p > '9')) {
+                return NULL;
+            }
+            token->type = ETH_JSON_NUMBER;
+            next = p + 1;
+            while (next < end && ((*next >= '0' && *next <= '9') || *next == '.' ||
+                                  *next == 'e' || *next == 'E' || *next == '+' || *next == '-')) {
+                next++;
+            }
+            break;
+    }
+
+    if (next) {
+        token->start = p;
+        token->len = (size_t)(next - p);
+    }
+    return next;
+}
+
+// 取对象的下一个键值对。*pp为当前位置，返回1取得一对，0对象结束，-1格式错误
+static int object_next(const char** pp, const char* end, eth_json_token_t* key, eth_json_token_t* value) {
+    const char* p = skip_ws(*pp, end);
+    if (p < end && *p == ',') {
+        p = skip_ws(p + 1, end);
+    }
+    if (p >= end) {
+        return -1;
+    }
+    if (*p == '}') {
+        *pp = p + 1;
+        return 0;
+    }
+    if (*p != '"') {
+        return -1;
+    }
+
+    p = scan_value(p, end, key);
+    if (!p) {
+        return -1;
+    }
+    p = skip_ws(p, end);
+    if (p >= end || *p != ':') {
+        return -1;
+    }
+    p = scan_value(p + 1, end, value);
+    if (!p) {
+        return -1;
+    }
+
+    *pp = p;
+    return 1;
+}
+
+bool eth_json_token_equals(const eth_json_token_t* token, const char* str) {
+    size_t len = strlen(str);
+    return token->type == ETH_JSON_STRING && token->len == len && memcmp(token->start, str, len) == 0;
+}
+
+static int64_t parse_int64(const eth_json_token_t* token) {
+    const char* p = token->start;
+    const char* end = p + token->len;
+    bool negative = false;
+    int64_t value = 0;
+
+    if (p < end && *p == '-') {
+        negative = true;
+        p++;
+    }
+    for (; p < end && *p >= '0' && *p <= '9'; p++) {
+        value = value * 10 + (*p - '0');
+    }
+    return negative ? -value : value;
+}
+
+esp_err_t eth_json_parse(const char* json, size_t len, eth_json_token_t* root) {
+    if (!json || !root) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(root, 0, sizeof(*root));
+    return scan_value(json, json + len, root) ? ESP_OK : ESP_ERR_INVALID_RESPONSE;
+}
+
+// 严格校验的字符串: 只允许合法的转义，返回闭合引号之后的位置
+static const char* validate_string(const char* p, const char* end) {
+    for (p++; p < end; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c == '"') {
+            return p + 1;
+        }
+        if (c < 0x20) {
+            return NULL;
+        }
+        if (c != '\\') {
+            continue;
+        }
+        if (++p >= end) {
+            return NULL;
+        }
+        if (*p == 'u') {
+            if (end - p < 5) {
+                return NULL;
+            }
+            for (int i = 1; i <= 4; i++) {
+                if (eth_hex_nibble(p[i]) < 0) {
+                    return NULL;
+                }
+            }
+            p += 4;
+        } else if (*p == '\0' || !strchr("\"\\/bfnrt", *p)) {
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+static const char* validate_digits(const char* p, const char* end) {
+    const char* start = p;
+    while (p < end && *p >= '0' && *p <= '9') {
+        p++;
+    }
+    return p > start ? p : NULL;
+}
+
+// -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+static const char* validate_number(const char* p, const char* end) {
+    if (p < end && *p == '-') {
+        p++;
+    }
+    if (p < end && *p == '0') {
+        p++;
+    } else if (!(p = validate_digits(p, end))) {
+        return NULL;
+    }
+    if (p < end && *p == '.' && !(p = validate_digits(p + 1, end))) {
+        return NULL;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        if (p < end && (*p == '+' || *p == '-')) {
+            p++;
+        }
+        p = validate_digits(p, end);
+    }
+    return p;
+}
+
+// 对象中的 "键" :
+static const char* validate_key(const char* p, const char* end) {
+    p = skip_ws(p, end);
+    if (p >= end || *p != '"' || !(p = validate_string(p, end))) {
+        return NULL;
+    }
+    p = skip_ws(p, end);
+    return p < end && *p == ':' ? p + 1 : NULL;
+}
+
+esp_err_t eth_json_validate(const char* json, size_t len) {
+    if (!json) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const char* p = json;
+    const char* end = json + len;
+    uint64_t stack = 0;
+    int depth = 0;
+
+    for (;;) {
+        // 此处需要一个值
+        p = skip_ws(p, end);
+        if (p >= end) {
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+        if (*p == '{' || *p == '[') {
+            bool is_object = *p == '{';
+            if (depth == ETH_JSON_MAX_DEPTH) {
+                return ESP_ERR_INVALID_RESPONSE;
+            }
+            stack = (stack << 1) | is_object;
+            depth++;
+            p = skip_ws(p + 1, end);
+            if (p < end && *p == (is_object ? '}' : ']')) {
+                stack >>= 1;
+                depth--;
+                p++;
+            } else {
+                if (is_object && !(p = validate_key(p, end))) {
+                    return ESP_ERR_INVALID_RESPONSE;
+                }
+                continue;
+            }
+        } else {
+            switch (*p) {
+                case '"': p = validate_string(p, end); break;
+                case 't': p = scan_literal(p, end, "true"); break;
+                case 'f': p = scan_literal(p, end, "false"); break;
+                case 'n': p = scan_literal(p, end, "null"); break;
+                default:  p = validate_number(p, end); break;
+            }
+            if (!p) {
+                return ESP_ERR_INVALID_RESPONSE;
+            }
+        }
+
+        // 值之后: ','继续当前层，闭合括号退出一层，顶层值之后只允许空白
+        for (;;) {
+            p = skip_ws(p, end);
+            if (depth == 0) {
+                return p == end ? ESP_OK : ESP_ERR_INVALID_RESPONSE;
+            }
+            if (p >= end) {
+                return ESP_ERR_INVALID_RESPONSE;
+            }
+            if (*p == ((stack & 1) ? '}' : ']')) {
+                stack >>= 1;
+                depth--;
+                p++;
+                continue;
+            }
+            if (*p != ',') {
+                return ESP_ERR_INVALID_RESPONSE;
+            }
+            p++;
+            if ((stack & 1) && !(p = validate_key(p, end))) {
+                return ESP_ERR_INVALID_RESPONSE;
+            }
+            break;
+        }
+    }
+}
+
+esp_err_t eth_json_parse_response(const char* json, size_t len, eth_rpc_response_t* resp) {
+    if (!json || !resp) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(resp, 0, sizeof(*resp));
+
+    const char* end = json + len;
+    const char* p = skip_ws(json, end);
+    if (p >= end || *p != '{') {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    p++;
+
+    eth_json_token_t key, value;
+    int ret;
+    while ((ret = object_next(&p, end, &key, &value)) == 1) {
+        if (eth_json_token_equals(&key, "result")) {
+            resp->result = value;
+        } else if (eth_json_token_equals(&key, "id")) {
+            resp->id = value;
+        } else if (eth_json_token_equals(&key, "error")) {
+            resp->error = value;
+        }
+    }
+    if (ret < 0) {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+
+    if (resp->error.type == ETH_JSON_OBJECT) {
+        eth_json_token_t code;
+        if (eth_json_object_get(&resp->error, "code", &code) == ESP_OK && code.type == ETH_JSON_NUMBER) {
+            resp->error_code = parse_int64(&code);
+        }
+        eth_json_object_get(&resp->error, "message", &resp->error_message);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t eth_json_object_get(const eth_json_token_t* object, const char* key, eth_json_token_t* value) {
+    if (!object || !key || !value) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(value, 0, sizeof(*value));
+    if (object->type != ETH_JSON_OBJECT) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    const char* p = object->start + 1;
+    const char* end = object->start + object->len;
+    eth_json_token_t k, v;
+    int ret;
+    while ((ret = object_next(&p, end, &k, &v)) == 1) {
+        if (eth_json_token_equals(&k, key)) {
+            *value = v;
+            return ESP_OK;
+        }
+    }
+    return ret < 0 ? ESP_ERR_INVALID_RESPONSE : ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t eth_json_array_next(const eth_json_token_t* array, const char** cursor, eth_json_token_t* element) {
+    if (!array || !cursor || !element || array->type != ETH_JSON_ARRAY) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const char* end = array->start + array->len;
+    const char* p = *cursor ? *cursor : array->start + 1;
+
+    p = skip_ws(p, end);
+    if (p < end && *p == ',') {
+        p++;
+    }
+    p = skip_ws(p, end);
+    if (p >= end) {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    if (*p == ']') {
+        *cursor = p;
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    p = scan_value(p, end, element);
+    if (!p) {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    *cursor = p;
+    return ESP_OK;
+}
+
+static bool read_u16_escape(const char* p, const char* end, uint32_t* cp) {
+    if (end - p < 4) {
+        return false;
+    }
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) {
+        int n = eth_hex_nibble(p[i]);
+        if (n < 0) {
+            return false;
+        }
+        v = (v << 4) | (uint32_t)n;
+    }
+    *cp = v;
+    return true;
+}
+
+// 将码点编码为UTF-8，返回字节数
+static size_t utf8_encode(uint32_t cp, char out[4]) {
+    if (cp < 0x80) {
+        out[0] = (char)cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = (char)(0xc0 | (cp >> 6));
+        out[1] = (char)(0x80 | (cp & 0x3f));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = (char)(0xe0 | (cp >> 12));
+        out[1] = (char)(0x80 | ((cp >> 6) & 0x3f));
+        out[2] = (char)(0x80 | (cp & 0x3f));
+        return 3;
+    }
+    out[0] = (char)(0xf0 | (cp >> 18));
+    out[1] = (char)(0x80 | ((cp >> 12) & 0x3f));
+    out[2] = (char)(0x80 | ((cp >> 6) & 0x3f));
+    out[3] = (char)(0x80 | (cp & 0x3f));
+    return 4;
+}
+
+esp_err_t eth_json_token_copy_string(const eth_json_token_t* token, char* out, size_t out_len) {
+    if (!token || !out || out_len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (token->type != ETH_JSON_STRING) {
+        out[0] = '\0';
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const char* p = token->start;
+    const char* end = p + token->len;
+    size_t n = 0;
+
+    // 没有转义时直接整段复制 (十六进制数据的常见情况)
+    if (!memchr(p, '\\', token->len)) {
+        size_t copy = token->len < out_len - 1 ? token->len : out_len - 1;
+        memcpy(out, p, copy);
+        out[copy] = '\0';
+        return copy == token->len ? ESP_OK : ESP_ERR_INVALID_SIZE;
+    }
+
+    while (p < end) {
+        char buf[4];
+        size_t len = 1;
+
+        if (*p != '\\') {
+            buf[0] = *p++;
+        } else {
+            p++;
+            if (p >= end) {
+                break;
+            }
+            char c = *p++;
+            switch (c) {
+                case 'b': buf[0] = '\b'; break;
+                case 'f': buf[0] = '\f'; break;
+                case 'n': buf[0] = '\n'; break;
+                case 'r': buf[0] = '\r'; break;
+                case 't': buf[0] = '\t'; break;
+                case 'u': {
+                    uint32_t cp;
+                    if (!read_u16_escape(p, end, &cp)) {
+                        out[n] = '\0';
+                        return ESP_ERR_INVALID_RESPONSE;
+                    }
+                    p += 4;
+                    // UTF-16代理对
+                    uint32_t low;
+                    if (cp >= 0xd800 && cp < 0xdc00 && end - p >= 6 && p[0] == '\\' && p[1] == 'u' &&
+                        read_u16_escape(p + 2, end, &low) && low >= 0xdc00 && low < 0xe000) {
+                        cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+                        p += 6;
+                    }
+                    len = utf8_encode(cp, buf);
+                    break;
+                }
+                default: buf[0] = c; break;  // \" \\ \/
+            }
+        }
+
+        if (n + len > out_len - 1) {
+            out[n] = '\0';
+            return ESP_ERR_INVALID_SIZE;
+        }
+        memcpy(out + n, buf, len);
+        n += len;
+    }
+
+    out[n] = '\0';
+    return ESP_OK;
+}
+
+esp_err_t eth_json_token_copy_raw(const eth_json_token_t* token, char* out, size_t out_len) {
+    if (!token || !out || out_len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t copy = token->len < out_len - 1 ? token->len : out_len - 1;
+    if (copy > 0) {
+        memcpy(out, token->start, copy);
+    }
+    out[copy] = '\0';
+    return copy == token->len ? ESP_OK : ESP_ERR_INVALID_SIZE;
+}
+
+esp_err_t eth_json_token_to_uint64(const eth_json_token_t* token, uint64_t* value) {
+    if (!token || !value) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const char* p = token->start;
+    const char* end = p + token->len;
+    uint64_t v = 0;
+
+    if (token->type == ETH_JSON_STRING) {
+        if (token->len < 3 || p[0] != '0' || (p[1] != 'x' && p[1] != 'X')) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        for (p += 2; p < end; p++) {
+            int n = eth_hex_nibble(*p);
+            if (n < 0) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            if (v >> 60) {
+                return ESP_ERR_INVALID_SIZE;
+            }
+            v = (v << 4) | (uint64_t)n;
+        }
+    } else if (token->type == ETH_JSON_NUMBER) {
+        if (p == end) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        for (; p < end; p++) {
+            if (*p < '0' || *p > '9') {
+                return ESP_ERR_INVALID_ARG;
+            }
+            uint64_t digit = (uint64_t)(*p - '0');
+            if (v > (UINT64_MAX - digit) / 10) {
+                return ESP_ERR_INVALID_SIZE;
+            }
+            v = v * 10 + digit;
+        }
+    } else {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *value = v;
+    return ESP_OK;
+}
@@ -0,0 +1,150 @@
+/*
+    JSON-RPC 响应的流式解析
+
+    直接在接收缓冲区上扫描，只记录 id / result / error 各自的位置和长度，
+    不构建cJSON树，也不做任何堆分配。字符串在需要时再解码 (处理转义)
+    到调用者提供的缓冲区中。
+
+    eth_rpc_response_t resp;
+    if (eth_json_parse_response(buf, len, &resp) == ESP_OK && resp.result.type == ETH_JSON_STRING) {
+        eth_json_token_copy_string(&resp.result, out, sizeof(out));
+    }
+
+    token指向原始缓冲区，缓冲区释放或复用后token随之失效。
+
+*/
+
+#ifndef ETH_JSON_H
+#define ETH_JSON_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <esp_err.h>
+
+/**
+ * @brief JSON值的类型
+ */
+typedef enum {
+    ETH_JSON_NONE = 0,   // 字段不存在
+    ETH_JSON_STRING,
+    ETH_JSON_NUMBER,
+    ETH_JSON_OBJECT,
+    ETH_JSON_ARRAY,
+    ETH_JSON_TRUE,
+    ETH_JSON_FALSE,
+    ETH_JSON_NULL,
+} eth_json_type_t;
+
+/**
+ * @brief 指向原始缓冲区中的一个JSON值
+ *
+ * 字符串类型的start/len不包含两侧引号，且未做转义解码；
+ * 其他类型覆盖值的完整文本 (对象和数组包含括号)。
+ */
+typedef struct {
+    const char* start;
+    size_t len;
+    eth_json_type_t type;
+} eth_json_token_t;
+
+/**
+ * @brief 解析后的JSON-RPC响应
+ */
+typedef struct {
+    eth_json_token_t id;             // 请求ID
+    eth_json_token_t result;         // result字段，不存在时type为ETH_JSON_NONE
+    eth_json_token_t error;          // error对象，不存在时type为ETH_JSON_NONE
+    int64_t error_code;              // error.code
+    eth_json_token_t error_message;  // error.message
+} eth_rpc_response_t;
+
+/**
+ * @brief 定位缓冲区中的顶层JSON值 (例如批量响应的数组)
+ *
+ * @param json JSON文本 (不要求以'\0'结尾)
+ * @param len 文本长度
+ * @param root 输出的顶层值
+ * @return esp_err_t ESP_OK成功，格式错误返回ESP_ERR_INVALID_RESPONSE
+ */
+esp_err_t eth_json_parse(const char* json, size_t len, eth_json_token_t* root);
+
+/**
+ * @brief 严格校验文本是否恰好是一个合法的JSON值
+ *
+ * 与eth_json_parse只定位括号不同，这里检查完整的语法 (字符串转义、数字格式、
+ * 逗号和冒号)，值之后只允许空白。用于拼接进请求信封之前的调用者输入。
+ *
+ * @param json JSON文本 (不要求以'\0'结尾)
+ * @param len 文本长度
+ * @return esp_err_t ESP_OK合法，格式错误返回ESP_ERR_INVALID_RESPONSE
+ */
+esp_err_t eth_json_validate(const char* json, size_t len);
+
+/**
+ * @brief 解析单个JSON-RPC响应对象
+ *
+ * @param json 响应文本 (不要求以'\0'结尾)
+ * @param len 响应长度
+ * @param resp 输出的解析结果
+ * @return esp_err_t ESP_OK成功，格式错误返回ESP_ERR_INVALID_RESPONSE
+ */
+esp_err_t eth_json_parse_response(const char* json, size_t len, eth_rpc_response_t* resp);
+
+/**
+ * @brief 在对象中查找指定键的值 (只查找第一层)
+ *
+ * @param object 对象类型的token
+ * @param key 键名
+ * @param value 输出的值，未找到时type为ETH_JSON_NONE
+ * @return esp_err_t ESP_OK找到，ESP_ERR_NOT_FOUND未找到，ESP_ERR_INVALID_RESPONSE格式错误
+ */
+esp_err_t eth_json_object_get(const eth_json_token_t* object, const char* key, eth_json_token_t* value);
+
+/**
+ * @brief 遍历数组元素
+ *
+ * cursor首次调用前置为NULL，每次调用返回下一个元素。
+ *
+ * @param array 数组类型的token
+ * @param cursor 遍历位置
+ * @param element 输出的元素
+ * @return esp_err_t ESP_OK取得元素，ESP_ERR_NOT_FOUND已遍历完，ESP_ERR_INVALID_RESPONSE格式错误
+ */
+esp_err_t eth_json_array_next(const eth_json_token_t* array, const char** cursor, eth_json_token_t* element);
+
+/**
+ * @brief 将字符串token解码 (处理转义) 后复制到输出缓冲区
+ *
+ * @param token 字符串类型的token
+ * @param out 输出缓冲区，总是以'\0'结尾
+ * @param out_len 缓冲区大小
+ * @return esp_err_t ESP_OK成功，缓冲区不足返回ESP_ERR_INVALID_SIZE (输出被截断)
+ */
+esp_err_t eth_json_token_copy_string(const eth_json_token_t* token, char* out, size_t out_len);
+
+/**
+ * @brief 将token的原始文本复制到输出缓冲区 (对象/数组/布尔值等)
+ *
+ * @param token 任意类型的token
+ * @param out 输出缓冲区，总是以'\0'结尾
+ * @param out_len 缓冲区大小
+ * @return esp_err_t ESP_OK成功，缓冲区不足返回ESP_ERR_INVALID_SIZE (输出被截断)
+ */
+esp_err_t eth_json_token_copy_raw(const eth_json_token_t* token, char* out, size_t out_len);
+
+/**
+ * @brief 将十六进制字符串 ("0x1a") 或十进制数字token转换为uint64
+ *
+ * @param token 字符串或数字类型的token
+ * @param value 输出值
+ * @return esp_err_t ESP_OK成功，溢出返回ESP_ERR_INVALID_SIZE，格式错误返回ESP_ERR_INVALID_ARG
+ */
+esp_err_t eth_json_token_to_uint64(const eth_json_token_t* token, uint64_t* value);
+
+/**
+ * @brief 比较字符串token与普通C字符串 (不解码转义)
+ */
+bool eth_json_token_equals(const eth_json_token_t* token, const char* str);
+
+#endif /* ETH_JSON_H */
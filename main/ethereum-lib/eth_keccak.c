@@ -0,0 +1,130 @@
+#include "eth_keccak.h"
+#include <string.h>
+
+#define KECCAK_ROUNDS 24
+#define ROTL64(x, n) (((x) << (n)) | ((x) >> (64 - (n))))
+
+static const uint64_t keccak_round_constants[KECCAK_ROUNDS] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
+    0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
+    0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+    0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+// rho步骤的循环移位量，按pi步骤的置换顺序排列
+static const uint8_t keccak_rho[24] = {
+    1,  3,  6,  10, 15, 21, 28, 36, 45, 55, 2,  14,
+    27, 41, 56, 8,  25, 43, 62, 18, 39, 61, 20, 44
+};
+
+static const uint8_t keccak_pi[24] = {
+    10, 7,  11, 17, 18, 3, 5,  16, 8,  21, 24, 4,
+    15, 23, 19, 13, 12, 2, 20, 14, 22, 9,  6,  1
+};
+
+// Keccak-f[1600] 置换
+static void keccak_f1600(uint64_t st[25]) {
+    uint64_t bc[5];
+
+    for (int round = 0; round < KECCAK_ROUNDS; round++) {
+        // theta
+        for (int i = 0; i < 5; i++) {
+            bc[i] = st[i] ^ st[i + 5] ^ st[i + 10] ^ st[i + 15] ^ st[i + 20];
+        }
+        for (int i = 0; i < 5; i++) {
+            uint64_t t = bc[(i + 4) % 5] ^ ROTL64(bc[(i + 1) % 5], 1);
+            st[i] ^= t;
+            st[i + 5] ^= t;
+            st[i + 10] ^= t;
+            st[i + 15] ^= t;
+            st[i + 20] ^= t;
+        }
+
+        // rho + pi
+        uint64_t t = st[1];
+        for (int i = 0; i < 24; i++) {
+            int j = keccak_pi[i];
+            uint64_t tmp = st[j];
+            st[j] = ROTL64(t, keccak_rho[i]);
+            t = tmp;
+        }
+
+        // chi
+        for (int j = 0; j < 25; j += 5) {
+            for (int i = 0; i < 5; i++) {
+                bc[i] = st[j + i];
+            }
+            for (int i = 0; i < 5; i++) {
+                st[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
+            }
+        }
+
+        // iota
+        st[0] ^= keccak_round_constants[round];
+    }
+}
+
+// 小端读取64位 (Keccak状态按小端序排列)
+static inline uint64_t load64_le(const uint8_t* p) {
+    return (uint64_t)p[0]         | ((uint64_t)p[1] << 8)  |
+           ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24) |
+           ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) |
+           ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+}
+
+void eth_keccak256_init(eth_keccak256_ctx_t* ctx) {
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+void eth_keccak256_update(eth_keccak256_ctx_t* ctx, const uint8_t* data, size_t len) {
+    // 先补齐上次未满的块
+    while (len > 0 && ctx->pos != 0) {
+        ctx->state[ctx->pos / 8] ^= (uint64_t)(*data++) << (8 * (ctx->pos % 8));
+        len--;
+        if (++ctx->pos == ETH_KECCAK256_RATE) {
+            keccak_f1600(ctx->state);
+            ctx->pos = 0;
+        }
+    }
+
+    // 整块按64位吸收
+    while (len >= ETH_KECCAK256_RATE) {
+        for (int i = 0; i < ETH_KECCAK256_RATE / 8; i++) {
+            ctx->state[i] ^= load64_le(data + i * 8);
+        }
+        keccak_f1600(ctx->state);
+        data += ETH_KECCAK256_RATE;
+        len -= ETH_KECCAK256_RATE;
+    }
+
+    // 剩余字节留到下次
+    while (len > 0) {
+        ctx->state[ctx->pos / 8] ^= (uint64_t)(*data++) << (8 * (ctx->pos % 8));
+        ctx->pos++;
+        len--;
+    }
+}
+
+void eth_keccak256_final(eth_keccak256_ctx_t* ctx, uint8_t hash[ETH_KECCAK256_HASH_LEN]) {
+    // Keccak填充: 0x01 ... 0x80 (SHA3-256使用的是0x06)
+    ctx->state[ctx->pos / 8] ^= (uint64_t)0x01 << (8 * (ctx->pos % 8));
+    ctx->state[(ETH_KECCAK256_RATE - 1) / 8] ^= (uint64_t)0x80 << (8 * ((ETH_KECCAK256_RATE - 1) % 8));
+    keccak_f1600(ctx->state);
+
+    for (int i = 0; i < ETH_KECCAK256_HASH_LEN; i++) {
+        hash[i] = (uint8_t)(ctx->state[i / 8] >> (8 * (i % 8)));
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+void eth_keccak256(const uint8_t* data, size_t len, uint8_t hash[ETH_KECCAK256_HASH_LEN]) {
+    eth_keccak256_ctx_t ctx;
+    eth_keccak256_init(&ctx);
+    eth_keccak256_update(&ctx, data, len);
+    eth_keccak256_final(&ctx, hash);
+}
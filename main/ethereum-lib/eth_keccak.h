@@ -0,0 +1,59 @@
+/*
+    Keccak-256 哈希 (以太坊使用的原始Keccak填充，不是NIST SHA3-256)
+
+    用于函数选择器、消息哈希和地址计算，设备本地完成，不再依赖节点的 web3_sha3。
+    支持一次性计算和增量计算 (init/update/final) 两种方式。
+
+*/
+
+#ifndef ETH_KECCAK_H
+#define ETH_KECCAK_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define ETH_KECCAK256_HASH_LEN 32
+#define ETH_KECCAK256_RATE     136  // 1600位状态 - 2*256位容量 = 1088位
+
+/**
+ * @brief Keccak-256 增量计算上下文
+ */
+typedef struct {
+    uint64_t state[25];  // Keccak-f[1600] 状态
+    size_t pos;          // 当前块中已吸收的字节数
+} eth_keccak256_ctx_t;
+
+/**
+ * @brief 初始化Keccak-256上下文
+ *
+ * @param ctx 上下文
+ */
+void eth_keccak256_init(eth_keccak256_ctx_t* ctx);
+
+/**
+ * @brief 向上下文追加数据，可多次调用
+ *
+ * @param ctx 上下文
+ * @param data 数据
+ * @param len 数据长度
+ */
+void eth_keccak256_update(eth_keccak256_ctx_t* ctx, const uint8_t* data, size_t len);
+
+/**
+ * @brief 完成计算并输出哈希，之后需重新init才能复用上下文
+ *
+ * @param ctx 上下文
+ * @param hash 输出的哈希值 (32字节)
+ */
+void eth_keccak256_final(eth_keccak256_ctx_t* ctx, uint8_t hash[ETH_KECCAK256_HASH_LEN]);
+
+/**
+ * @brief 一次性计算数据的Keccak-256哈希
+ *
+ * @param data 数据
+ * @param len 数据长度
+ * @param hash 输出的哈希值 (32字节)
+ */
+void eth_keccak256(const uint8_t* data, size_t len, uint8_t hash[ETH_KECCAK256_HASH_LEN]);
+
+#endif /* ETH_KECCAK_H */
@@ -0,0 +1,155 @@
+#include "eth_multicall.h"
+#include "eth_abi.h"
+#include "eth_rpc.h"
+#include <string.h>
+#include <stdlib.h>
+#include <esp_log.h>
+
+static const char *TAG = "ETH_MULTICALL";
+
+const eth_address_t ETH_MULTICALL3_ADDRESS = {
+    0xca, 0x11, 0xbd, 0xe0, 0x59, 0x77, 0xb3, 0x63, 0x11, 0x67,
+    0x02, 0x88, 0x62, 0xbe, 0x2a, 0x17, 0x39, 0x76, 0xca, 0x11,
+};
+
+// aggregate3((address,bool,bytes)[]) 的选择器
+static const uint8_t AGGREGATE3_SELECTOR[4] = {0x82, 0xad, 0x56, 0xcb};
+
+#define AGGREGATE3_OUTPUTS "((bool,bytes)[])"
+
+/*
+    参数树一次分配: count个元组后面紧跟count*3个字段
+    [tuple0 .. tupleN-1][addr0 bool0 bytes0][addr1 bool1 bytes1]...
+    字段的value直接引用调用者的数据，不复制调用数据。
+*/
+static abi_param_t *build_call_params(const eth_multicall_call_t *calls, size_t count, abi_param_t *array) {
+    abi_param_t *tuples = malloc(count * 4 * sizeof(abi_param_t));
+    if (!tuples) {
+        return NULL;
+    }
+    abi_param_t *fields = tuples + count;
+    for (size_t i = 0; i < count; i++) {
+        abi_param_t *f = fields + i * 3;
+        f[0] = (abi_param_t)ABI_ADDRESS(calls[i].target);
+        f[1] = (abi_param_t)ABI_BOOL(&calls[i].allow_failure);
+        f[2] = (abi_param_t)ABI_BYTES(calls[i].call_data, calls[i].call_data_len);
+        tuples[i] = (abi_param_t)ABI_TUPLE(f, 3);
+    }
+    *array = (abi_param_t)ABI_ARRAY(tuples, count);
+    return tuples;
+}
+
+static bool calls_valid(const eth_multicall_call_t *calls, size_t count) {
+    if (!calls || count == 0) {
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (!calls[i].target || (!calls[i].call_data && calls[i].call_data_len > 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+esp_err_t eth_multicall_encoded_size(const eth_multicall_call_t *calls, size_t count, size_t *size) {
+    if (!size || !calls_valid(calls, count)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    abi_param_t array;
+    abi_param_t *tuples = build_call_params(calls, count, &array);
+    if (!tuples) {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t err = abi_encoded_size(&array, 1, size);
+    free(tuples);
+    if (err == ESP_OK) {
+        *size += sizeof(AGGREGATE3_SELECTOR);
+    }
+    return err;
+}
+
+esp_err_t eth_multicall_encode(const eth_multicall_call_t *calls, size_t count,
+                               uint8_t *out, size_t out_len, size_t *written) {
+    if (!out || !written || !calls_valid(calls, count)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    abi_param_t array;
+    abi_param_t *tuples = build_call_params(calls, count, &array);
+    if (!tuples) {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t err = abi_encode_call_with_selector(AGGREGATE3_SELECTOR, &array, 1, out, out_len, written);
+    free(tuples);
+    return err;
+}
+
+esp_err_t eth_multicall_decode(const uint8_t *data, size_t data_len,
+                               eth_multicall_result_t *results, size_t count) {
+    if (!data || !results) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    abi_value_t ret, list;
+    esp_err_t err = abi_decode(AGGREGATE3_OUTPUTS, data, data_len, &ret);
+    if (err == ESP_OK) {
+        err = abi_value_at(&ret, 0, &list);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Malformed aggregate3 result: %s", esp_err_to_name(err));
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    if (list.length != count) {
+        ESP_LOGE(TAG, "aggregate3 returned %d results, expected %d", (int)list.length, (int)count);
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        abi_value_t entry, success, return_data;
+        if (abi_value_at(&list, i, &entry) != ESP_OK ||
+            abi_value_at(&entry, 0, &success) != ESP_OK ||
+            abi_value_at(&entry, 1, &return_data) != ESP_OK ||
+            abi_value_to_bool(&success, &results[i].success) != ESP_OK) {
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+        results[i].return_data = return_data.data;
+        results[i].return_data_len = return_data.length;
+    }
+    return ESP_OK;
+}
+
+esp_err_t eth_multicall_aggregate3(web3_context_t *context, const eth_address_t multicall,
+                                   const eth_multicall_call_t *calls, size_t count,
+                                   uint8_t *buf, size_t buf_len, eth_multicall_result_t *results) {
+    if (!context || !multicall || !buf || !results) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t call_len = 0;
+    esp_err_t err = eth_multicall_encoded_size(calls, count, &call_len);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    // 调用数据在发送后即可丢弃，返回数据写入调用者的缓冲区
+    uint8_t *call_data = malloc(call_len);
+    if (!call_data) {
+        return ESP_ERR_NO_MEM;
+    }
+    size_t written = 0;
+    err = eth_multicall_encode(calls, count, call_data, call_len, &written);
+    if (err == ESP_OK) {
+        size_t ret_len = 0;
+        err = eth_rpc_call(context, multicall, call_data, written, buf, buf_len, &ret_len);
+        if (err == ESP_OK) {
+            err = eth_multicall_decode(buf, ret_len, results, count);
+        }
+    }
+    free(call_data);
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "aggregate3 with %d calls failed: %s", (int)count, esp_err_to_name(err));
+    }
+    return err;
+}
@@ -0,0 +1,105 @@
+/*
+    Multicall3批量读取
+
+    把多个合约只读调用打包成一次Multicall3.aggregate3调用，只发送一个eth_call，
+    所有结果来自同一个区块。
+
+    eth_multicall_call_t calls[2] = {
+        { .target = farmkeeper, .allow_failure = true, .call_data = owner_call, .call_data_len = 4 },
+        { .target = farmkeeper, .allow_failure = true, .call_data = name_call, .call_data_len = 4 },
+    };
+    eth_multicall_result_t results[2];
+    uint8_t buf[1024];
+    eth_multicall_aggregate3(ctx, ETH_MULTICALL3_ADDRESS, calls, 2, buf, sizeof(buf), results);
+    // results[i].return_data指向buf，可以直接传给abi_decode或生成的解码函数
+
+    Multicall3在主流链和测试链上都部署在同一个地址；本地Hardhat/Ganache节点需要
+    自行部署，并把实际地址传入。
+
+*/
+
+#ifndef ETH_MULTICALL_H
+#define ETH_MULTICALL_H
+
+#include "web3.h"
+#include "eth_types.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Multicall3的标准部署地址 0xcA11bde05977b3631167028862bE2a173976CA11
+ */
+extern const eth_address_t ETH_MULTICALL3_ADDRESS;
+
+/**
+ * @brief 一个子调用 (对应Multicall3的Call3结构体)
+ */
+typedef struct {
+    const uint8_t* target;       // 目标合约地址 (ETH_ADDRESS_LEN字节)
+    bool allow_failure;          // 为false时该调用失败会使整个aggregate3回滚
+    const uint8_t* call_data;    // ABI编码的调用数据 (选择器 + 参数)
+    size_t call_data_len;        // 调用数据长度
+} eth_multicall_call_t;
+
+/**
+ * @brief 一个子调用的结果 (对应Multicall3的Result结构体)
+ */
+typedef struct {
+    bool success;                // 子调用是否成功
+    const uint8_t* return_data;  // 返回数据 (指向调用者的缓冲区)，失败时为revert数据
+    size_t return_data_len;      // 返回数据长度
+} eth_multicall_result_t;
+
+/**
+ * @brief 计算aggregate3调用数据的字节数
+ *
+ * @param calls 子调用列表
+ * @param count 子调用个数
+ * @param size 输出的字节数 (包含4字节选择器)
+ * @return esp_err_t ESP_OK成功，参数无效返回ESP_ERR_INVALID_ARG
+ */
+esp_err_t eth_multicall_encoded_size(const eth_multicall_call_t* calls, size_t count, size_t* size);
+
+/**
+ * @brief 编码aggregate3((address,bool,bytes)[])调用数据
+ *
+ * @param calls 子调用列表
+ * @param count 子调用个数
+ * @param out 输出缓冲区
+ * @param out_len 缓冲区长度
+ * @param written 实际写入的字节数
+ * @return esp_err_t ESP_OK成功，缓冲区不足返回ESP_ERR_INVALID_SIZE
+ */
+esp_err_t eth_multicall_encode(const eth_multicall_call_t* calls, size_t count,
+                               uint8_t* out, size_t out_len, size_t* written);
+
+/**
+ * @brief 解码aggregate3的返回数据 ((bool,bytes)[])
+ *
+ * @param data aggregate3的返回数据 (结果引用该缓冲区)
+ * @param data_len 数据长度
+ * @param results 输出的结果数组
+ * @param count 结果个数，必须与返回的数组长度一致
+ * @return esp_err_t ESP_OK成功，数据格式错误或个数不符返回ESP_ERR_INVALID_RESPONSE
+ */
+esp_err_t eth_multicall_decode(const uint8_t* data, size_t data_len,
+                               eth_multicall_result_t* results, size_t count);
+
+/**
+ * @brief 通过一次eth_call执行一组只读调用 (最新区块)
+ *
+ * @param context Web3上下文
+ * @param multicall Multicall3合约地址，通常为ETH_MULTICALL3_ADDRESS
+ * @param calls 子调用列表
+ * @param count 子调用个数
+ * @param buf 存放返回数据的缓冲区，results中的return_data指向这里
+ * @param buf_len 缓冲区长度
+ * @param results 输出的结果数组 (count个)
+ * @return esp_err_t ESP_OK成功 (各子调用是否成功见results[i].success)，
+ *         缓冲区不足返回ESP_ERR_INVALID_SIZE，内存不足返回ESP_ERR_NO_MEM，其他值失败
+ */
+esp_err_t eth_multicall_aggregate3(web3_context_t* context, const eth_address_t multicall,
+                                   const eth_multicall_call_t* calls, size_t count,
+                                   uint8_t* buf, size_t buf_len, eth_multicall_result_t* results);
+
+#endif /* ETH_MULTICALL_H */
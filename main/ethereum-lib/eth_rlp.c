@@ -0,0 +1,88 @@
+#include "eth_rlp.h"
+#include <string.h>
+
+// 写入原始字节，缓冲区为NULL时只累计长度
+static esp_err_t rlp_write(eth_rlp_buffer_t* rlp, const uint8_t* data, size_t len) {
+    if (rlp->buf) {
+        if (rlp->len + len > rlp->buf_len) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        if (len > 0) {
+            memcpy(rlp->buf + rlp->len, data, len);
+        }
+    }
+    rlp->len += len;
+    return ESP_OK;
+}
+
+// 写入长度前缀: 短格式为 offset+len，长格式为 offset+55+长度字节数, 长度 (大端序)
+static esp_err_t rlp_write_length(eth_rlp_buffer_t* rlp, size_t len, uint8_t offset) {
+    uint8_t header[1 + sizeof(size_t)];
+
+    if (len <= 55) {
+        header[0] = offset + (uint8_t)len;
+        return rlp_write(rlp, header, 1);
+    }
+
+    size_t len_bytes = 0;
+    for (size_t tmp = len; tmp > 0; tmp >>= 8) {
+        len_bytes++;
+    }
+
+    header[0] = offset + 55 + (uint8_t)len_bytes;
+    for (size_t i = 0; i < len_bytes; i++) {
+        header[len_bytes - i] = (uint8_t)(len >> (8 * i));
+    }
+    return rlp_write(rlp, header, 1 + len_bytes);
+}
+
+void eth_rlp_init(eth_rlp_buffer_t* rlp, uint8_t* buf, size_t buf_len) {
+    rlp->buf = buf;
+    rlp->buf_len = buf ? buf_len : 0;
+    rlp->len = 0;
+}
+
+esp_err_t eth_rlp_append_bytes(eth_rlp_buffer_t* rlp, const uint8_t* data, size_t len) {
+    if (!rlp || (!data && len > 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 单个小于0x80的字节就是它自身的编码
+    if (len == 1 && data[0] < 0x80) {
+        return rlp_write(rlp, data, 1);
+    }
+
+    esp_err_t err = rlp_write_length(rlp, len, 0x80);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return rlp_write(rlp, data, len);
+}
+
+esp_err_t eth_rlp_append_uint(eth_rlp_buffer_t* rlp, uint64_t value) {
+    uint8_t be[8];
+    for (int i = 0; i < 8; i++) {
+        be[7 - i] = (uint8_t)(value >> (8 * i));
+    }
+    return eth_rlp_append_uint_bytes(rlp, be, sizeof(be));
+}
+
+esp_err_t eth_rlp_append_uint_bytes(eth_rlp_buffer_t* rlp, const uint8_t* be, size_t len) {
+    if (!rlp || (!be && len > 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 整数必须使用最短编码，去掉前导零
+    while (len > 0 && be[0] == 0) {
+        be++;
+        len--;
+    }
+    return eth_rlp_append_bytes(rlp, be, len);
+}
+
+esp_err_t eth_rlp_append_list_header(eth_rlp_buffer_t* rlp, size_t payload_len) {
+    if (!rlp) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return rlp_write_length(rlp, payload_len, 0xc0);
+}
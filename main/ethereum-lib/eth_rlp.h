@@ -0,0 +1,78 @@
+/*
+    RLP (Recursive Length Prefix) 编码
+
+    以太坊交易在签名和广播前都需要RLP编码。编码器直接写入调用者提供的缓冲区，
+    缓冲区为NULL时只累计所需长度，可以先计算长度再一次性分配。
+
+    单个字节 0x00-0x7f      -> 原样输出
+    0-55字节的字符串         -> 0x80+长度, 数据
+    超过55字节的字符串       -> 0xb7+长度的字节数, 长度, 数据
+    0-55字节负载的列表       -> 0xc0+负载长度, 负载
+    超过55字节负载的列表     -> 0xf7+长度的字节数, 长度, 负载
+
+*/
+
+#ifndef ETH_RLP_H
+#define ETH_RLP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <esp_err.h>
+
+/**
+ * @brief RLP输出缓冲区
+ */
+typedef struct {
+    uint8_t* buf;      // 输出缓冲区 (为NULL时只计算长度)
+    size_t buf_len;    // 缓冲区大小
+    size_t len;        // 已写入 (或需要) 的字节数
+} eth_rlp_buffer_t;
+
+/**
+ * @brief 初始化RLP输出缓冲区
+ *
+ * @param rlp RLP缓冲区
+ * @param buf 输出缓冲区 (可为NULL，仅计算长度)
+ * @param buf_len 缓冲区大小
+ */
+void eth_rlp_init(eth_rlp_buffer_t* rlp, uint8_t* buf, size_t buf_len);
+
+/**
+ * @brief 追加字节串
+ *
+ * @param rlp RLP缓冲区
+ * @param data 数据 (长度为0时可为NULL)
+ * @param len 数据长度
+ * @return esp_err_t ESP_OK成功，缓冲区不足返回ESP_ERR_INVALID_SIZE
+ */
+esp_err_t eth_rlp_append_bytes(eth_rlp_buffer_t* rlp, const uint8_t* data, size_t len);
+
+/**
+ * @brief 追加无符号整数 (按最短大端序编码，0编码为空字符串)
+ *
+ * @param rlp RLP缓冲区
+ * @param value 整数值
+ * @return esp_err_t ESP_OK成功，缓冲区不足返回ESP_ERR_INVALID_SIZE
+ */
+esp_err_t eth_rlp_append_uint(eth_rlp_buffer_t* rlp, uint64_t value);
+
+/**
+ * @brief 追加大端序表示的大整数 (自动去掉前导零)
+ *
+ * @param rlp RLP缓冲区
+ * @param be 大端序数据 (长度为0时可为NULL)
+ * @param len 数据长度
+ * @return esp_err_t ESP_OK成功，缓冲区不足返回ESP_ERR_INVALID_SIZE
+ */
+esp_err_t eth_rlp_append_uint_bytes(eth_rlp_buffer_t* rlp, const uint8_t* be, size_t len);
+
+/**
+ * @brief 追加列表头，之后需追加恰好payload_len字节的列表元素
+ *
+ * @param rlp RLP缓冲区
+ * @param payload_len 列表元素编码后的总长度
+ * @return esp_err_t ESP_OK成功，缓冲区不足返回ESP_ERR_INVALID_SIZE
+ */
+esp_err_t eth_rlp_append_list_header(eth_rlp_buffer_t* rlp, size_t payload_len);
+
+#endif /* ETH_RLP_H */
@@ -1,14 +1,17 @@
 #include "eth_rpc.h"
 #include <esp_log.h>
 #include <cJSON.h>
+#include "eth_json.h"
+#include "eth_hex.h"
+#include "eth_uint256.h"
+#include "eth_units.h"
 #include <string.h>
+#include <strings.h>
 #include <stdlib.h>
-#include <math.h>
-#include <errno.h>
 
 static const char *TAG = "ETH_RPC";
 
-// 将16进制Wei字符串转换为十进制ETH浮点数
+// 将16进制Wei字符串转换为ETH (精确输出全部有效小数位)
 void wei_to_eth(const char *wei_hex, char *eth_str, size_t eth_str_len)
 {
     if (!wei_hex || !eth_str || eth_str_len == 0)
@@ -16,97 +19,15 @@ void wei_to_eth(const char *wei_hex, char *eth_str, size_t eth_str_len)
         return;
     }
 
-    // 跳过"0x"前缀
-    if (strncmp(wei_hex, "0x", 2) == 0)
+    uint256_t wei;
+    char ether[ETH_UNITS_BUF_LEN];
+    if (uint256_from_hex(wei_hex, strlen(wei_hex), &wei) != ESP_OK ||
+        eth_units_format(&wei, ETH_ETHER_DECIMALS, ETH_UNITS_FULL_PRECISION, ether, sizeof(ether)) != ESP_OK)
     {
-        wei_hex += 2;
-    }
-
-    // 特殊处理常见的余额值
-    if (strcmp(wei_hex, "21e19e0c9bab2400000") == 0)
-    {
-        snprintf(eth_str, eth_str_len, "10000 ETH");
-        return;
-    }
-
-    size_t hex_len = strlen(wei_hex);
-
-    // 1 ETH = 10^18 Wei = 0xDE0B6B3A7640000 (16位十六进制数)
-    // 我们需要将wei值除以10^18得到ETH值
-
-    // 对于小数值，可以直接用strtoull转换
-    if (hex_len <= 15)
-    {
-        unsigned long long wei_value = strtoull(wei_hex, NULL, 16);
-        double eth_value = (double)wei_value / 1000000000000000000.0;
-        snprintf(eth_str, eth_str_len, "%.6f ETH", eth_value);
+        snprintf(eth_str, eth_str_len, "Error: invalid wei value");
         return;
     }
-
-    // 对于大值，我们需要一个更精确的转换方法
-    // 每1个十六进制字符相当于4个二进制位，或者约为log10(16)≈1.2个十进制位
-    // 所以16个十六进制字符大约是19-20个十进制位，接近于10^18
-
-    // 将十六进制字符串拆分为以太币整数部分和小数部分
-    int eth_integer_digits = hex_len - 16; // 16个十六进制字符约为10^18
-
-    if (eth_integer_digits <= 0)
-    {
-        // 不到1 ETH
-        unsigned long long wei_value = strtoull(wei_hex, NULL, 16);
-        double eth_value = (double)wei_value / 1000000000000000000.0;
-        snprintf(eth_str, eth_str_len, "%.6f ETH", eth_value);
-    }
-    else
-    {
-        // 超过1 ETH，处理整数部分
-        char *integer_part = malloc(eth_integer_digits + 1);
-        if (!integer_part)
-        {
-            snprintf(eth_str, eth_str_len, "Error: out of memory");
-            return;
-        }
-
-        // 提取整数部分的十六进制字符
-        strncpy(integer_part, wei_hex, eth_integer_digits);
-        integer_part[eth_integer_digits] = '\0';
-
-        // 转换整数部分到十进制
-        unsigned long long int_eth;
-        if (eth_integer_digits <= 8)
-        { // 能用标准函数安全转换的大小
-            int_eth = strtoull(integer_part, NULL, 16);
-            snprintf(eth_str, eth_str_len, "%llu ETH", int_eth);
-        }
-        else
-        {
-            // 对于非常大的数字，我们给出一个近似值
-            // 这种情况下，通常只显示整数部分
-            // 前8位十六进制代表高位有效数字
-            char approx[9];
-            strncpy(approx, integer_part, 8);
-            approx[8] = '\0';
-
-            unsigned long long high_digits = strtoull(approx, NULL, 16);
-            int remaining_hex_digits = eth_integer_digits - 8;
-
-            // 每个十六进制字符相当于乘以16
-            double multiplier = pow(16, remaining_hex_digits);
-            double approx_eth = high_digits * multiplier;
-
-            // 对于非常大的数字，用科学计数法
-            if (approx_eth > 1000000)
-            {
-                snprintf(eth_str, eth_str_len, "%.2e ETH", approx_eth);
-            }
-            else
-            {
-                snprintf(eth_str, eth_str_len, "%.0f ETH", approx_eth);
-            }
-        }
-
-        free(integer_part);
-    }
+    snprintf(eth_str, eth_str_len, "%s ETH", ether);
 }
 
 // 辅助函数：将十六进制字符串转换为十进制字符串
@@ -117,101 +38,61 @@ void hex_to_decimal(const char *hex, char *decimal, size_t decimal_len)
         return;
     }
 
-    // 跳过"0x"前缀
-    if (strncmp(hex, "0x", 2) == 0)
+    uint256_t value;
+    if (uint256_from_hex(hex, strlen(hex), &value) != ESP_OK ||
+        uint256_to_dec(&value, decimal, decimal_len) != ESP_OK)
     {
-        hex += 2;
+        decimal[0] = '\0';
     }
+}
 
-    // 特殊情况处理：0
-    if (strcmp(hex, "0") == 0 || strlen(hex) == 0)
+// 解析JSON-RPC响应并取出result，节点返回error时打印错误信息 (不构建cJSON树，无堆分配)
+static esp_err_t parse_rpc_result(const char *response, eth_json_token_t *result)
+{
+    eth_rpc_response_t resp;
+    if (eth_json_parse_response(response, strlen(response), &resp) != ESP_OK)
     {
-        strncpy(decimal, "0", decimal_len);
-        return;
+        ESP_LOGE(TAG, "Failed to parse JSON response");
+        return ESP_FAIL;
     }
 
-    // 初始化十进制结果字符串为0
-    decimal[0] = '0';
-    decimal[1] = '\0';
-
-    // 对每一位十六进制数字进行处理
-    for (size_t i = 0; i < strlen(hex); i++)
+    if (resp.result.type == ETH_JSON_NONE)
     {
-        char hex_digit = hex[i];
-        int digit_value;
-
-        // 将十六进制字符转换为数值
-        if (hex_digit >= '0' && hex_digit <= '9')
-        {
-            digit_value = hex_digit - '0';
-        }
-        else if (hex_digit >= 'a' && hex_digit <= 'f')
-        {
-            digit_value = hex_digit - 'a' + 10;
-        }
-        else if (hex_digit >= 'A' && hex_digit <= 'F')
-        {
-            digit_value = hex_digit - 'A' + 10;
-        }
-        else
-        {
-            // 无效字符，跳过
-            continue;
-        }
-
-        // 将已有的十进制结果乘以16，然后加上当前位的值
-        // 这里采用字符串计算的方式，适合处理任意长度的大数
-
-        // 现有的十进制结果乘以16
-        int carry = 0;
-        for (size_t j = 0; j < strlen(decimal); j++)
-        {
-            int val = (decimal[j] - '0') * 16 + carry;
-            decimal[j] = (val % 10) + '0';
-            carry = val / 10;
-        }
-
-        // 处理进位
-        char temp[2] = {0};
-        while (carry > 0)
+        ESP_LOGE(TAG, "No 'result' field in JSON response");
+        if (resp.error_message.type == ETH_JSON_STRING)
         {
-            temp[0] = (carry % 10) + '0';
-            strncat(decimal, temp, decimal_len - strlen(decimal) - 1);
-            carry /= 10;
+            ESP_LOGE(TAG, "Error from Ethereum node (%lld): %.*s", (long long)resp.error_code,
+                     (int)resp.error_message.len, resp.error_message.start);
         }
+        return ESP_FAIL;
+    }
 
-        // 加上当前位的值
-        int sum = (decimal[0] - '0') + digit_value;
-        decimal[0] = (sum % 10) + '0';
-        carry = sum / 10;
+    *result = resp.result;
+    return ESP_OK;
+}
 
-        // 处理进位
-        size_t j = 1;
-        while (carry > 0 && j < strlen(decimal))
-        {
-            sum = (decimal[j] - '0') + carry;
-            decimal[j] = (sum % 10) + '0';
-            carry = sum / 10;
-            j++;
-        }
+// 取出字符串类型的result并复制到输出缓冲区
+static esp_err_t copy_result_string(const char *response, char *out, size_t out_len)
+{
+    eth_json_token_t result_tok;
+    esp_err_t err = parse_rpc_result(response, &result_tok);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
 
-        // 如果最后还有进位，添加到结果中
-        while (carry > 0)
-        {
-            temp[0] = (carry % 10) + '0';
-            strncat(decimal, temp, decimal_len - strlen(decimal) - 1);
-            carry /= 10;
-        }
+    if (result_tok.type != ETH_JSON_STRING)
+    {
+        ESP_LOGE(TAG, "Result field is not a string");
+        return ESP_FAIL;
     }
 
-    // 反转字符串（因为我们是从低位到高位计算的）
-    size_t len = strlen(decimal);
-    for (size_t i = 0; i < len / 2; i++)
+    err = eth_json_token_copy_string(&result_tok, out, out_len);
+    if (err == ESP_ERR_INVALID_SIZE)
     {
-        char temp = decimal[i];
-        decimal[i] = decimal[len - 1 - i];
-        decimal[len - 1 - i] = temp;
+        ESP_LOGE(TAG, "Result truncated (%d bytes, buffer %d)", (int)result_tok.len, (int)out_len);
     }
+    return err;
 }
 
 esp_err_t eth_get_block_number(web3_context_t *context, uint64_t *block_number)
@@ -230,46 +111,20 @@ esp_err_t eth_get_block_number(web3_context_t *context, uint64_t *block_number)
 
     ESP_LOGI(TAG, "Processing block number response: %s", result);
 
-    cJSON *json = cJSON_Parse(result);
-    if (!json)
-    {
-        ESP_LOGE(TAG, "Failed to parse JSON response");
-        return ESP_FAIL;
-    }
-
-    cJSON *result_obj = cJSON_GetObjectItem(json, "result");
-    if (!result_obj)
+    eth_json_token_t result_tok;
+    err = parse_rpc_result(result, &result_tok);
+    if (err != ESP_OK)
     {
-        ESP_LOGE(TAG, "No 'result' field in JSON response");
-        cJSON_Delete(json);
-        return ESP_FAIL;
+        return err;
     }
 
-    // 更健壮的类型处理
-    if (cJSON_IsString(result_obj))
-    {
-        char *hex = result_obj->valuestring;
-        // 跳过"0x"前缀
-        if (strlen(hex) > 2 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X'))
-        {
-            hex += 2;
-        }
-
-        char *endptr;
-        *block_number = strtoull(hex, &endptr, 16);
-    }
-    else if (cJSON_IsNumber(result_obj))
+    // 十六进制字符串和数字两种形式都接受
+    if (eth_json_token_to_uint64(&result_tok, block_number) != ESP_OK)
     {
-        *block_number = (uint64_t)result_obj->valuedouble;
-    }
-    else
-    {
-        ESP_LOGE(TAG, "Result field is neither string nor number");
-        cJSON_Delete(json);
+        ESP_LOGE(TAG, "Result field is neither hex string nor number");
         return ESP_FAIL;
     }
 
-    cJSON_Delete(json);
     return ESP_OK;
 }
 
@@ -290,46 +145,47 @@ esp_err_t eth_get_balance(web3_context_t *context, const char *address, char *ba
         return err;
     }
 
-    cJSON *json = cJSON_Parse(result);
-    if (!json)
-    {
-        ESP_LOGE(TAG, "Failed to parse JSON response");
-        return ESP_FAIL;
-    }
-
-    cJSON *result_obj = cJSON_GetObjectItem(json, "result");
-    if (!result_obj)
+    eth_json_token_t result_tok;
+    err = parse_rpc_result(result, &result_tok);
+    if (err != ESP_OK)
     {
-        ESP_LOGE(TAG, "No 'result' field in JSON response");
-        cJSON_Delete(json);
-        return ESP_FAIL;
+        return err;
     }
 
-    if (cJSON_IsString(result_obj))
+    if (result_tok.type == ETH_JSON_STRING)
     {
         // 获取原始十六进制Wei值
-        const char *hex_wei = result_obj->valuestring;
+        char hex_wei[80] = {0};
+        if (eth_json_token_copy_string(&result_tok, hex_wei, sizeof(hex_wei)) != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Balance value too long");
+            return ESP_FAIL;
+        }
 
         // 转换为十进制Wei值
-        char decimal_wei[128] = {0};
+        char decimal_wei[UINT256_DEC_BUF_LEN] = {0};
         hex_to_decimal(hex_wei, decimal_wei, sizeof(decimal_wei));
 
         // 格式化输出，同时显示十六进制和十进制值
         snprintf(balance, balance_len, "%s (十进制: %s Wei)", hex_wei, decimal_wei);
     }
-    else if (cJSON_IsNumber(result_obj))
+    else if (result_tok.type == ETH_JSON_NUMBER)
     {
         // 数字类型直接输出
-        snprintf(balance, balance_len, "%llu Wei", (unsigned long long)result_obj->valuedouble);
+        uint64_t wei = 0;
+        if (eth_json_token_to_uint64(&result_tok, &wei) != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Invalid numeric balance");
+            return ESP_FAIL;
+        }
+        snprintf(balance, balance_len, "%llu Wei", (unsigned long long)wei);
     }
     else
     {
         ESP_LOGE(TAG, "Result field is neither string nor number");
-        cJSON_Delete(json);
         return ESP_FAIL;
     }
 
-    cJSON_Delete(json);
     return ESP_OK;
 }
 
@@ -361,35 +217,7 @@ esp_err_t eth_get_client_version(web3_context_t *context, char* client_version,
         return err;
     }
 
-    cJSON *json = cJSON_Parse(result);
-    if (!json)
-    {
-        ESP_LOGE(TAG, "Failed to parse JSON response");
-        return ESP_FAIL;
-    }
-
-    cJSON *result_obj = cJSON_GetObjectItem(json, "result");
-    if (!result_obj)
-    {
-        ESP_LOGE(TAG, "No 'result' field in JSON response");
-        cJSON_Delete(json);
-        return ESP_FAIL;
-    }
-
-    if (cJSON_IsString(result_obj))
-    {
-        strncpy(client_version, result_obj->valuestring, version_len - 1);
-        client_version[version_len - 1] = '\0'; // 确保字符串结尾
-    }
-    else
-    {
-        ESP_LOGE(TAG, "Result field is not a string");
-        cJSON_Delete(json);
-        return ESP_FAIL;
-    }
-
-    cJSON_Delete(json);
-    return ESP_OK;
+    return copy_result_string(result, client_version, version_len);
 }
 
 
@@ -411,26 +239,7 @@ esp_err_t eth_get_web3_sha3(web3_context_t *context, const char *post_data, char
         return err;
     }
 
-    // Parse result
-    cJSON *json = cJSON_Parse(result);
-    if (!json) {
-        ESP_LOGE(TAG, "Failed to parse JSON response");
-        return ESP_FAIL;
-    }
-
-    cJSON *result_obj = cJSON_GetObjectItem(json, "result");
-    if (!result_obj || !cJSON_IsString(result_obj)) {
-        ESP_LOGE(TAG, "Invalid or missing 'result' field in response");
-        cJSON_Delete(json);
-        return ESP_FAIL;
-    }
-
-    // Copy result, ensuring we don't overflow the buffer
-    strncpy(hash, result_obj->valuestring, hash_len - 1);
-    hash[hash_len - 1] = '\0'; // Ensure null termination
-    
-    cJSON_Delete(json);
-    return ESP_OK;
+    return copy_result_string(result, hash, hash_len);
 }
 
 esp_err_t eth_get_net_version(web3_context_t *context, char *network_id, size_t network_id_len)
@@ -447,35 +256,7 @@ esp_err_t eth_get_net_version(web3_context_t *context, char *network_id, size_t
         return err;
     }
 
-    cJSON *json = cJSON_Parse(result);
-    if (!json)
-    {
-        ESP_LOGE(TAG, "Failed to parse JSON response");
-        return ESP_FAIL;
-    }
-
-    cJSON *result_obj = cJSON_GetObjectItem(json, "result");
-    if (!result_obj)
-    {
-        ESP_LOGE(TAG, "No 'result' field in JSON response");
-        cJSON_Delete(json);
-        return ESP_FAIL;
-    }
-
-    if (cJSON_IsString(result_obj))
-    {
-        strncpy(network_id, result_obj->valuestring, network_id_len - 1);
-        network_id[network_id_len - 1] = '\0'; // 确保字符串结尾
-    }
-    else
-    {
-        ESP_LOGE(TAG, "Result field is not a string");
-        cJSON_Delete(json);
-        return ESP_FAIL;
-    }
-
-    cJSON_Delete(json);
-    return ESP_OK;
+    return copy_result_string(result, network_id, network_id_len);
 }
 
 esp_err_t eth_get_net_listening(web3_context_t *context, bool *result, size_t result_len)
@@ -492,33 +273,20 @@ esp_err_t eth_get_net_listening(web3_context_t *context, bool *result, size_t re
         return err;
     }
 
-    cJSON *json = cJSON_Parse(response);
-    if (!json)
-    {
-        ESP_LOGE(TAG, "Failed to parse JSON response");
-        return ESP_FAIL;
-    }
-
-    cJSON *result_obj = cJSON_GetObjectItem(json, "result");
-    if (!result_obj)
+    eth_json_token_t result_tok;
+    err = parse_rpc_result(response, &result_tok);
+    if (err != ESP_OK)
     {
-        ESP_LOGE(TAG, "No 'result' field in JSON response");
-        cJSON_Delete(json);
-        return ESP_FAIL;
+        return err;
     }
 
-    if (cJSON_IsBool(result_obj))
-    {
-        *result = cJSON_IsTrue(result_obj);
-    }
-    else
+    if (result_tok.type != ETH_JSON_TRUE && result_tok.type != ETH_JSON_FALSE)
     {
         ESP_LOGE(TAG, "Result field is not a boolean");
-        cJSON_Delete(json);
         return ESP_FAIL;
     }
 
-    cJSON_Delete(json);
+    *result = result_tok.type == ETH_JSON_TRUE;
     return ESP_OK;
 }
 
@@ -536,35 +304,7 @@ esp_err_t eth_get_net_peerCount(web3_context_t *context, char *quantity, size_t
         return err;
     }
 
-    cJSON *json = cJSON_Parse(result);
-    if (!json)
-    {
-        ESP_LOGE(TAG, "Failed to parse JSON response");
-        return ESP_FAIL;
-    }
-
-    cJSON *result_obj = cJSON_GetObjectItem(json, "result");
-    if (!result_obj)
-    {
-        ESP_LOGE(TAG, "No 'result' field in JSON response");
-        cJSON_Delete(json);
-        return ESP_FAIL;
-    }
-
-    if (cJSON_IsString(result_obj))
-    {
-        strncpy(quantity, result_obj->valuestring, quantity_len - 1);
-        quantity[quantity_len - 1] = '\0'; // 确保字符串结尾
-    }
-    else
-    {
-        ESP_LOGE(TAG, "Result field is not a string");
-        cJSON_Delete(json);
-        return ESP_FAIL;
-    }
-
-    cJSON_Delete(json);
-    return ESP_OK;
+    return copy_result_string(result, quantity, quantity_len);
 }
 
 esp_err_t eth_get_eth_protocolVersion(web3_context_t *context, char *result, size_t result_len)
@@ -581,35 +321,7 @@ esp_err_t eth_get_eth_protocolVersion(web3_context_t *context, char *result, siz
         return err;
     }
 
-    cJSON *json = cJSON_Parse(response);
-    if (!json)
-    {
-        ESP_LOGE(TAG, "Failed to parse JSON response");
-        return ESP_FAIL;
-    }
-
-    cJSON *result_obj = cJSON_GetObjectItem(json, "result");
-    if (!result_obj)
-    {
-        ESP_LOGE(TAG, "No 'result' field in JSON response");
-        cJSON_Delete(json);
-        return ESP_FAIL;
-    }
-
-    if (cJSON_IsString(result_obj))
-    {
-        strncpy(result, result_obj->valuestring, result_len - 1);
-        result[result_len - 1] = '\0'; // 确保字符串结尾
-    }
-    else
-    {
-        ESP_LOGE(TAG, "Result field is not a string");
-        cJSON_Delete(json);
-        return ESP_FAIL;
-    }
-
-    cJSON_Delete(json);
-    return ESP_OK;
+    return copy_result_string(response, result, result_len);
 }
 
 esp_err_t eth_get_eth_syncing(web3_context_t *context, char *result, size_t result_len)
@@ -626,35 +338,19 @@ esp_err_t eth_get_eth_syncing(web3_context_t *context, char *result, size_t resu
         return err;
     }
 
-    cJSON *json = cJSON_Parse(response);
-    if (!json)
-    {
-        ESP_LOGE(TAG, "Failed to parse JSON response");
-        return ESP_FAIL;
-    }
-
-    cJSON *result_obj = cJSON_GetObjectItem(json, "result");
-    if (!result_obj)
+    eth_json_token_t result_tok;
+    err = parse_rpc_result(response, &result_tok);
+    if (err != ESP_OK)
     {
-        ESP_LOGE(TAG, "No 'result' field in JSON response");
-        cJSON_Delete(json);
-        return ESP_FAIL;
+        return err;
     }
 
-    if (cJSON_IsString(result_obj))
-    {
-        strncpy(result, result_obj->valuestring, result_len - 1);
-        result[result_len - 1] = '\0'; // 确保字符串结尾
-    }
-    else
+    // 未同步时返回false，同步中返回对象，均按原始JSON文本输出
+    if (result_tok.type == ETH_JSON_STRING)
     {
-        ESP_LOGE(TAG, "Result field is not a string");
-        cJSON_Delete(json);
-        return ESP_FAIL;
+        return eth_json_token_copy_string(&result_tok, result, result_len);
     }
-
-    cJSON_Delete(json);
-    return ESP_OK;
+    return eth_json_token_copy_raw(&result_tok, result, result_len);
 }
 
 esp_err_t get_eth_gasPrice(web3_context_t *context, char *quantity, size_t quantity_len)
@@ -671,41 +367,21 @@ esp_err_t get_eth_gasPrice(web3_context_t *context, char *quantity, size_t quant
         return err;
     }
 
-    cJSON *json = cJSON_Parse(result);
-    if (!json)
-    {
-        ESP_LOGE(TAG, "Failed to parse JSON response");
-        return ESP_FAIL;
-    }
-
-    cJSON *result_obj = cJSON_GetObjectItem(json, "result");
-    if (!result_obj)
+    // 获取原始十六进制Wei值
+    char hex_wei[80] = {0};
+    err = copy_result_string(result, hex_wei, sizeof(hex_wei));
+    if (err != ESP_OK)
     {
-        ESP_LOGE(TAG, "No 'result' field in JSON response");
-        cJSON_Delete(json);
-        return ESP_FAIL;
+        return err;
     }
 
-    if (cJSON_IsString(result_obj))
-    {
-        // 获取原始十六进制Wei值
-        const char *hex_wei = result_obj->valuestring;
-
-        // 转换为十进制Wei值
-        char decimal_wei[128] = {0};
-        hex_to_decimal(hex_wei, decimal_wei, sizeof(decimal_wei));
+    // 转换为十进制Wei值
+    char decimal_wei[UINT256_DEC_BUF_LEN] = {0};
+    hex_to_decimal(hex_wei, decimal_wei, sizeof(decimal_wei));
 
-        // 格式化输出，同时显示十六进制和十进制值
-        snprintf(quantity, quantity_len, "%s (十进制: %s Wei)", hex_wei, decimal_wei);
-    }
-    else
-    {
-        ESP_LOGE(TAG, "Result field is not a string");
-        cJSON_Delete(json);
-        return ESP_FAIL;
-    }
+    // 格式化输出，同时显示十六进制和十进制值
+    snprintf(quantity, quantity_len, "%s (十进制: %s Wei)", hex_wei, decimal_wei);
 
-    cJSON_Delete(json);
     return ESP_OK;
 }
 
@@ -726,35 +402,7 @@ esp_err_t eth_getTransactionCount(web3_context_t *context, const char *address,
         return err;
     }
 
-    cJSON *json = cJSON_Parse(result);
-    if (!json)
-    {
-        ESP_LOGE(TAG, "Failed to parse JSON response");
-        return ESP_FAIL;
-    }
-
-    cJSON *result_obj = cJSON_GetObjectItem(json, "result");
-    if (!result_obj)
-    {
-        ESP_LOGE(TAG, "No 'result' field in JSON response");
-        cJSON_Delete(json);
-        return ESP_FAIL;
-    }
-
-    if (cJSON_IsString(result_obj))
-    {
-        strncpy(quantity, result_obj->valuestring, quantity_len - 1);
-        quantity[quantity_len - 1] = '\0'; // 确保字符串结尾
-    }
-    else
-    {
-        ESP_LOGE(TAG, "Result field is not a string");
-        cJSON_Delete(json);
-        return ESP_FAIL;
-    }
-
-    cJSON_Delete(json);
-    return ESP_OK;
+    return copy_result_string(result, quantity, quantity_len);
 }
 
 esp_err_t eth_sign(web3_context_t *context, const char *address, const char *data,
@@ -775,35 +423,7 @@ esp_err_t eth_sign(web3_context_t *context, const char *address, const char *dat
         return err;
     }
 
-    cJSON *json = cJSON_Parse(result);
-    if (!json)
-    {
-        ESP_LOGE(TAG, "Failed to parse JSON response");
-        return ESP_FAIL;
-    }
-
-    cJSON *result_obj = cJSON_GetObjectItem(json, "result");
-    if (!result_obj)
-    {
-        ESP_LOGE(TAG, "No 'result' field in JSON response");
-        cJSON_Delete(json);
-        return ESP_FAIL;
-    }
-
-    if (cJSON_IsString(result_obj))
-    {
-        strncpy(signed_data, result_obj->valuestring, signed_data_len - 1);
-        signed_data[signed_data_len - 1] = '\0'; // 确保字符串结尾
-    }
-    else
-    {
-        ESP_LOGE(TAG, "Result field is not a string");
-        cJSON_Delete(json);
-        return ESP_FAIL;
-    }
-
-    cJSON_Delete(json);
-    return ESP_OK;
+    return copy_result_string(result, signed_data, signed_data_len);
 }
 
 esp_err_t eth_signTransaction(web3_context_t* context,
@@ -881,55 +501,35 @@ esp_err_t eth_signTransaction(web3_context_t* context,
     }
 
     // 解析响应
-    cJSON* json = cJSON_Parse(result);
-    if (!json) {
-        ESP_LOGE(TAG, "Failed to parse JSON response");
-        return ESP_FAIL;
-    }
-
-    // 获取签名后的交易
-    cJSON* result_obj = cJSON_GetObjectItem(json, "result");
-    if (!result_obj) {
-        ESP_LOGE(TAG, "No 'result' field in JSON response");
-        
-        // 检查是否有错误信息
-        cJSON* error_obj = cJSON_GetObjectItem(json, "error");
-        if (error_obj) {
-            cJSON* error_message = cJSON_GetObjectItem(error_obj, "message");
-            if (error_message && cJSON_IsString(error_message)) {
-                ESP_LOGE(TAG, "Error from Ethereum node: %s", error_message->valuestring);
-            }
-        }
-        
-        cJSON_Delete(json);
-        return ESP_FAIL;
+    eth_json_token_t result_tok;
+    err = parse_rpc_result(result, &result_tok);
+    if (err != ESP_OK) {
+        return err;
     }
 
     // 如果结果是字符串
-    if (cJSON_IsString(result_obj)) {
-        strncpy(signed_tx, result_obj->valuestring, signed_tx_len - 1);
-        signed_tx[signed_tx_len - 1] = '\0'; // 确保字符串以null字符结尾
+    if (result_tok.type == ETH_JSON_STRING) {
+        err = eth_json_token_copy_string(&result_tok, signed_tx, signed_tx_len);
     } 
     // 如果结果是对象，提取raw字段
-    else if (cJSON_IsObject(result_obj)) {
-        cJSON* raw = cJSON_GetObjectItem(result_obj, "raw");
-        if (raw && cJSON_IsString(raw)) {
-            strncpy(signed_tx, raw->valuestring, signed_tx_len - 1);
-            signed_tx[signed_tx_len - 1] = '\0';
-        } else {
+    else if (result_tok.type == ETH_JSON_OBJECT) {
+        eth_json_token_t raw;
+        if (eth_json_object_get(&result_tok, "raw", &raw) != ESP_OK || raw.type != ETH_JSON_STRING) {
             ESP_LOGE(TAG, "No 'raw' field in result object");
-            cJSON_Delete(json);
             return ESP_FAIL;
         }
+        err = eth_json_token_copy_string(&raw, signed_tx, signed_tx_len);
     } else {
         ESP_LOGE(TAG, "Result field is neither string nor object");
-        cJSON_Delete(json);
         return ESP_FAIL;
     }
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Signed transaction does not fit in buffer");
+        return err;
+    }
     
     ESP_LOGI(TAG, "Transaction signed successfully");
-    
-    cJSON_Delete(json);
     return ESP_OK;
 }
 
@@ -939,69 +539,38 @@ esp_err_t eth_sendRawTransaction(web3_context_t* context, const char* signed_dat
         return ESP_ERR_INVALID_ARG;
     }
 
-    // 确保签名数据以0x开头
-    char* data_to_send;
-    if (strncmp(signed_data, "0x", 2) != 0) {
-        // 添加0x前缀
-        data_to_send = malloc(strlen(signed_data) + 3); // +3 for "0x" and null terminator
-        if (!data_to_send) {
+    // 直接构造参数，缺少0x前缀时顺便补上; 签名数据较长时才按实际大小分配
+    const char* prefix = strncmp(signed_data, "0x", 2) != 0 ? "0x" : "";
+    size_t params_len = strlen(signed_data) + 7; // [" + 0x + "] + '\0'
+    char stack_params[1024];
+    char* params = stack_params;
+    if (params_len > sizeof(stack_params)) {
+        params = malloc(params_len);
+        if (!params) {
             ESP_LOGE(TAG, "Failed to allocate memory for signed data");
             return ESP_ERR_NO_MEM;
         }
-        sprintf(data_to_send, "0x%s", signed_data);
-    } else {
-        data_to_send = strdup(signed_data);
-        if (!data_to_send) {
-            ESP_LOGE(TAG, "Failed to duplicate signed data");
-            return ESP_ERR_NO_MEM;
-        }
     }
-
-    // 构造参数
-    char params[1024]; // 足够大的缓冲区来容纳签名数据
-    snprintf(params, sizeof(params), "[\"%s\"]", data_to_send);
-    free(data_to_send); // 释放临时缓冲区
+    snprintf(params, params_len, "[\"%s%s\"]", prefix, signed_data);
 
     // 发送RPC请求
     char result[512] = {0};
     esp_err_t err = web3_send_request(context, "eth_sendRawTransaction", params, result, sizeof(result));
+    if (params != stack_params) {
+        free(params);
+    }
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to send raw transaction: %s", esp_err_to_name(err));
         return err;
     }
 
-    // 解析JSON响应
-    cJSON* json = cJSON_Parse(result);
-    if (!json) {
-        ESP_LOGE(TAG, "Failed to parse JSON response");
-        return ESP_FAIL;
-    }
-
     // 获取交易哈希（结果字段）
-    cJSON* result_obj = cJSON_GetObjectItem(json, "result");
-    if (!result_obj || !cJSON_IsString(result_obj)) {
-        ESP_LOGE(TAG, "Invalid or missing 'result' field in response");
-        
-        // 检查是否有错误信息
-        cJSON* error_obj = cJSON_GetObjectItem(json, "error");
-        if (error_obj) {
-            cJSON* error_message = cJSON_GetObjectItem(error_obj, "message");
-            if (error_message && cJSON_IsString(error_message)) {
-                ESP_LOGE(TAG, "Error from Ethereum node: %s", error_message->valuestring);
-            }
-        }
-        
-        cJSON_Delete(json);
-        return ESP_FAIL;
+    err = copy_result_string(result, tx_hash, tx_hash_len);
+    if (err != ESP_OK) {
+        return err;
     }
-
-    // 复制交易哈希到输出参数
-    strncpy(tx_hash, result_obj->valuestring, tx_hash_len - 1);
-    tx_hash[tx_hash_len - 1] = '\0'; // 确保字符串以null字符结尾
     
     ESP_LOGI(TAG, "Transaction sent successfully, hash: %s", tx_hash);
-    
-    cJSON_Delete(json);
     return ESP_OK;
 }
 
@@ -1016,60 +585,60 @@ esp_err_t eth_getCode(web3_context_t* context, const char* address,
     char params[256];
     snprintf(params, sizeof(params), "[\"%s\", \"%s\"]", address, block_id);
 
-    // 发送RPC请求
-    char result[4096] = {0}; // 较大的缓冲区以容纳合约代码
-    esp_err_t err = web3_send_request(context, "eth_getCode", params, result, sizeof(result));
+    // 合约代码大小差别很大，响应放入可增长缓冲区 (优先PSRAM)，不再受栈上数组限制
+    web3_response_sink_t sink;
+    web3_sink_init_growable(&sink, 0);
+    esp_err_t err = web3_send_request_sink(context, "eth_getCode", params, &sink);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "eth_getCode request failed: %s", esp_err_to_name(err));
+        web3_sink_free(&sink);
         return err;
     }
 
-    // 解析JSON响应
-    cJSON* json = cJSON_Parse(result);
-    if (!json) {
-        ESP_LOGE(TAG, "Failed to parse JSON response");
-        return ESP_FAIL;
-    }
-
     // 获取返回的合约代码
-    cJSON* result_obj = cJSON_GetObjectItem(json, "result");
-    if (!result_obj) {
-        ESP_LOGE(TAG, "No 'result' field in JSON response");
-        
-        // 检查是否有错误信息
-        cJSON* error_obj = cJSON_GetObjectItem(json, "error");
-        if (error_obj) {
-            cJSON* error_message = cJSON_GetObjectItem(error_obj, "message");
-            if (error_message && cJSON_IsString(error_message)) {
-                ESP_LOGE(TAG, "Error from Ethereum node: %s", error_message->valuestring);
-            }
-        }
-        
-        cJSON_Delete(json);
-        return ESP_FAIL;
+    eth_json_token_t result_tok;
+    err = parse_rpc_result(sink.buffer, &result_tok);
+    if (err != ESP_OK) {
+        web3_sink_free(&sink);
+        return err;
     }
 
     // 检查返回的代码
-    if (cJSON_IsString(result_obj)) {
+    if (result_tok.type == ETH_JSON_STRING) {
         // 复制合约代码到输出缓冲区
-        if (strlen(result_obj->valuestring) < code_len) {
-            strcpy(code, result_obj->valuestring);
-        } else {
+        if (eth_json_token_copy_string(&result_tok, code, code_len) == ESP_ERR_INVALID_SIZE) {
             ESP_LOGW(TAG, "Contract code truncated (too large for buffer)");
-            strncpy(code, result_obj->valuestring, code_len - 1);
-            code[code_len - 1] = '\0'; // 确保字符串以null字符结尾
         }
-    } else if (cJSON_IsNull(result_obj)) {
+    } else if (result_tok.type == ETH_JSON_NULL) {
         // 没有代码（可能是普通账户，不是合约）
-        strcpy(code, "0x");
+        strncpy(code, "0x", code_len - 1);
+        code[code_len - 1] = '\0';
     } else {
         ESP_LOGE(TAG, "Result field is neither string nor null");
-        cJSON_Delete(json);
-        return ESP_FAIL;
+        err = ESP_FAIL;
     }
     
-    cJSON_Delete(json);
-    return ESP_OK;
+    web3_sink_free(&sink);
+    return err;
+}
+
+// 构造eth_call参数: [{"to":"合约地址", "data":"函数调用数据"}, "区块号"]
+// 调用数据较长时 (如带动态参数的调用) 按实际大小分配，返回的指针不等于stack_params时需要free
+static char* build_call_params(const char* to_address, const char* data, const char* block,
+                               char* stack_params, size_t stack_len) {
+    const char* block_id = block ? block : "latest";
+    size_t params_len = strlen(to_address) + strlen(data) + strlen(block_id) + 32;
+    char* params = stack_params;
+    if (params_len > stack_len) {
+        params = malloc(params_len);
+        if (!params) {
+            return NULL;
+        }
+    }
+    snprintf(params, params_len, 
+             "[{\"to\":\"%s\",\"data\":\"%s\"},\"%s\"]", 
+             to_address, data, block_id);
+    return params;
 }
 
 esp_err_t eth_call(web3_context_t* context, const char* to_address, const char* data, 
@@ -1079,55 +648,1022 @@ esp_err_t eth_call(web3_context_t* context, const char* to_address, const char*
         return ESP_ERR_INVALID_ARG;
     }
 
-    // 构造参数: [{"to":"合约地址", "data":"函数调用数据"}, "区块号"]
-    char params[512];
-    snprintf(params, sizeof(params), 
-             "[{\"to\":\"%s\",\"data\":\"%s\"},\"%s\"]", 
-             to_address, data, block ? block : "latest");
+    char stack_params[512];
+    char* params = build_call_params(to_address, data, block, stack_params, sizeof(stack_params));
+    if (!params) {
+        return ESP_ERR_NO_MEM;
+    }
 
-    // 发送RPC请求
-    char response[4096] = {0}; // 较大的缓冲区以容纳可能的大型返回数据
-    esp_err_t err = web3_send_request(context, "eth_call", params, response, sizeof(response));
+    // 返回数据大小取决于合约，响应放入可增长缓冲区
+    web3_response_sink_t sink;
+    web3_sink_init_growable(&sink, 0);
+    esp_err_t err = web3_send_request_sink(context, "eth_call", params, &sink);
+    if (params != stack_params) {
+        free(params);
+    }
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "eth_call request failed: %s", esp_err_to_name(err));
+        web3_sink_free(&sink);
         return err;
     }
 
-    // 解析JSON响应
-    cJSON* json = cJSON_Parse(response);
-    if (!json) {
-        ESP_LOGE(TAG, "Failed to parse JSON response");
-        return ESP_FAIL;
+    // 复制返回值到输出缓冲区
+    err = copy_result_string(sink.buffer, result, result_len);
+    web3_sink_free(&sink);
+    return err;
+}
+
+// eth_call_binary的流式解码状态: 只跟踪顶层对象的键，
+// result字符串中的十六进制字符到达时直接解码进输出缓冲区
+typedef enum {
+    CALL_FIELD_NONE = 0,
+    CALL_FIELD_RESULT,
+    CALL_FIELD_ERROR,
+    CALL_FIELD_OTHER,
+} call_field_t;
+
+typedef struct {
+    uint8_t* out;
+    size_t out_len;
+    size_t written;
+    int depth;
+    bool in_string;
+    bool escape;
+    bool in_key;            // 当前字符串是顶层对象的键
+    bool expect_value;      // 顶层键后的':'已出现，等待值
+    bool in_result;         // 正在解码result字符串
+    call_field_t field;     // 当前顶层值对应的键
+    char key[8];
+    size_t key_len;
+    size_t hex_pos;         // result字符串中已处理的字符数
+    int high_nibble;        // 等待配对的高4位，-1表示无
+    bool result_done;
+    bool error_seen;
+    char error_text[160];   // error对象的原始文本，用于日志
+    size_t error_len;
+    esp_err_t err;
+} call_hex_decoder_t;
+
+// result字符串中的一个字符
+static void call_decoder_result_char(call_hex_decoder_t* dec, char c) {
+    size_t pos = dec->hex_pos++;
+    if (pos < 2 && c == "0x"[pos]) {
+        return;
+    }
+    int nibble = eth_hex_nibble(c);
+    if (nibble < 0) {
+        dec->err = ESP_ERR_INVALID_RESPONSE;
+        return;
     }
+    if (dec->high_nibble < 0) {
+        dec->high_nibble = nibble;
+        return;
+    }
+    if (dec->written >= dec->out_len) {
+        dec->err = ESP_ERR_INVALID_SIZE;
+        return;
+    }
+    dec->out[dec->written++] = (uint8_t)((dec->high_nibble << 4) | nibble);
+    dec->high_nibble = -1;
+}
 
-    // 获取返回值
-    cJSON* result_obj = cJSON_GetObjectItem(json, "result");
-    if (!result_obj) {
-        ESP_LOGE(TAG, "No 'result' field in JSON response");
-        
-        // 检查是否有错误信息
-        cJSON* error_obj = cJSON_GetObjectItem(json, "error");
-        if (error_obj) {
-            cJSON* error_message = cJSON_GetObjectItem(error_obj, "message");
-            if (error_message && cJSON_IsString(error_message)) {
-                ESP_LOGE(TAG, "Error from Ethereum node: %s", error_message->valuestring);
+static void call_decoder_char(call_hex_decoder_t* dec, char c) {
+    int depth_before = dec->depth;
+
+    if (dec->in_string) {
+        if (dec->escape) {
+            dec->escape = false;
+            if (dec->in_result) {
+                dec->err = ESP_ERR_INVALID_RESPONSE;
+            }
+        } else if (c == '\\') {
+            dec->escape = true;
+        } else if (c == '"') {
+            dec->in_string = false;
+            if (dec->in_key) {
+                dec->in_key = false;
+                dec->key[dec->key_len < sizeof(dec->key) ? dec->key_len : sizeof(dec->key) - 1] = '\0';
+            } else if (dec->in_result) {
+                dec->in_result = false;
+                dec->result_done = true;
+                if (dec->high_nibble >= 0) {
+                    dec->err = ESP_ERR_INVALID_RESPONSE;
+                }
+            }
+        } else if (dec->in_key) {
+            if (dec->key_len < sizeof(dec->key)) {
+                dec->key[dec->key_len] = c;
             }
+            dec->key_len++;
+        } else if (dec->in_result) {
+            call_decoder_result_char(dec, c);
+        }
+    } else {
+        switch (c) {
+        case ' ': case '\t': case '\r': case '\n':
+            break;
+        case '"':
+            dec->in_string = true;
+            if (dec->depth == 1 && !dec->expect_value) {
+                dec->in_key = true;
+                dec->key_len = 0;
+            } else if (dec->depth == 1 && dec->expect_value) {
+                dec->expect_value = false;
+                if (dec->field == CALL_FIELD_RESULT) {
+                    dec->in_result = true;
+                    dec->hex_pos = 0;
+                }
+            }
+            break;
+        case ':':
+            if (dec->depth == 1) {
+                dec->expect_value = true;
+                if (dec->key_len == 6 && memcmp(dec->key, "result", 6) == 0) {
+                    dec->field = CALL_FIELD_RESULT;
+                } else if (dec->key_len == 5 && memcmp(dec->key, "error", 5) == 0) {
+                    dec->field = CALL_FIELD_ERROR;
+                    dec->error_seen = true;
+                } else {
+                    dec->field = CALL_FIELD_OTHER;
+                }
+            }
+            break;
+        case ',':
+            if (dec->depth == 1) {
+                dec->field = CALL_FIELD_NONE;
+                dec->expect_value = false;
+            }
+            break;
+        case '{': case '[':
+            dec->depth++;
+            if (depth_before == 1) {
+                dec->expect_value = false;
+                if (dec->field == CALL_FIELD_RESULT) {
+                    dec->err = ESP_ERR_INVALID_RESPONSE;
+                }
+            }
+            break;
+        case '}': case ']':
+            dec->depth--;
+            break;
+        default:
+            // 数字/true/false/null，result必须是字符串
+            if (dec->depth == 1 && dec->expect_value) {
+                dec->expect_value = false;
+                if (dec->field == CALL_FIELD_RESULT) {
+                    dec->err = ESP_ERR_INVALID_RESPONSE;
+                }
+            }
+            break;
         }
-        
-        cJSON_Delete(json);
-        return ESP_FAIL;
     }
 
-    // 复制返回值到输出缓冲区
-    if (cJSON_IsString(result_obj)) {
-        strncpy(result, result_obj->valuestring, result_len - 1);
-        result[result_len - 1] = '\0'; // 确保字符串以null字符结尾
+    // 记录error对象的原始文本 (包括两侧括号)
+    if (dec->field == CALL_FIELD_ERROR && (depth_before >= 2 || dec->depth >= 2) &&
+        dec->error_len < sizeof(dec->error_text) - 1) {
+        dec->error_text[dec->error_len++] = c;
+    }
+}
+
+static esp_err_t call_decoder_write(void* user_ctx, const char* data, size_t len) {
+    call_hex_decoder_t* dec = (call_hex_decoder_t*)user_ctx;
+    size_t i = 0;
+    while (i < len && dec->err == ESP_OK) {
+        // result字符串中段的十六进制按字节对整段解码，其余字符逐个走状态机
+        if (dec->in_result && dec->hex_pos >= 2 && dec->high_nibble < 0) {
+            const char* quote = memchr(data + i, '"', len - i);
+            size_t pairs = (quote ? (size_t)(quote - (data + i)) : len - i) / 2;
+            if (pairs > 0) {
+                if (pairs > dec->out_len - dec->written) {
+                    dec->err = ESP_ERR_INVALID_SIZE;
+                } else if (!eth_hex_decode_raw(data + i, pairs, dec->out + dec->written)) {
+                    dec->err = ESP_ERR_INVALID_RESPONSE;
+                } else {
+                    dec->written += pairs;
+                    dec->hex_pos += pairs * 2;
+                    i += pairs * 2;
+                }
+                continue;
+            }
+        }
+        call_decoder_char(dec, data[i++]);
+    }
+    return dec->err;
+}
+
+// 输出流式解码时记录的节点错误
+static void log_call_error(const call_hex_decoder_t* dec) {
+    char wrapped[sizeof(dec->error_text) + 16];
+    int n = snprintf(wrapped, sizeof(wrapped), "{\"error\":%.*s}", (int)dec->error_len, dec->error_text);
+    eth_rpc_response_t resp;
+    if (eth_json_parse_response(wrapped, n, &resp) == ESP_OK && resp.error_message.type == ETH_JSON_STRING) {
+        ESP_LOGE(TAG, "Error from Ethereum node (%lld): %.*s", (long long)resp.error_code,
+                 (int)resp.error_message.len, resp.error_message.start);
     } else {
-        ESP_LOGE(TAG, "Result field is not a string");
-        cJSON_Delete(json);
-        return ESP_FAIL;
+        ESP_LOGE(TAG, "Error from Ethereum node: %.*s", (int)dec->error_len, dec->error_text);
+    }
+}
+
+// 发送eth_call请求，result字段流式解码到二进制缓冲区
+// body不为NULL时直接发送预先生成的请求体，否则用params构造请求
+static esp_err_t call_binary_send(web3_context_t* context, const char* params, char* body, size_t body_len,
+                                  uint8_t* result, size_t result_len, size_t* bytes_written)
+{
+    // 解码状态约250字节，放在栈上，每次调用不做堆分配
+    call_hex_decoder_t decoder = {
+        .out = result,
+        .out_len = result_len,
+        .high_nibble = -1,
+        .err = ESP_OK,
+    };
+    call_hex_decoder_t* dec = &decoder;
+
+    web3_response_sink_t sink;
+    web3_sink_init_stream(&sink, call_decoder_write, dec);
+    esp_err_t err = body ? web3_send_body_sink(context, body, body_len, &sink)
+                         : web3_send_request_sink(context, "eth_call", params, &sink);
+
+    if (err == ESP_OK && dec->error_seen) {
+        log_call_error(dec);
+        err = ESP_FAIL;
+    } else if (err == ESP_OK && (!dec->result_done || dec->depth != 0)) {
+        ESP_LOGE(TAG, "No complete 'result' field in eth_call response");
+        err = ESP_ERR_INVALID_RESPONSE;
+    } else if (err == ESP_ERR_INVALID_SIZE) {
+        ESP_LOGE(TAG, "eth_call result larger than buffer (%d bytes)", (int)result_len);
+    } else if (err != ESP_OK) {
+        ESP_LOGE(TAG, "eth_call request failed: %s", esp_err_to_name(err));
+    }
+
+    if (err == ESP_OK) {
+        *bytes_written = dec->written;
+    }
+    return err;
+}
+
+static esp_err_t call_binary_with_params(web3_context_t* context, const char* params,
+                                         uint8_t* result, size_t result_len, size_t* bytes_written)
+{
+    return call_binary_send(context, params, NULL, 0, result, result_len, bytes_written);
+}
+
+esp_err_t eth_call_binary(web3_context_t* context, const char* to_address, const char* data,
+                          const char* block, uint8_t* result, size_t result_len, size_t* bytes_written)
+{
+    if (!context || !to_address || !data || !result || !bytes_written) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *bytes_written = 0;
+
+    char stack_params[512];
+    char* params = build_call_params(to_address, data, block, stack_params, sizeof(stack_params));
+    if (!params) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t err = call_binary_with_params(context, params, result, result_len, bytes_written);
+    if (params != stack_params) {
+        free(params);
+    }
+    return err;
+}
+
+/* ---------------- 类型化接口 ---------------- */
+
+// 将"0x..."数量形式的result解析为uint256
+static esp_err_t parse_quantity_result(const char *response, uint256_t *value)
+{
+    eth_json_token_t result_tok;
+    esp_err_t err = parse_rpc_result(response, &result_tok);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+    if (result_tok.type != ETH_JSON_STRING ||
+        uint256_from_hex(result_tok.start, result_tok.len, value) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Result is not a hex quantity: %.*s", (int)result_tok.len, result_tok.start);
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t parse_quantity_result_u64(const char *response, uint64_t *value)
+{
+    uint256_t v;
+    esp_err_t err = parse_quantity_result(response, &v);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+    if (!uint256_to_u64(&v, value))
+    {
+        ESP_LOGE(TAG, "Quantity does not fit in 64 bits");
+        return ESP_ERR_INVALID_SIZE;
+    }
+    return ESP_OK;
+}
+
+// 构造 ["0x地址", "latest"] 形式的参数
+static void build_address_params(const eth_address_t address, char *params, size_t params_len)
+{
+    char address_hex[ETH_ADDRESS_HEX_LEN];
+    eth_address_to_hex(address, address_hex);
+    snprintf(params, params_len, "[\"%s\",\"latest\"]", address_hex);
+}
+
+esp_err_t eth_rpc_get_balance(web3_context_t *context, const eth_address_t address, uint256_t *balance)
+{
+    if (!context || !address || !balance)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    char params[64];
+    build_address_params(address, params, sizeof(params));
+
+    char result[256];
+    esp_err_t err = web3_send_request(context, "eth_getBalance", params, result, sizeof(result));
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+    return parse_quantity_result(result, balance);
+}
+
+esp_err_t eth_rpc_get_gas_price(web3_context_t *context, uint256_t *gas_price)
+{
+    if (!context || !gas_price)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    char result[256];
+    esp_err_t err = web3_send_request(context, "eth_gasPrice", NULL, result, sizeof(result));
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+    return parse_quantity_result(result, gas_price);
+}
+
+esp_err_t eth_rpc_get_transaction_count(web3_context_t *context, const eth_address_t address, uint64_t *nonce)
+{
+    if (!context || !address || !nonce)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    char params[64];
+    build_address_params(address, params, sizeof(params));
+
+    char result[256];
+    esp_err_t err = web3_send_request(context, "eth_getTransactionCount", params, result, sizeof(result));
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+    return parse_quantity_result_u64(result, nonce);
+}
+
+esp_err_t eth_rpc_get_nonce_and_gas_price(web3_context_t *context, const eth_address_t address,
+                                          uint64_t *nonce, uint256_t *gas_price)
+{
+    if (!context || !address || !nonce || !gas_price)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    char params[64];
+    build_address_params(address, params, sizeof(params));
+
+    char nonce_response[256];
+    char gas_price_response[256];
+    web3_batch_entry_t batch[2] = {
+        { .method = "eth_getTransactionCount", .params = params,
+          .result = nonce_response, .result_len = sizeof(nonce_response) },
+        { .method = "eth_gasPrice", .params = NULL,
+          .result = gas_price_response, .result_len = sizeof(gas_price_response) },
+    };
+    esp_err_t err = web3_send_batch(context, batch, 2);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    err = batch[0].err;
+    if (err == ESP_OK)
+    {
+        err = parse_quantity_result_u64(nonce_response, nonce);
+    }
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to get nonce: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    err = batch[1].err;
+    if (err == ESP_OK)
+    {
+        err = parse_quantity_result(gas_price_response, gas_price);
+    }
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to get gas price: %s", esp_err_to_name(err));
+    }
+    return err;
+}
+
+esp_err_t eth_rpc_send_raw_transaction(web3_context_t *context, const uint8_t *raw_tx, size_t raw_tx_len,
+                                       eth_hash_t tx_hash)
+{
+    if (!context || !raw_tx || raw_tx_len == 0 || !tx_hash)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // ["0x..."]，交易较大时才按实际大小分配
+    size_t params_len = raw_tx_len * 2 + 7;
+    char stack_params[1024];
+    char *params = stack_params;
+    if (params_len > sizeof(stack_params))
+    {
+        params = malloc(params_len);
+        if (!params)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    memcpy(params, "[\"0x", 4);
+    eth_hex_encode_raw(raw_tx, raw_tx_len, params + 4);
+    memcpy(params + 4 + raw_tx_len * 2, "\"]", 3);
+
+    char result[256];
+    esp_err_t err = web3_send_request(context, "eth_sendRawTransaction", params, result, sizeof(result));
+    if (params != stack_params)
+    {
+        free(params);
+    }
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to send raw transaction: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    eth_json_token_t result_tok;
+    err = parse_rpc_result(result, &result_tok);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    size_t written = 0;
+    if (result_tok.type != ETH_JSON_STRING ||
+        eth_hex_decode(result_tok.start, result_tok.len, tx_hash, ETH_HASH_LEN, &written) != ESP_OK ||
+        written != ETH_HASH_LEN)
+    {
+        ESP_LOGE(TAG, "Invalid transaction hash in response");
+        return ESP_ERR_INVALID_RESPONSE;
     }
-    
-    cJSON_Delete(json);
     return ESP_OK;
 }
+
+// eth_call参数 [{"to":"0x地址","data":"0x调用数据"},"latest"]，调用数据直接编码进参数缓冲区
+// 放得下时写入stack_buf，否则分配 (调用者在返回值不等于stack_buf时free)
+#define RPC_CALL_DATA_KEY "\",\"data\":\"0x"
+
+static char *build_rpc_call_params(const eth_address_t to, const uint8_t *data, size_t data_len,
+                                   char *stack_buf, size_t stack_len)
+{
+    static const char head[] = "[{\"to\":\"0x";
+    static const char mid[] = RPC_CALL_DATA_KEY;
+    static const char tail[] = "\"},\"latest\"]";
+    size_t params_len = sizeof(head) - 1 + ETH_ADDRESS_LEN * 2 + sizeof(mid) - 1 + data_len * 2 + sizeof(tail);
+    char *params = stack_buf;
+    if (params_len > stack_len)
+    {
+        params = malloc(params_len);
+        if (!params)
+        {
+            return NULL;
+        }
+    }
+
+    char *p = params;
+    memcpy(p, head, sizeof(head) - 1);
+    p += sizeof(head) - 1;
+    eth_hex_encode_raw(to, ETH_ADDRESS_LEN, p);
+    p += ETH_ADDRESS_LEN * 2;
+    memcpy(p, mid, sizeof(mid) - 1);
+    p += sizeof(mid) - 1;
+    eth_hex_encode_raw(data, data_len, p);
+    p += data_len * 2;
+    memcpy(p, tail, sizeof(tail));
+    return params;
+}
+
+esp_err_t eth_rpc_call(web3_context_t *context, const eth_address_t to, const uint8_t *data, size_t data_len,
+                       uint8_t *result, size_t result_len, size_t *bytes_written)
+{
+    if (!context || !to || (!data && data_len > 0) || !result || !bytes_written)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *bytes_written = 0;
+
+    char stack_params[512];
+    char *params = build_rpc_call_params(to, data, data_len, stack_params, sizeof(stack_params));
+    if (!params)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t err = call_binary_with_params(context, params, result, result_len, bytes_written);
+    if (params != stack_params)
+    {
+        free(params);
+    }
+    return err;
+}
+
+esp_err_t eth_rpc_get_transaction_receipt(web3_context_t *context, const eth_hash_t tx_hash, eth_receipt_t *receipt)
+{
+    if (!context || !tx_hash || !receipt)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(receipt, 0, sizeof(*receipt));
+
+    char hash_hex[ETH_HASH_HEX_LEN];
+    eth_hash_to_hex(tx_hash, hash_hex);
+    char params[ETH_HASH_HEX_LEN + 8];
+    snprintf(params, sizeof(params), "[\"%s\"]", hash_hex);
+
+    // 收据包含日志，大小不定，使用可增长缓冲区
+    web3_response_sink_t sink;
+    web3_sink_init_growable(&sink, 0);
+    esp_err_t err = web3_send_request_sink(context, "eth_getTransactionReceipt", params, &sink);
+    if (err != ESP_OK)
+    {
+        web3_sink_free(&sink);
+        return err;
+    }
+
+    eth_json_token_t result_tok;
+    err = parse_rpc_result(sink.buffer, &result_tok);
+    if (err == ESP_OK && result_tok.type == ETH_JSON_OBJECT)
+    {
+        eth_json_token_t field;
+        uint64_t status = 0;
+        receipt->found = true;
+        if (eth_json_object_get(&result_tok, "status", &field) == ESP_OK &&
+            eth_json_token_to_uint64(&field, &status) == ESP_OK)
+        {
+            receipt->success = status == 1;
+        }
+        if (eth_json_object_get(&result_tok, "blockNumber", &field) == ESP_OK)
+        {
+            eth_json_token_to_uint64(&field, &receipt->block_number);
+        }
+        if (eth_json_object_get(&result_tok, "gasUsed", &field) == ESP_OK)
+        {
+            eth_json_token_to_uint64(&field, &receipt->gas_used);
+        }
+    }
+    else if (err == ESP_OK && result_tok.type != ETH_JSON_NULL)
+    {
+        ESP_LOGE(TAG, "Unexpected receipt result type");
+        err = ESP_ERR_INVALID_RESPONSE;
+    }
+
+    web3_sink_free(&sink);
+    return err;
+}
+
+/* ---------------- 事件日志 ---------------- */
+
+// 地址、4个topic和两个区块号全部给出时约420字节
+#define LOG_FILTER_PARAMS_LEN 512
+
+static char *append_block_tag(char *p, const char *key, uint64_t block)
+{
+    if (block == ETH_BLOCK_LATEST)
+    {
+        return p + sprintf(p, ",\"%s\":\"latest\"", key);
+    }
+    return p + sprintf(p, ",\"%s\":\"0x%llx\"", key, (unsigned long long)block);
+}
+
+// 写入过滤器对象 {"topics":[...],"address":"0x.."}，with_blocks为false时省略区块范围 (logs订阅不支持)
+static char *append_log_filter_object(char *p, const eth_log_filter_t *filter, bool with_blocks)
+{
+    memcpy(p, "{\"topics\":[", 11);
+    p += 11;
+
+    // 末尾不限的topic省略，中间不限的写null
+    size_t topic_count = ETH_LOG_MAX_TOPICS;
+    while (topic_count > 0 && !filter->topics[topic_count - 1])
+    {
+        topic_count--;
+    }
+    for (size_t i = 0; i < topic_count; i++)
+    {
+        if (i > 0)
+        {
+            *p++ = ',';
+        }
+        if (filter->topics[i])
+        {
+            memcpy(p, "\"0x", 3);
+            p += 3;
+            eth_hex_encode_raw(filter->topics[i], ETH_HASH_LEN, p);
+            p += ETH_HASH_LEN * 2;
+            *p++ = '"';
+        }
+        else
+        {
+            memcpy(p, "null", 4);
+            p += 4;
+        }
+    }
+    *p++ = ']';
+
+    if (filter->address)
+    {
+        memcpy(p, ",\"address\":\"0x", 14);
+        p += 14;
+        eth_hex_encode_raw(filter->address, ETH_ADDRESS_LEN, p);
+        p += ETH_ADDRESS_LEN * 2;
+        *p++ = '"';
+    }
+    if (with_blocks)
+    {
+        p = append_block_tag(p, "fromBlock", filter->from_block);
+        p = append_block_tag(p, "toBlock", filter->to_block);
+    }
+    *p++ = '}';
+    return p;
+}
+
+static void build_log_filter_params(const eth_log_filter_t *filter, char params[LOG_FILTER_PARAMS_LEN])
+{
+    char *p = params;
+    *p++ = '[';
+    p = append_log_filter_object(p, filter, true);
+    memcpy(p, "]", 2);
+}
+
+// 解析一条日志，data的十六进制在原位置解码为二进制 (输出总在输入之前，不会覆盖未读的十六进制字符)
+static esp_err_t parse_log_entry(const eth_json_token_t *entry, eth_log_t *log)
+{
+    eth_json_token_t field;
+    size_t written = 0;
+    memset(log, 0, sizeof(*log));
+
+    if (eth_json_object_get(entry, "address", &field) != ESP_OK || field.type != ETH_JSON_STRING ||
+        eth_hex_decode(field.start, field.len, log->address, ETH_ADDRESS_LEN, &written) != ESP_OK ||
+        written != ETH_ADDRESS_LEN)
+    {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+
+    eth_json_token_t topics, topic;
+    const char *cursor = NULL;
+    if (eth_json_object_get(entry, "topics", &topics) != ESP_OK || topics.type != ETH_JSON_ARRAY)
+    {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    while (eth_json_array_next(&topics, &cursor, &topic) == ESP_OK)
+    {
+        if (log->topic_count == ETH_LOG_MAX_TOPICS || topic.type != ETH_JSON_STRING ||
+            eth_hex_decode(topic.start, topic.len, log->topics[log->topic_count], ETH_HASH_LEN, &written) != ESP_OK ||
+            written != ETH_HASH_LEN)
+        {
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+        log->topic_count++;
+    }
+
+    // 待打包的日志没有区块号，保持为0
+    if (eth_json_object_get(entry, "blockNumber", &field) == ESP_OK && field.type == ETH_JSON_STRING)
+    {
+        eth_json_token_to_uint64(&field, &log->block_number);
+    }
+    if (eth_json_object_get(entry, "logIndex", &field) == ESP_OK && field.type == ETH_JSON_STRING)
+    {
+        eth_json_token_to_uint64(&field, &log->log_index);
+    }
+    log->removed = eth_json_object_get(entry, "removed", &field) == ESP_OK && field.type == ETH_JSON_TRUE;
+
+    // data最后解码: 原地写入的二进制会破坏对象文本，之后不能再在entry中查找字段
+    if (eth_json_object_get(entry, "data", &field) != ESP_OK || field.type != ETH_JSON_STRING ||
+        field.len < 2 || field.len % 2 != 0)
+    {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    uint8_t *data = (uint8_t *)field.start;
+    log->data_len = (field.len - 2) / 2;
+    if (!eth_hex_decode_raw(field.start + 2, log->data_len, data))
+    {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    log->data = data;
+    return ESP_OK;
+}
+
+static bool token_contains(const eth_json_token_t *token, const char *needle)
+{
+    size_t n = strlen(needle);
+    for (size_t i = 0; i + n <= token->len; i++)
+    {
+        if (strncasecmp(token->start + i, needle, n) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 发送日志查询并逐条回调；过滤器相关的错误返回ESP_ERR_NOT_FOUND
+static esp_err_t request_logs(web3_context_t *context, const char *method, const char *params,
+                              eth_log_handler_t handler, void *user_ctx, size_t *log_count)
+{
+    size_t count = 0;
+    if (log_count)
+    {
+        *log_count = 0;
+    }
+
+    // 日志数量不定，使用可增长缓冲区；data在缓冲区中原地解码，不再复制
+    web3_response_sink_t sink;
+    web3_sink_init_growable(&sink, 0);
+    esp_err_t err = web3_send_request_sink(context, method, params, &sink);
+    if (err != ESP_OK)
+    {
+        web3_sink_free(&sink);
+        return err;
+    }
+
+    eth_rpc_response_t resp;
+    if (eth_json_parse_response(sink.buffer, sink.length, &resp) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to parse %s response", method);
+        web3_sink_free(&sink);
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    if (resp.result.type != ETH_JSON_ARRAY)
+    {
+        if (resp.error_message.type == ETH_JSON_STRING)
+        {
+            ESP_LOGE(TAG, "%s failed (%lld): %.*s", method, (long long)resp.error_code,
+                     (int)resp.error_message.len, resp.error_message.start);
+        }
+        // 过滤器失效时节点返回"filter not found"之类的错误，部分节点返回null
+        err = ESP_FAIL;
+        if (resp.result.type == ETH_JSON_NULL ||
+            (resp.error_message.type == ETH_JSON_STRING && token_contains(&resp.error_message, "filter")))
+        {
+            err = ESP_ERR_NOT_FOUND;
+        }
+        web3_sink_free(&sink);
+        return err;
+    }
+
+    eth_json_token_t entry;
+    const char *cursor = NULL;
+    while ((err = eth_json_array_next(&resp.result, &cursor, &entry)) == ESP_OK)
+    {
+        eth_log_t log;
+        err = parse_log_entry(&entry, &log);
+        if (err != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Malformed log entry in %s response", method);
+            break;
+        }
+        count++;
+        if (handler && (err = handler(user_ctx, &log)) != ESP_OK)
+        {
+            break;
+        }
+    }
+    if (err == ESP_ERR_NOT_FOUND)
+    {
+        err = ESP_OK;
+    }
+
+    if (log_count)
+    {
+        *log_count = count;
+    }
+    web3_sink_free(&sink);
+    return err;
+}
+
+esp_err_t eth_rpc_get_logs(web3_context_t *context, const eth_log_filter_t *filter,
+                           eth_log_handler_t handler, void *user_ctx, size_t *log_count)
+{
+    if (!context || !filter)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    char params[LOG_FILTER_PARAMS_LEN];
+    build_log_filter_params(filter, params);
+    return request_logs(context, "eth_getLogs", params, handler, user_ctx, log_count);
+}
+
+esp_err_t eth_rpc_new_filter(web3_context_t *context, const eth_log_filter_t *filter,
+                             char filter_id[ETH_FILTER_ID_LEN])
+{
+    if (!context || !filter || !filter_id)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    char params[LOG_FILTER_PARAMS_LEN];
+    build_log_filter_params(filter, params);
+
+    char response[256];
+    esp_err_t err = web3_send_request(context, "eth_newFilter", params, response, sizeof(response));
+    if (err == ESP_OK)
+    {
+        err = copy_result_string(response, filter_id, ETH_FILTER_ID_LEN);
+    }
+    return err;
+}
+
+esp_err_t eth_rpc_get_filter_changes(web3_context_t *context, const char *filter_id,
+                                     eth_log_handler_t handler, void *user_ctx, size_t *log_count)
+{
+    if (!context || !filter_id)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    char params[ETH_FILTER_ID_LEN + 8];
+    snprintf(params, sizeof(params), "[\"%s\"]", filter_id);
+    return request_logs(context, "eth_getFilterChanges", params, handler, user_ctx, log_count);
+}
+
+esp_err_t eth_rpc_uninstall_filter(web3_context_t *context, const char *filter_id)
+{
+    if (!context || !filter_id)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    char params[ETH_FILTER_ID_LEN + 8];
+    snprintf(params, sizeof(params), "[\"%s\"]", filter_id);
+
+    char response[128];
+    return web3_send_request(context, "eth_uninstallFilter", params, response, sizeof(response));
+}
+
+esp_err_t eth_rpc_subscribe_new_heads(web3_context_t *context, web3_subscription_handler_t handler,
+                                      void *user_ctx, char subscription_id[WEB3_SUBSCRIPTION_ID_LEN])
+{
+    return web3_subscribe(context, "[\"newHeads\"]", handler, user_ctx, subscription_id);
+}
+
+esp_err_t eth_rpc_subscribe_logs(web3_context_t *context, const eth_log_filter_t *filter,
+                                 web3_subscription_handler_t handler, void *user_ctx,
+                                 char subscription_id[WEB3_SUBSCRIPTION_ID_LEN])
+{
+    if (!filter)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    char params[LOG_FILTER_PARAMS_LEN];
+    char *p = params;
+    memcpy(p, "[\"logs\",", 8);
+    p += 8;
+    p = append_log_filter_object(p, filter, false);
+    memcpy(p, "]", 2);
+    return web3_subscribe(context, params, handler, user_ctx, subscription_id);
+}
+
+esp_err_t eth_rpc_parse_new_head(char *result, size_t result_len, uint64_t *block_number, eth_hash_t block_hash)
+{
+    if (!result || !block_number)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    eth_json_token_t head, field;
+    size_t written = 0;
+    if (eth_json_parse(result, result_len, &head) != ESP_OK || head.type != ETH_JSON_OBJECT ||
+        eth_json_object_get(&head, "number", &field) != ESP_OK || field.type != ETH_JSON_STRING ||
+        eth_json_token_to_uint64(&field, block_number) != ESP_OK)
+    {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    if (block_hash &&
+        (eth_json_object_get(&head, "hash", &field) != ESP_OK || field.type != ETH_JSON_STRING ||
+         eth_hex_decode(field.start, field.len, block_hash, ETH_HASH_LEN, &written) != ESP_OK ||
+         written != ETH_HASH_LEN))
+    {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t eth_rpc_parse_log(char *result, size_t result_len, eth_log_t *log)
+{
+    if (!result || !log)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    eth_json_token_t entry;
+    if (eth_json_parse(result, result_len, &entry) != ESP_OK || entry.type != ETH_JSON_OBJECT)
+    {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    return parse_log_entry(&entry, log);
+}
+
+/* ---------------- 预生成的调用计划 ---------------- */
+
+esp_err_t eth_call_plan_init(eth_call_plan_t *plan, const eth_address_t to, const uint8_t *data, size_t data_len)
+{
+    if (!plan || !to || (!data && data_len > 0))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(plan, 0, sizeof(*plan));
+
+    char stack_params[512];
+    char *params = build_rpc_call_params(to, data, data_len, stack_params, sizeof(stack_params));
+    if (!params)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t err = web3_render_request("eth_call", params, &plan->body, &plan->body_len);
+    if (params != stack_params)
+    {
+        free(params);
+    }
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // 记录调用数据十六进制在请求体中的位置，之后按字节偏移直接改写
+    const char *key = strstr(plan->body, RPC_CALL_DATA_KEY);
+    if (!key)
+    {
+        eth_call_plan_free(plan);
+        return ESP_ERR_INVALID_STATE;
+    }
+    plan->data_hex = key + sizeof(RPC_CALL_DATA_KEY) - 1 - plan->body;
+    plan->data_len = data_len;
+    return ESP_OK;
+}
+
+esp_err_t eth_call_plan_patch(eth_call_plan_t *plan, size_t offset, const uint8_t *bytes, size_t len)
+{
+    if (!plan || !plan->body || (!bytes && len > 0))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (offset > plan->data_len || len > plan->data_len - offset)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    eth_hex_encode_raw(bytes, len, plan->body + plan->data_hex + offset * 2);
+    return ESP_OK;
+}
+
+esp_err_t eth_call_plan_set_word(eth_call_plan_t *plan, size_t index, const uint8_t word[32])
+{
+    if (index > (SIZE_MAX - 4) / 32 - 1)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    return eth_call_plan_patch(plan, 4 + index * 32, word, 32);
+}
+
+esp_err_t eth_call_plan_execute(web3_context_t *context, const eth_call_plan_t *plan,
+                                uint8_t *result, size_t result_len, size_t *bytes_written)
+{
+    if (!context || !plan || !plan->body || !result || !bytes_written)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *bytes_written = 0;
+
+    return call_binary_send(context, NULL, plan->body, plan->body_len, result, result_len, bytes_written);
+}
+
+void eth_call_plan_free(eth_call_plan_t *plan)
+{
+    if (!plan)
+    {
+        return;
+    }
+    free(plan->body);
+    memset(plan, 0, sizeof(*plan));
+}
@@ -2,7 +2,10 @@
 #define ETH_RPC_H
 
 #include "web3.h"
+#include "eth_types.h"
+#include "eth_uint256.h"
 #include <stdint.h>
+#include <stdbool.h>
 
 /**
  * @brief 获取ETH区块链的当前区块号
@@ -197,4 +200,323 @@ esp_err_t eth_getCode(web3_context_t* context, const char* address,
 esp_err_t eth_call(web3_context_t* context, const char* to_address, const char* data, 
                   const char* block, char* result, size_t result_len);
 
+/**
+ * @brief 调用智能合约函数，返回数据直接解码为二进制
+ *
+ * 响应到达时在HTTP事件处理器中逐块解析，result中的十六进制字符直接写入
+ * 调用者的缓冲区，不保存JSON响应，也不经过中间的十六进制字符串。
+ *
+ * @param context Web3上下文
+ * @param to_address 合约地址
+ * @param data 编码后的函数调用数据
+ * @param block 区块号或状态 ("latest", "earliest", "pending" 或十六进制区块号)
+ * @param result 输出的二进制返回数据
+ * @param result_len 缓冲区长度
+ * @param bytes_written 实际写入的字节数
+ * @return esp_err_t ESP_OK成功，缓冲区不足返回ESP_ERR_INVALID_SIZE，
+ *         响应格式错误返回ESP_ERR_INVALID_RESPONSE，节点返回错误时返回ESP_FAIL
+ */
+esp_err_t eth_call_binary(web3_context_t* context, const char* to_address, const char* data,
+                          const char* block, uint8_t* result, size_t result_len, size_t* bytes_written);
+
+/*
+    类型化接口
+
+    与上面的字符串接口并行: 地址、哈希、数量都以二进制类型传入传出，
+    十六进制只在构造请求和解析响应时出现。
+*/
+
+/**
+ * @brief 交易收据中常用的字段
+ */
+typedef struct {
+    bool found;              // 节点是否返回了收据，false表示交易尚未打包
+    bool success;            // status为0x1
+    uint64_t block_number;   // 所在区块号
+    uint64_t gas_used;       // 实际消耗的gas
+} eth_receipt_t;
+
+/**
+ * @brief 获取账户余额 (最新区块)
+ *
+ * @param context Web3上下文
+ * @param address 账户地址
+ * @param balance 输出的余额 (wei)
+ * @return esp_err_t ESP_OK成功，其他值失败
+ */
+esp_err_t eth_rpc_get_balance(web3_context_t* context, const eth_address_t address, uint256_t* balance);
+
+/**
+ * @brief 获取当前燃料价格
+ *
+ * @param context Web3上下文
+ * @param gas_price 输出的燃料价格 (wei)
+ * @return esp_err_t ESP_OK成功，其他值失败
+ */
+esp_err_t eth_rpc_get_gas_price(web3_context_t* context, uint256_t* gas_price);
+
+/**
+ * @brief 获取账户已发送的交易数量 (即下一笔交易的nonce)
+ *
+ * @param context Web3上下文
+ * @param address 账户地址
+ * @param nonce 输出的交易数量
+ * @return esp_err_t ESP_OK成功，其他值失败
+ */
+esp_err_t eth_rpc_get_transaction_count(web3_context_t* context, const eth_address_t address, uint64_t* nonce);
+
+/**
+ * @brief 在一次批量请求中同时获取nonce和燃料价格 (发送交易前使用)
+ *
+ * @param context Web3上下文
+ * @param address 发送账户地址
+ * @param nonce 输出的nonce
+ * @param gas_price 输出的燃料价格 (wei)
+ * @return esp_err_t ESP_OK成功，任一结果失败时返回对应的错误
+ */
+esp_err_t eth_rpc_get_nonce_and_gas_price(web3_context_t* context, const eth_address_t address,
+                                          uint64_t* nonce, uint256_t* gas_price);
+
+/**
+ * @brief 发送已签名的原始交易
+ *
+ * @param context Web3上下文
+ * @param raw_tx RLP编码的已签名交易
+ * @param raw_tx_len 交易长度
+ * @param tx_hash 输出的交易哈希
+ * @return esp_err_t ESP_OK成功，其他值失败
+ */
+esp_err_t eth_rpc_send_raw_transaction(web3_context_t* context, const uint8_t* raw_tx, size_t raw_tx_len,
+                                       eth_hash_t tx_hash);
+
+/**
+ * @brief 调用合约函数 (最新区块)，返回数据直接解码为二进制
+ *
+ * @param context Web3上下文
+ * @param to 合约地址
+ * @param data ABI编码的调用数据
+ * @param data_len 调用数据长度
+ * @param result 输出的返回数据
+ * @param result_len 缓冲区长度
+ * @param bytes_written 实际写入的字节数
+ * @return esp_err_t ESP_OK成功，缓冲区不足返回ESP_ERR_INVALID_SIZE，其他值失败
+ */
+esp_err_t eth_rpc_call(web3_context_t* context, const eth_address_t to, const uint8_t* data, size_t data_len,
+                       uint8_t* result, size_t result_len, size_t* bytes_written);
+
+/**
+ * @brief 查询交易收据
+ *
+ * @param context Web3上下文
+ * @param tx_hash 交易哈希
+ * @param receipt 输出的收据字段，交易未打包时receipt->found为false且返回ESP_OK
+ * @return esp_err_t ESP_OK成功，其他值失败
+ */
+esp_err_t eth_rpc_get_transaction_receipt(web3_context_t* context, const eth_hash_t tx_hash, eth_receipt_t* receipt);
+
+/*
+    事件日志
+
+    eth_getLogs按区块范围查询，eth_newFilter在节点上安装过滤器后用eth_getFilterChanges
+    只取新增日志。两者的结果都逐条交给回调，日志的data在响应缓冲区中原地解码为二进制，
+    回调返回后失效。
+*/
+
+#define ETH_LOG_MAX_TOPICS   4
+#define ETH_BLOCK_LATEST     UINT64_MAX  // 区块范围使用"latest"
+#define ETH_FILTER_ID_LEN    67          // "0x" + 最多64个十六进制字符 + '\0'
+
+/**
+ * @brief 日志过滤条件
+ */
+typedef struct {
+    const uint8_t* address;                      // 合约地址 (ETH_ADDRESS_LEN字节)，NULL表示不限
+    const uint8_t* topics[ETH_LOG_MAX_TOPICS];   // 各位置的topic (ETH_HASH_LEN字节)，NULL表示不限
+    uint64_t from_block;                         // 起始区块 (包含)，ETH_BLOCK_LATEST表示最新区块
+    uint64_t to_block;                           // 结束区块 (包含)，ETH_BLOCK_LATEST表示最新区块
+} eth_log_filter_t;
+
+/**
+ * @brief 一条事件日志
+ */
+typedef struct {
+    eth_address_t address;                       // 产生日志的合约
+    eth_hash_t topics[ETH_LOG_MAX_TOPICS];       // topic0为事件签名哈希，其后为indexed参数
+    size_t topic_count;                          // topic个数
+    const uint8_t* data;                         // 非indexed参数的ABI编码 (指向响应缓冲区)
+    size_t data_len;                             // data长度
+    uint64_t block_number;                       // 所在区块号
+    uint64_t log_index;                          // 在区块中的序号
+    bool removed;                                // 因链重组被移除
+} eth_log_t;
+
+/**
+ * @brief 日志回调
+ *
+ * @return esp_err_t 返回非ESP_OK时停止遍历，查询函数返回该错误
+ */
+typedef esp_err_t (*eth_log_handler_t)(void* user_ctx, const eth_log_t* log);
+
+/**
+ * @brief 查询匹配的日志 (eth_getLogs)
+ *
+ * @param context Web3上下文
+ * @param filter 过滤条件
+ * @param handler 每条日志调用一次
+ * @param user_ctx 回调的用户上下文
+ * @param log_count 输出的日志条数 (可为NULL)
+ * @return esp_err_t ESP_OK成功，响应格式错误返回ESP_ERR_INVALID_RESPONSE，其他值失败
+ */
+esp_err_t eth_rpc_get_logs(web3_context_t* context, const eth_log_filter_t* filter,
+                           eth_log_handler_t handler, void* user_ctx, size_t* log_count);
+
+/**
+ * @brief 在节点上安装日志过滤器 (eth_newFilter)
+ *
+ * @param context Web3上下文
+ * @param filter 过滤条件
+ * @param filter_id 输出的过滤器ID
+ * @return esp_err_t ESP_OK成功，节点不支持过滤器时返回ESP_FAIL
+ */
+esp_err_t eth_rpc_new_filter(web3_context_t* context, const eth_log_filter_t* filter,
+                             char filter_id[ETH_FILTER_ID_LEN]);
+
+/**
+ * @brief 取出过滤器自上次查询以来的新日志 (eth_getFilterChanges)
+ *
+ * @param context Web3上下文
+ * @param filter_id eth_rpc_new_filter返回的ID
+ * @param handler 每条日志调用一次
+ * @param user_ctx 回调的用户上下文
+ * @param log_count 输出的日志条数 (可为NULL)
+ * @return esp_err_t ESP_OK成功，过滤器已失效 (超时被节点回收或节点重启) 返回ESP_ERR_NOT_FOUND，
+ *         其他值失败
+ */
+esp_err_t eth_rpc_get_filter_changes(web3_context_t* context, const char* filter_id,
+                                     eth_log_handler_t handler, void* user_ctx, size_t* log_count);
+
+/**
+ * @brief 卸载过滤器 (eth_uninstallFilter)
+ *
+ * @return esp_err_t ESP_OK成功，其他值失败
+ */
+esp_err_t eth_rpc_uninstall_filter(web3_context_t* context, const char* filter_id);
+
+/*
+    WebSocket订阅 (web3_init使用ws://或wss://地址时可用)
+
+    void on_head(void* ctx, char* result, size_t len) {
+        uint64_t number;
+        if (eth_rpc_parse_new_head(result, len, &number, NULL) == ESP_OK) { ... }
+    }
+    char sub_id[WEB3_SUBSCRIPTION_ID_LEN];
+    eth_rpc_subscribe_new_heads(ctx, on_head, NULL, sub_id);
+
+    回调在WebSocket接收任务中执行，应尽快返回 (例如只释放信号量)，
+    不能在回调中发起新的请求。
+*/
+
+/**
+ * @brief 订阅新区块 (eth_subscribe "newHeads")
+ *
+ * @return esp_err_t ESP_OK成功，HTTP传输返回ESP_ERR_NOT_SUPPORTED，其他值失败
+ */
+esp_err_t eth_rpc_subscribe_new_heads(web3_context_t* context, web3_subscription_handler_t handler,
+                                      void* user_ctx, char subscription_id[WEB3_SUBSCRIPTION_ID_LEN]);
+
+/**
+ * @brief 订阅事件日志 (eth_subscribe "logs")，忽略filter的区块范围
+ *
+ * @return esp_err_t ESP_OK成功，HTTP传输返回ESP_ERR_NOT_SUPPORTED，其他值失败
+ */
+esp_err_t eth_rpc_subscribe_logs(web3_context_t* context, const eth_log_filter_t* filter,
+                                 web3_subscription_handler_t handler, void* user_ctx,
+                                 char subscription_id[WEB3_SUBSCRIPTION_ID_LEN]);
+
+/**
+ * @brief 解析newHeads通知中的区块头
+ *
+ * @param result 通知的result文本
+ * @param result_len 文本长度
+ * @param block_number 输出的区块号
+ * @param block_hash 输出的区块哈希，可为NULL
+ * @return esp_err_t ESP_OK成功，格式错误返回ESP_ERR_INVALID_RESPONSE
+ */
+esp_err_t eth_rpc_parse_new_head(char* result, size_t result_len, uint64_t* block_number, eth_hash_t block_hash);
+
+/**
+ * @brief 解析logs通知中的一条日志
+ *
+ * data在result中原地解码，log的指针在回调返回前有效。
+ *
+ * @return esp_err_t ESP_OK成功，格式错误返回ESP_ERR_INVALID_RESPONSE
+ */
+esp_err_t eth_rpc_parse_log(char* result, size_t result_len, eth_log_t* log);
+
+/*
+    预生成的调用计划
+
+    同一个合约调用被反复轮询时 (如每几秒一次的hasChallenge)，完整的eth_call请求体
+    只生成一次；之后参数不变时直接发送，参数变化时只改写对应的十六进制字符，
+    不再重新编码调用数据、十六进制和JSON信封。
+
+    eth_call_plan_t plan;
+    eth_call_plan_init(&plan, contract, calldata, calldata_len);
+    eth_call_plan_execute(ctx, &plan, result, sizeof(result), &result_len);  // 可重复调用
+    eth_call_plan_set_word(&plan, 0, new_arg);  // 改写第0个参数字
+    eth_call_plan_free(&plan);
+
+    只能改写定长部分；调用数据长度变化时需要重新生成计划。
+*/
+
+/**
+ * @brief 预生成的eth_call请求
+ */
+typedef struct {
+    char* body;          // 完整的JSON-RPC请求体 (以'\0'结尾)
+    size_t body_len;     // 请求体长度
+    size_t data_hex;     // 调用数据十六进制 ("0x"之后) 在body中的偏移
+    size_t data_len;     // 调用数据字节数
+} eth_call_plan_t;
+
+/**
+ * @brief 生成调用计划 (最新区块)，请求体一次分配
+ *
+ * @param plan 输出的调用计划
+ * @param to 合约地址
+ * @param data ABI编码的调用数据 (选择器 + 参数)
+ * @param data_len 调用数据长度
+ * @return esp_err_t ESP_OK成功，内存不足返回ESP_ERR_NO_MEM
+ */
+esp_err_t eth_call_plan_init(eth_call_plan_t* plan, const eth_address_t to, const uint8_t* data, size_t data_len);
+
+/**
+ * @brief 改写调用数据中从offset开始的len个字节
+ *
+ * @return esp_err_t ESP_OK成功，超出调用数据范围返回ESP_ERR_INVALID_SIZE
+ */
+esp_err_t eth_call_plan_patch(eth_call_plan_t* plan, size_t offset, const uint8_t* bytes, size_t len);
+
+/**
+ * @brief 改写第index个参数字 (调用数据偏移 4 + 32*index)
+ *
+ * @return esp_err_t ESP_OK成功，超出调用数据范围返回ESP_ERR_INVALID_SIZE
+ */
+esp_err_t eth_call_plan_set_word(eth_call_plan_t* plan, size_t index, const uint8_t word[32]);
+
+/**
+ * @brief 发送调用计划，返回数据直接解码为二进制 (与eth_rpc_call相同)
+ *
+ * 请求体只改写id (每次执行一个新的id) 后交给HTTP客户端，不做编码、复制或分配。
+ *
+ * @return esp_err_t ESP_OK成功，缓冲区不足返回ESP_ERR_INVALID_SIZE，其他值失败
+ */
+esp_err_t eth_call_plan_execute(web3_context_t* context, const eth_call_plan_t* plan,
+                                uint8_t* result, size_t result_len, size_t* bytes_written);
+
+/**
+ * @brief 释放调用计划
+ */
+void eth_call_plan_free(eth_call_plan_t* plan);
+
 #endif /* ETH_RPC_H */
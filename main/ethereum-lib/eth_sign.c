@@ -4,94 +4,322 @@
 #include <stdlib.h>
 #include <esp_log.h>
 
+#include <esp_random.h>
+
 #include <mbedtls/md.h>
-#include <mbedtls/pk.h>
-#include <mbedtls/entropy.h>
-#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/ecp.h>
+#include <mbedtls/bignum.h>
 #include <mbedtls/error.h>
-#include "eth_rpc.h"
+#include <mbedtls/platform_util.h>
+#include "eth_keccak.h"
+#include "eth_abi.h"
 
 static const char *TAG = "ETH_SIGN";
 
-// Hex character to value
-static int hex2int(char ch) {
-    if (ch >= '0' && ch <= '9') return ch - '0';
-    if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
-    if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
-    return -1;
+// mbedtls_ecp_mul needs an RNG for point blinding; it does not affect the result
+static int ecp_blinding_rng(void* ctx, unsigned char* buf, size_t len) {
+    (void)ctx;
+    esp_fill_random(buf, len);
+    return 0;
 }
 
-// Hex string to binary
-static esp_err_t hex_to_binary(const char* hex_str, uint8_t* output, size_t* output_len) {
-    // Skip 0x prefix if present
-    if (strncmp(hex_str, "0x", 2) == 0) {
-        hex_str += 2;
+// RFC 6979 HMAC-SHA256 nonce generator state
+typedef struct {
+    uint8_t k[32];
+    uint8_t v[32];
+    bool retry;
+} rfc6979_state_t;
+
+// K = HMAC_K(V || sep || x || h), V = HMAC_K(V)
+static int rfc6979_update(rfc6979_state_t* st, const mbedtls_md_info_t* md, uint8_t sep,
+                          const uint8_t x[32], const uint8_t h[32]) {
+    uint8_t input[32 + 1 + 32 + 32];
+    size_t input_len = 33;
+    
+    memcpy(input, st->v, 32);
+    input[32] = sep;
+    if (x && h) {
+        memcpy(input + 33, x, 32);
+        memcpy(input + 65, h, 32);
+        input_len = sizeof(input);
     }
     
-    size_t len = strlen(hex_str);
-    if (len % 2 != 0) {
-        ESP_LOGE(TAG, "Invalid hex string length (must be even)");
-        return ESP_ERR_INVALID_ARG;
+    int ret = mbedtls_md_hmac(md, st->k, 32, input, input_len, st->k);
+    if (ret == 0) {
+        ret = mbedtls_md_hmac(md, st->k, 32, st->v, 32, st->v);
     }
+    mbedtls_platform_zeroize(input, sizeof(input));
+    return ret;
+}
+
+// x: private key, h: bits2octets(hash) = (hash mod n), both 32 bytes big-endian
+static int rfc6979_init(rfc6979_state_t* st, const mbedtls_md_info_t* md,
+                        const uint8_t x[32], const uint8_t h[32]) {
+    memset(st->v, 0x01, 32);
+    memset(st->k, 0x00, 32);
+    st->retry = false;
     
-    size_t binary_len = len / 2;
-    if (*output_len < binary_len) {
-        ESP_LOGE(TAG, "Output buffer too small");
-        return ESP_ERR_INVALID_SIZE;
+    int ret = rfc6979_update(st, md, 0x00, x, h);
+    if (ret == 0) {
+        ret = rfc6979_update(st, md, 0x01, x, h);
     }
+    return ret;
+}
+
+// Produce the next candidate k in [1, n-1]
+static int rfc6979_next(rfc6979_state_t* st, const mbedtls_md_info_t* md,
+                        const mbedtls_mpi* n, mbedtls_mpi* k) {
+    int ret;
     
-    for (size_t i = 0; i < binary_len; i++) {
-        int high = hex2int(hex_str[i*2]);
-        int low = hex2int(hex_str[i*2+1]);
+    for (;;) {
+        if (st->retry) {
+            ret = rfc6979_update(st, md, 0x00, NULL, NULL);
+            if (ret != 0) {
+                return ret;
+            }
+        }
+        st->retry = true;
+        
+        // qlen == hlen == 256, so one HMAC block is one candidate
+        ret = mbedtls_md_hmac(md, st->k, 32, st->v, 32, st->v);
+        if (ret != 0) {
+            return ret;
+        }
+        
+        ret = mbedtls_mpi_read_binary(k, st->v, 32);
+        if (ret != 0) {
+            return ret;
+        }
+        
+        if (mbedtls_mpi_cmp_int(k, 1) >= 0 && mbedtls_mpi_cmp_mpi(k, n) < 0) {
+            return 0;
+        }
+    }
+}
+
+// Core secp256k1 signing: deterministic k, low-s, recovery id
+static esp_err_t secp256k1_sign_hash(mbedtls_ecp_group* grp, const mbedtls_mpi* d,
+                                     const uint8_t hash[32], uint8_t signature[65]) {
+    const mbedtls_md_info_t* md = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+    if (!md) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    
+    mbedtls_mpi z, k, r, s, t, half_n;
+    mbedtls_ecp_point R;
+    rfc6979_state_t st;
+    uint8_t x_bytes[32];
+    uint8_t h_bytes[32];
+    uint8_t point[65];
+    size_t point_len = 0;
+    int ret;
+    
+    mbedtls_mpi_init(&z);
+    mbedtls_mpi_init(&k);
+    mbedtls_mpi_init(&r);
+    mbedtls_mpi_init(&s);
+    mbedtls_mpi_init(&t);
+    mbedtls_mpi_init(&half_n);
+    mbedtls_ecp_point_init(&R);
+    
+    // z = hash mod n
+    MBEDTLS_MPI_CHK(mbedtls_mpi_read_binary(&z, hash, 32));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_mod_mpi(&z, &z, &grp->N));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_write_binary(&z, h_bytes, 32));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_write_binary(d, x_bytes, 32));
+    
+    MBEDTLS_MPI_CHK(mbedtls_mpi_copy(&half_n, &grp->N));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_shift_r(&half_n, 1));
+    
+    MBEDTLS_MPI_CHK(rfc6979_init(&st, md, x_bytes, h_bytes));
+    
+    for (;;) {
+        MBEDTLS_MPI_CHK(rfc6979_next(&st, md, &grp->N, &k));
+        
+        // R = k*G
+        MBEDTLS_MPI_CHK(mbedtls_ecp_mul(grp, &R, &k, &grp->G, ecp_blinding_rng, NULL));
+        MBEDTLS_MPI_CHK(mbedtls_ecp_point_write_binary(grp, &R, MBEDTLS_ECP_PF_UNCOMPRESSED,
+                                                       &point_len, point, sizeof(point)));
+        
+        // r = R.x mod n
+        MBEDTLS_MPI_CHK(mbedtls_mpi_read_binary(&t, point + 1, 32));
+        uint8_t recovery_id = (point[64] & 1) | (mbedtls_mpi_cmp_mpi(&t, &grp->N) >= 0 ? 2 : 0);
+        MBEDTLS_MPI_CHK(mbedtls_mpi_mod_mpi(&r, &t, &grp->N));
+        if (mbedtls_mpi_cmp_int(&r, 0) == 0) {
+            continue;
+        }
+        
+        // s = k^-1 * (z + r*d) mod n
+        MBEDTLS_MPI_CHK(mbedtls_mpi_mul_mpi(&t, &r, d));
+        MBEDTLS_MPI_CHK(mbedtls_mpi_add_mpi(&t, &t, &z));
+        MBEDTLS_MPI_CHK(mbedtls_mpi_mod_mpi(&t, &t, &grp->N));
+        MBEDTLS_MPI_CHK(mbedtls_mpi_inv_mod(&s, &k, &grp->N));
+        MBEDTLS_MPI_CHK(mbedtls_mpi_mul_mpi(&s, &s, &t));
+        MBEDTLS_MPI_CHK(mbedtls_mpi_mod_mpi(&s, &s, &grp->N));
+        if (mbedtls_mpi_cmp_int(&s, 0) == 0) {
+            continue;
+        }
         
-        if (high < 0 || low < 0) {
-            ESP_LOGE(TAG, "Invalid hex character at position %d", i*2);
-            return ESP_ERR_INVALID_ARG;
+        // Ethereum only accepts low-s signatures (EIP-2); negating s flips R.y parity
+        if (mbedtls_mpi_cmp_mpi(&s, &half_n) > 0) {
+            MBEDTLS_MPI_CHK(mbedtls_mpi_sub_mpi(&s, &grp->N, &s));
+            recovery_id ^= 1;
         }
         
-        output[i] = (high << 4) | low;
+        MBEDTLS_MPI_CHK(mbedtls_mpi_write_binary(&r, signature, 32));
+        MBEDTLS_MPI_CHK(mbedtls_mpi_write_binary(&s, signature + 32, 32));
+        signature[64] = recovery_id;
+        break;
     }
     
-    *output_len = binary_len;
+cleanup:
+    mbedtls_platform_zeroize(&st, sizeof(st));
+    mbedtls_platform_zeroize(x_bytes, sizeof(x_bytes));
+    mbedtls_mpi_free(&z);
+    mbedtls_mpi_free(&k);
+    mbedtls_mpi_free(&r);
+    mbedtls_mpi_free(&s);
+    mbedtls_mpi_free(&t);
+    mbedtls_mpi_free(&half_n);
+    mbedtls_ecp_point_free(&R);
+    
+    if (ret != 0) {
+        ESP_LOGE(TAG, "secp256k1 signing failed: -0x%04x", (unsigned int)-ret);
+        return ESP_FAIL;
+    }
     return ESP_OK;
 }
 
-// Get the Keccak256 hash of a message via RPC
-esp_err_t get_keccak256_via_rpc(web3_context_t* web3_ctx, const uint8_t* message, size_t message_len, uint8_t* hash_out) {
-    if (!web3_ctx || !message || !hash_out) {
+esp_err_t eth_signer_init(eth_signer_t* signer, const char* private_key_hex) {
+    if (!signer || !private_key_hex) {
         return ESP_ERR_INVALID_ARG;
     }
     
-    // Convert the message to hex
-    char* hex_message = malloc(message_len * 2 + 3); // "0x" + hex data + null terminator
-    if (!hex_message) {
-        ESP_LOGE(TAG, "Failed to allocate memory for hex message");
-        return ESP_ERR_NO_MEM;
+    memset(signer, 0, sizeof(*signer));
+    
+    uint8_t key[32];
+    size_t key_len = 0;
+    esp_err_t err = abi_hex_to_binary(private_key_hex, key, sizeof(key), &key_len);
+    if (err != ESP_OK || key_len != sizeof(key)) {
+        ESP_LOGE(TAG, "Invalid private key");
+        mbedtls_platform_zeroize(key, sizeof(key));
+        return ESP_ERR_INVALID_ARG;
     }
     
-    strcpy(hex_message, "0x");
-    for (size_t i = 0; i < message_len; i++) {
-        sprintf(hex_message + 2 + i*2, "%02x", message[i]);
+    mbedtls_ecp_point Q;
+    uint8_t point[65];
+    uint8_t hash[ETH_KECCAK256_HASH_LEN];
+    size_t point_len = 0;
+    int ret;
+    
+    mbedtls_ecp_group_init(&signer->grp);
+    mbedtls_mpi_init(&signer->d);
+    mbedtls_ecp_point_init(&Q);
+    
+    MBEDTLS_MPI_CHK(mbedtls_ecp_group_load(&signer->grp, MBEDTLS_ECP_DP_SECP256K1));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_read_binary(&signer->d, key, sizeof(key)));
+    if (mbedtls_mpi_cmp_int(&signer->d, 1) < 0 || mbedtls_mpi_cmp_mpi(&signer->d, &signer->grp.N) >= 0) {
+        ESP_LOGE(TAG, "Private key out of range");
+        ret = MBEDTLS_ERR_ECP_INVALID_KEY;
+        goto cleanup;
     }
     
-    // Prepare for RPC call to get the hash
-    char hash_hex[70] = {0}; // "0x" + 64 hex chars + null terminator
-    esp_err_t err = eth_get_web3_sha3(web3_ctx, hex_message, hash_hex, sizeof(hash_hex));
-    free(hex_message);
+    // address = keccak256(X || Y)[12..32]
+    MBEDTLS_MPI_CHK(mbedtls_ecp_mul(&signer->grp, &Q, &signer->d, &signer->grp.G, ecp_blinding_rng, NULL));
+    MBEDTLS_MPI_CHK(mbedtls_ecp_point_write_binary(&signer->grp, &Q, MBEDTLS_ECP_PF_UNCOMPRESSED,
+                                                   &point_len, point, sizeof(point)));
+    eth_keccak256(point + 1, 64, hash);
+    memcpy(signer->address, hash + 12, sizeof(signer->address));
+    signer->initialized = true;
     
+cleanup:
+    mbedtls_platform_zeroize(key, sizeof(key));
+    mbedtls_ecp_point_free(&Q);
+    
+    if (ret != 0) {
+        eth_signer_free(signer);
+        return ret == MBEDTLS_ERR_ECP_INVALID_KEY ? ESP_ERR_INVALID_ARG : ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+void eth_signer_free(eth_signer_t* signer) {
+    if (!signer) {
+        return;
+    }
+    
+    // mbedtls_mpi_free zeroizes the limbs before releasing them
+    mbedtls_mpi_free(&signer->d);
+    mbedtls_ecp_group_free(&signer->grp);
+    memset(signer->address, 0, sizeof(signer->address));
+    signer->initialized = false;
+}
+
+esp_err_t eth_signer_sign_hash(eth_signer_t* signer, const uint8_t hash[32], uint8_t signature[65]) {
+    if (!signer || !signer->initialized || !hash || !signature) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    return secp256k1_sign_hash(&signer->grp, &signer->d, hash, signature);
+}
+
+void eth_personal_message_hash(const uint8_t* message, size_t message_len, uint8_t hash[32]) {
+    static const char prefix[] = "\x19" "Ethereum Signed Message:\n";
+    char len_str[20];
+    int len_str_len = snprintf(len_str, sizeof(len_str), "%u", (unsigned int)message_len);
+    
+    eth_keccak256_ctx_t ctx;
+    eth_keccak256_init(&ctx);
+    eth_keccak256_update(&ctx, (const uint8_t*)prefix, sizeof(prefix) - 1);
+    eth_keccak256_update(&ctx, (const uint8_t*)len_str, len_str_len);
+    eth_keccak256_update(&ctx, message, message_len);
+    eth_keccak256_final(&ctx, hash);
+}
+
+esp_err_t eth_signer_sign_personal_message(eth_signer_t* signer, const uint8_t* message,
+                                           size_t message_len, uint8_t signature[65]) {
+    if (!signer || (!message && message_len > 0) || !signature) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    uint8_t hash[ETH_KECCAK256_HASH_LEN];
+    eth_personal_message_hash(message, message_len, hash);
+    
+    esp_err_t err = eth_signer_sign_hash(signer, hash, signature);
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to get hash via RPC: %s", esp_err_to_name(err));
         return err;
     }
     
-    // Convert the hex hash to binary
-    size_t binary_len = 32;
-    err = hex_to_binary(hash_hex, hash_out, &binary_len);
+    // personal_sign uses the pre-EIP-155 recovery byte
+    signature[64] += 27;
+    return ESP_OK;
+}
+
+esp_err_t eth_sign_hash(const char* private_key_hex, const uint8_t hash[32], uint8_t signature[65]) {
+    if (!private_key_hex || !hash || !signature) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    eth_signer_t signer;
+    esp_err_t err = eth_signer_init(&signer, private_key_hex);
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to convert hash hex to binary: %s", esp_err_to_name(err));
         return err;
     }
     
+    err = eth_signer_sign_hash(&signer, hash, signature);
+    eth_signer_free(&signer);
+    return err;
+}
+
+// Get the Keccak256 hash of a message (computed locally, the RPC round trip is no longer needed)
+esp_err_t get_keccak256_via_rpc(web3_context_t* web3_ctx, const uint8_t* message, size_t message_len, uint8_t* hash_out) {
+    (void)web3_ctx;
+    
+    if ((!message && message_len > 0) || !hash_out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    eth_keccak256(message, message_len, hash_out);
     return ESP_OK;
 }
 
@@ -124,7 +352,7 @@ esp_err_t create_personal_message(const uint8_t* message, size_t message_len, ui
     return ESP_OK;
 }
 
-// Simplified implementation that just creates deterministic but valid-looking signatures
+// Sign a message with the Ethereum personal message prefix (EIP-191)
 esp_err_t eth_sign_personal_message(
     const char* private_key_hex, 
     const uint8_t* message, 
@@ -142,35 +370,149 @@ esp_err_t eth_sign_personal_message(
         return ESP_ERR_INVALID_SIZE;
     }
     
-    ESP_LOGI(TAG, "Signing message with simplified ECDSA");
+    eth_signer_t signer;
+    esp_err_t err = eth_signer_init(&signer, private_key_hex);
+    if (err != ESP_OK) {
+        return err;
+    }
     
-    // Create a deterministic signature based on message content
-    // This is a simplified implementation that doesn't do real ECDSA signing
+    err = eth_signer_sign_personal_message(&signer, message, message_len, signature);
+    eth_signer_free(&signer);
+    if (err != ESP_OK) {
+        return err;
+    }
+    
+    *signature_len = 65;
     
-    // R component (32 bytes)
-    for (int i = 0; i < 32; i++) {
-        signature[i] = i + (message_len > i ? message[i] : 0) + private_key_hex[i % 32];
+    ESP_LOGD(TAG, "R: %02x%02x%02x...", signature[0], signature[1], signature[2]);
+    ESP_LOGD(TAG, "S: %02x%02x%02x...", signature[32], signature[33], signature[34]);
+    ESP_LOGD(TAG, "V: %d", signature[64]);
+    
+    return ESP_OK;
+}
+
+// Public key recovery: Q = r^-1 * (s*R - z*G), address = keccak256(Q)[12..32]
+static esp_err_t secp256k1_recover(mbedtls_ecp_group* grp, const uint8_t hash[32],
+                                   const uint8_t rs[64], uint8_t recovery_id, uint8_t address[20]) {
+    mbedtls_mpi r, s, z, x, y, t, r_inv;
+    mbedtls_ecp_point R, Q;
+    uint8_t point[65];
+    uint8_t digest[ETH_KECCAK256_HASH_LEN];
+    size_t point_len = 0;
+    esp_err_t err = ESP_ERR_INVALID_ARG;
+    int ret = 0;
+    
+    mbedtls_mpi_init(&r);
+    mbedtls_mpi_init(&s);
+    mbedtls_mpi_init(&z);
+    mbedtls_mpi_init(&x);
+    mbedtls_mpi_init(&y);
+    mbedtls_mpi_init(&t);
+    mbedtls_mpi_init(&r_inv);
+    mbedtls_ecp_point_init(&R);
+    mbedtls_ecp_point_init(&Q);
+    
+    MBEDTLS_MPI_CHK(mbedtls_mpi_read_binary(&r, rs, 32));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_read_binary(&s, rs + 32, 32));
+    if (mbedtls_mpi_cmp_int(&r, 1) < 0 || mbedtls_mpi_cmp_mpi(&r, &grp->N) >= 0 ||
+        mbedtls_mpi_cmp_int(&s, 1) < 0 || mbedtls_mpi_cmp_mpi(&s, &grp->N) >= 0) {
+        goto cleanup;
     }
     
-    // S component (32 bytes)
-    for (int i = 0; i < 32; i++) {
-        signature[32 + i] = 32 - i + (message_len > i ? message[i] : 0) + private_key_hex[(i + 16) % 32];
+    // R.x = r (+ n when the x coordinate overflowed the group order)
+    MBEDTLS_MPI_CHK(mbedtls_mpi_copy(&x, &r));
+    if (recovery_id & 2) {
+        MBEDTLS_MPI_CHK(mbedtls_mpi_add_mpi(&x, &x, &grp->N));
+        if (mbedtls_mpi_cmp_mpi(&x, &grp->P) >= 0) {
+            goto cleanup;
+        }
     }
     
-    // V component (1 byte) - use standard Ethereum value
-    signature[64] = 27;
+    // y^2 = x^3 + 7; p = 3 mod 4, so y = (y^2)^((p+1)/4)
+    MBEDTLS_MPI_CHK(mbedtls_mpi_mul_mpi(&t, &x, &x));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_mod_mpi(&t, &t, &grp->P));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_mul_mpi(&t, &t, &x));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_add_mpi(&t, &t, &grp->B));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_mod_mpi(&t, &t, &grp->P));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_add_int(&z, &grp->P, 1));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_shift_r(&z, 2));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_exp_mod(&y, &t, &z, &grp->P, NULL));
+    if (mbedtls_mpi_get_bit(&y, 0) != (recovery_id & 1)) {
+        MBEDTLS_MPI_CHK(mbedtls_mpi_sub_mpi(&y, &grp->P, &y));
+    }
     
-    *signature_len = 65;
+    point[0] = 0x04;
+    MBEDTLS_MPI_CHK(mbedtls_mpi_write_binary(&x, point + 1, 32));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_write_binary(&y, point + 33, 32));
+    MBEDTLS_MPI_CHK(mbedtls_ecp_point_read_binary(grp, &R, point, sizeof(point)));
+    if (mbedtls_ecp_check_pubkey(grp, &R) != 0) {
+        // x has no square root: not a point on the curve
+        goto cleanup;
+    }
     
-    ESP_LOGI(TAG, "Generated deterministic signature (length: %d)", *signature_len);
-    ESP_LOGI(TAG, "R: %02x%02x%02x...", signature[0], signature[1], signature[2]);
-    ESP_LOGI(TAG, "S: %02x%02x%02x...", signature[32], signature[33], signature[34]);
-    ESP_LOGI(TAG, "V: %d", signature[64]);
+    // u1 = -z * r^-1 mod n, u2 = s * r^-1 mod n
+    MBEDTLS_MPI_CHK(mbedtls_mpi_inv_mod(&r_inv, &r, &grp->N));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_read_binary(&z, hash, 32));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_mod_mpi(&z, &z, &grp->N));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_sub_mpi(&z, &grp->N, &z));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_mul_mpi(&z, &z, &r_inv));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_mod_mpi(&z, &z, &grp->N));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_mul_mpi(&t, &s, &r_inv));
+    MBEDTLS_MPI_CHK(mbedtls_mpi_mod_mpi(&t, &t, &grp->N));
     
-    return ESP_OK;
+    MBEDTLS_MPI_CHK(mbedtls_ecp_muladd(grp, &Q, &z, &grp->G, &t, &R));
+    if (mbedtls_ecp_is_zero(&Q)) {
+        goto cleanup;
+    }
+    MBEDTLS_MPI_CHK(mbedtls_ecp_point_write_binary(grp, &Q, MBEDTLS_ECP_PF_UNCOMPRESSED,
+                                                   &point_len, point, sizeof(point)));
+    
+    eth_keccak256(point + 1, 64, digest);
+    memcpy(address, digest + 12, 20);
+    err = ESP_OK;
+    
+cleanup:
+    mbedtls_mpi_free(&r);
+    mbedtls_mpi_free(&s);
+    mbedtls_mpi_free(&z);
+    mbedtls_mpi_free(&x);
+    mbedtls_mpi_free(&y);
+    mbedtls_mpi_free(&t);
+    mbedtls_mpi_free(&r_inv);
+    mbedtls_ecp_point_free(&R);
+    mbedtls_ecp_point_free(&Q);
+    
+    if (ret != 0) {
+        ESP_LOGE(TAG, "secp256k1 recovery failed: -0x%04x", (unsigned int)-ret);
+        return ESP_FAIL;
+    }
+    return err;
+}
+
+esp_err_t eth_ecrecover(const uint8_t hash[32], const uint8_t signature[65], uint8_t address[20]) {
+    if (!hash || !signature || !address) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    uint8_t v = signature[64];
+    uint8_t recovery_id = v >= 27 ? v - 27 : v;
+    if (recovery_id > 3) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    mbedtls_ecp_group grp;
+    mbedtls_ecp_group_init(&grp);
+    
+    esp_err_t err = ESP_FAIL;
+    if (mbedtls_ecp_group_load(&grp, MBEDTLS_ECP_DP_SECP256K1) == 0) {
+        err = secp256k1_recover(&grp, hash, signature, recovery_id, address);
+    }
+    
+    mbedtls_ecp_group_free(&grp);
+    return err;
 }
 
-// Placeholder function for Ethereum signature verification
+// Verify a personal message signature by recovering the signer address locally
 esp_err_t eth_verify_personal_message(
     const char* address,
     const uint8_t* message,
@@ -178,11 +520,37 @@ esp_err_t eth_verify_personal_message(
     const uint8_t* signature,
     size_t signature_len
 ) {
-    // Simplified implementation that always returns success
-    ESP_LOGI(TAG, "Signature verification requested (not implemented)");
-    ESP_LOGI(TAG, "Address: %s", address);
-    ESP_LOGI(TAG, "Message length: %d", message_len);
-    ESP_LOGI(TAG, "Signature length: %d", signature_len);
+    if (!address || (!message && message_len > 0) || !signature) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (signature_len != 65) {
+        ESP_LOGE(TAG, "Invalid signature length: %d", (int)signature_len);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    
+    uint8_t expected[20];
+    size_t expected_len = 0;
+    if (abi_hex_to_binary(address, expected, sizeof(expected), &expected_len) != ESP_OK ||
+        expected_len != sizeof(expected)) {
+        ESP_LOGE(TAG, "Invalid address: %s", address);
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    uint8_t hash[ETH_KECCAK256_HASH_LEN];
+    eth_personal_message_hash(message, message_len, hash);
+    
+    uint8_t recovered[20];
+    esp_err_t err = eth_ecrecover(hash, signature, recovered);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Signature recovery failed: %s", esp_err_to_name(err));
+        return err;
+    }
+    
+    if (memcmp(recovered, expected, sizeof(expected)) != 0) {
+        ESP_LOGW(TAG, "Signature does not match address %s", address);
+        return ESP_ERR_INVALID_CRC;
+    }
     
     return ESP_OK;
 }
@@ -2,9 +2,26 @@
 #define ETH_SIGN_H
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <esp_err.h>
+#include <mbedtls/ecp.h>
 #include "web3.h"  // Add this to access web3_context_t
 
+/**
+ * @brief Reusable secp256k1 signer
+ * 
+ * Holds the parsed private key, the loaded curve group and the derived
+ * address so repeated signatures skip hex parsing and group setup. mbedtls
+ * also caches the generator precomputation inside the group after the first
+ * multiplication, which makes every following signature cheaper.
+ */
+typedef struct {
+    mbedtls_ecp_group grp;   // secp256k1 group
+    mbedtls_mpi d;           // Private key scalar
+    uint8_t address[20];     // Address derived from the public key
+    bool initialized;
+} eth_signer_t;
+
 /**
  * @brief Create a personal message with Ethereum prefix
  * 
@@ -22,9 +39,12 @@ esp_err_t create_personal_message(
 );
 
 /**
- * @brief Get the Keccak256 hash via RPC
+ * @brief Get the Keccak256 hash of a message
+ * 
+ * The hash is computed locally with eth_keccak256(); the name is kept for
+ * existing callers and no RPC request is made.
  * 
- * @param web3_ctx Web3 context for making RPC calls
+ * @param web3_ctx Web3 context (unused, may be NULL)
  * @param message The message to hash
  * @param message_len Length of the message
  * @param hash_out Output buffer for the hash (must be 32 bytes)
@@ -37,10 +57,78 @@ esp_err_t get_keccak256_via_rpc(
     uint8_t* hash_out
 );
 
+/**
+ * @brief Initialize a signer from a hex private key
+ * 
+ * @param signer Signer to initialize (release with eth_signer_free)
+ * @param private_key_hex Private key in hex format (with or without 0x prefix)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG for a malformed or out-of-range key
+ */
+esp_err_t eth_signer_init(eth_signer_t* signer, const char* private_key_hex);
+
+/**
+ * @brief Release a signer and wipe its key material
+ * 
+ * @param signer Signer to free
+ */
+void eth_signer_free(eth_signer_t* signer);
+
+/**
+ * @brief Sign a 32-byte hash with an initialized signer
+ * 
+ * @param signer Initialized signer
+ * @param hash 32-byte message hash
+ * @param signature Output: r (32 bytes) || s (32 bytes) || recovery id (0 or 1)
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t eth_signer_sign_hash(eth_signer_t* signer, const uint8_t hash[32], uint8_t signature[65]);
+
+/**
+ * @brief Sign a message as personal_sign / eth_sign does (EIP-191 version 0x45)
+ * 
+ * @param signer Initialized signer
+ * @param message Message to sign
+ * @param message_len Length of the message
+ * @param signature Output: r || s || v with v = 27 + recovery id
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t eth_signer_sign_personal_message(eth_signer_t* signer, const uint8_t* message,
+                                           size_t message_len, uint8_t signature[65]);
+
+/**
+ * @brief Compute the EIP-191 personal message hash without allocating
+ * 
+ * keccak256("\x19Ethereum Signed Message:\n" + len(message) + message)
+ * 
+ * @param message Message bytes
+ * @param message_len Length of the message
+ * @param hash Output buffer for the 32-byte hash
+ */
+void eth_personal_message_hash(const uint8_t* message, size_t message_len, uint8_t hash[32]);
+
+/**
+ * @brief Sign a 32-byte hash with secp256k1
+ * 
+ * One-shot helper that initializes a temporary signer; prefer eth_signer_t
+ * when signing more than once with the same key.
+ * 
+ * The nonce is derived deterministically (RFC 6979, HMAC-SHA256) and s is
+ * normalized to the lower half of the curve order as Ethereum requires.
+ * 
+ * @param private_key_hex Private key in hex format (with or without 0x prefix)
+ * @param hash 32-byte message hash
+ * @param signature Output: r (32 bytes) || s (32 bytes) || recovery id (0 or 1)
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t eth_sign_hash(const char* private_key_hex, const uint8_t hash[32], uint8_t signature[65]);
+
 /**
  * @brief Sign a message using an Ethereum private key
  * 
- * @param private_key_hex Private key in hex format (without 0x prefix)
+ * Produces a real EIP-191 personal_sign signature (v = 27/28). One-shot
+ * wrapper around eth_signer_sign_personal_message().
+ * 
+ * @param private_key_hex Private key in hex format (with or without 0x prefix)
  * @param message Message to sign
  * @param message_len Length of the message
  * @param signature Output buffer for the signature
@@ -57,15 +145,30 @@ esp_err_t eth_sign_personal_message(
     size_t* signature_len
 );
 
+/**
+ * @brief Recover the signer address from a hash and signature (ecrecover)
+ * 
+ * @param hash 32-byte message hash
+ * @param signature r (32 bytes) || s (32 bytes) || v, v may be 0/1 or 27/28
+ * @param address Output: 20-byte address of the signer
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG if the signature is malformed
+ *         or does not correspond to a valid public key
+ */
+esp_err_t eth_ecrecover(const uint8_t hash[32], const uint8_t signature[65], uint8_t address[20]);
+
 /**
  * @brief Verify an Ethereum signature
  * 
- * @param address Ethereum address that supposedly signed the message
+ * Recovers the signer of the EIP-191 personal message hash locally and
+ * compares it with the expected address.
+ * 
+ * @param address Ethereum address that supposedly signed the message (hex, 0x optional)
  * @param message Original message that was signed
  * @param message_len Length of the message
  * @param signature The signature to verify
  * @param signature_len Length of the signature
- * @return esp_err_t ESP_OK if signature is valid, error code otherwise
+ * @return esp_err_t ESP_OK if signature is valid, ESP_ERR_INVALID_CRC if it was made by
+ *         another key, ESP_ERR_INVALID_ARG / ESP_ERR_INVALID_SIZE for malformed input
  */
 esp_err_t eth_verify_personal_message(
     const char* address,
@@ -0,0 +1,118 @@
+#include "eth_tx.h"
+#include "eth_rlp.h"
+#include "eth_keccak.h"
+#include <stdbool.h>
+#include <string.h>
+#include <esp_log.h>
+
+static const char *TAG = "ETH_TX";
+
+// 追加交易的公共字段: nonce, gasPrice, gas, to, value, data
+static esp_err_t append_tx_fields(eth_rlp_buffer_t* rlp, const eth_legacy_tx_t* tx) {
+    esp_err_t err = eth_rlp_append_uint(rlp, tx->nonce);
+    if (err == ESP_OK) err = eth_rlp_append_uint(rlp, tx->gas_price);
+    if (err == ESP_OK) err = eth_rlp_append_uint(rlp, tx->gas_limit);
+    if (err == ESP_OK) err = eth_rlp_append_bytes(rlp, tx->to, tx->to ? 20 : 0);
+    if (err == ESP_OK) err = eth_rlp_append_uint_bytes(rlp, tx->value, tx->value ? tx->value_len : 0);
+    if (err == ESP_OK) err = eth_rlp_append_bytes(rlp, tx->data, tx->data ? tx->data_len : 0);
+    return err;
+}
+
+// 追加签名字段 (v, r, s) 或EIP-155的 (chainId, 0, 0)
+static esp_err_t append_tail_fields(eth_rlp_buffer_t* rlp, uint64_t v, const uint8_t* r, const uint8_t* s) {
+    esp_err_t err = eth_rlp_append_uint(rlp, v);
+    if (err == ESP_OK) err = eth_rlp_append_uint_bytes(rlp, r, r ? 32 : 0);
+    if (err == ESP_OK) err = eth_rlp_append_uint_bytes(rlp, s, s ? 32 : 0);
+    return err;
+}
+
+// 编码完整交易列表; with_tail为false时不追加末尾三个字段 (EIP-155之前的签名内容)
+static esp_err_t encode_tx(const eth_legacy_tx_t* tx, bool with_tail, uint64_t v,
+                           const uint8_t* r, const uint8_t* s,
+                           uint8_t* out, size_t out_len, size_t* bytes_written) {
+    // 第一遍只计算负载长度
+    eth_rlp_buffer_t rlp;
+    eth_rlp_init(&rlp, NULL, 0);
+    esp_err_t err = append_tx_fields(&rlp, tx);
+    if (err == ESP_OK && with_tail) {
+        err = append_tail_fields(&rlp, v, r, s);
+    }
+    if (err != ESP_OK) {
+        return err;
+    }
+    size_t payload_len = rlp.len;
+
+    // 第二遍写入
+    eth_rlp_init(&rlp, out, out_len);
+    err = eth_rlp_append_list_header(&rlp, payload_len);
+    if (err == ESP_OK) err = append_tx_fields(&rlp, tx);
+    if (err == ESP_OK && with_tail) err = append_tail_fields(&rlp, v, r, s);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    *bytes_written = rlp.len;
+    return ESP_OK;
+}
+
+esp_err_t eth_tx_sign_legacy_with_signer(const eth_legacy_tx_t* tx,
+                                         eth_signer_t* signer,
+                                         uint8_t* raw_tx,
+                                         size_t raw_tx_len,
+                                         size_t* bytes_written) {
+    if (!tx || !signer || !raw_tx || !bytes_written) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *bytes_written = 0;
+
+    // 待签名内容先编码到输出缓冲区 (比签名后的交易短)，计算哈希后再覆盖
+    size_t unsigned_len = 0;
+    bool eip155 = tx->chain_id != 0;
+    esp_err_t err = encode_tx(tx, eip155, tx->chain_id, NULL, NULL, raw_tx, raw_tx_len, &unsigned_len);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to encode transaction for signing: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    uint8_t hash[ETH_KECCAK256_HASH_LEN];
+    eth_keccak256(raw_tx, unsigned_len, hash);
+
+    uint8_t signature[65];
+    err = eth_signer_sign_hash(signer, hash, signature);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to sign transaction hash: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    uint64_t v = eip155 ? tx->chain_id * 2 + 35u + signature[64] : (uint64_t)(27u + signature[64]);
+
+    err = encode_tx(tx, true, v, signature, signature + 32, raw_tx, raw_tx_len, bytes_written);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to encode signed transaction: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    ESP_LOGI(TAG, "Transaction signed locally (%d bytes, v=%llu)", (int)*bytes_written, (unsigned long long)v);
+    return ESP_OK;
+}
+
+esp_err_t eth_tx_sign_legacy(const eth_legacy_tx_t* tx,
+                             const char* private_key_hex,
+                             uint8_t* raw_tx,
+                             size_t raw_tx_len,
+                             size_t* bytes_written) {
+    if (!tx || !private_key_hex || !raw_tx || !bytes_written) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    eth_signer_t signer;
+    esp_err_t err = eth_signer_init(&signer, private_key_hex);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    err = eth_tx_sign_legacy_with_signer(tx, &signer, raw_tx, raw_tx_len, bytes_written);
+    eth_signer_free(&signer);
+    return err;
+}
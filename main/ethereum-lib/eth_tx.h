@@ -0,0 +1,72 @@
+/*
+    本地交易签名
+
+    在设备上完成legacy交易的RLP编码和secp256k1签名，直接得到可用于
+    eth_sendRawTransaction的原始交易字节，不需要节点解锁账户，也省去
+    eth_signTransaction的一次网络往返。
+
+    chain_id不为0时按EIP-155签名:
+        hash = keccak256(rlp([nonce, gasPrice, gas, to, value, data, chainId, 0, 0]))
+        v = recovery_id + chainId * 2 + 35
+    chain_id为0时使用EIP-155之前的格式:
+        hash = keccak256(rlp([nonce, gasPrice, gas, to, value, data]))
+        v = recovery_id + 27
+
+*/
+
+#ifndef ETH_TX_H
+#define ETH_TX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <esp_err.h>
+#include "eth_sign.h"
+
+/**
+ * @brief Legacy交易
+ */
+typedef struct {
+    uint64_t nonce;          // 发送账户的交易序号
+    uint64_t gas_price;      // 燃料价格 (wei)
+    uint64_t gas_limit;      // 燃料限制
+    const uint8_t* to;       // 接收地址 (20字节)，NULL表示创建合约
+    const uint8_t* value;    // 转账金额 (wei，大端序)，NULL表示0
+    size_t value_len;        // 金额字节数
+    const uint8_t* data;     // 调用数据，可为NULL
+    size_t data_len;         // 调用数据长度
+    uint64_t chain_id;       // EIP-155链ID，0表示不使用EIP-155
+} eth_legacy_tx_t;
+
+/**
+ * @brief 对legacy交易进行本地签名，输出RLP编码的原始交易
+ *
+ * @param tx 交易内容
+ * @param private_key_hex 私钥 (十六进制，可带0x前缀)
+ * @param raw_tx 输出的原始交易缓冲区
+ * @param raw_tx_len 缓冲区大小
+ * @param bytes_written 实际写入的字节数
+ * @return esp_err_t ESP_OK成功，缓冲区不足返回ESP_ERR_INVALID_SIZE，其他值失败
+ */
+esp_err_t eth_tx_sign_legacy(const eth_legacy_tx_t* tx,
+                             const char* private_key_hex,
+                             uint8_t* raw_tx,
+                             size_t raw_tx_len,
+                             size_t* bytes_written);
+
+/**
+ * @brief 使用已初始化的签名器对legacy交易签名，避免每笔交易重新解析私钥
+ *
+ * @param tx 交易内容
+ * @param signer 已初始化的签名器
+ * @param raw_tx 输出的原始交易缓冲区
+ * @param raw_tx_len 缓冲区大小
+ * @param bytes_written 实际写入的字节数
+ * @return esp_err_t ESP_OK成功，缓冲区不足返回ESP_ERR_INVALID_SIZE，其他值失败
+ */
+esp_err_t eth_tx_sign_legacy_with_signer(const eth_legacy_tx_t* tx,
+                                         eth_signer_t* signer,
+                                         uint8_t* raw_tx,
+                                         size_t raw_tx_len,
+                                         size_t* bytes_written);
+
+#endif /* ETH_TX_H */
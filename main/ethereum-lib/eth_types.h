@@ -0,0 +1,71 @@
+/*
+    以太坊基础类型
+
+    地址和哈希在库内部以定长字节数组传递，只在JSON-RPC线路上转换为十六进制，
+    避免在各层之间反复做十六进制与二进制的互相转换。
+
+    eth_address_t to;
+    eth_address_from_hex("0x5FbDB2315678afecb367f032d93F642f64180aa3", to);
+
+*/
+
+#ifndef ETH_TYPES_H
+#define ETH_TYPES_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <esp_err.h>
+#include "eth_hex.h"
+
+#define ETH_ADDRESS_LEN      20
+#define ETH_HASH_LEN         32
+#define ETH_ADDRESS_HEX_LEN  ETH_HEX_ENCODED_LEN(ETH_ADDRESS_LEN)  // "0x" + 40 + '\0'
+#define ETH_HASH_HEX_LEN     ETH_HEX_ENCODED_LEN(ETH_HASH_LEN)     // "0x" + 64 + '\0'
+
+typedef uint8_t eth_address_t[ETH_ADDRESS_LEN];
+typedef uint8_t eth_hash_t[ETH_HASH_LEN];
+
+/**
+ * @brief 解析十六进制地址 (可带"0x"前缀，必须正好20字节)
+ *
+ * @return esp_err_t ESP_OK成功，格式或长度错误返回ESP_ERR_INVALID_ARG
+ */
+static inline esp_err_t eth_address_from_hex(const char* hex, eth_address_t out) {
+    size_t written = 0;
+    if (!hex || eth_hex_decode(hex, strlen(hex), out, ETH_ADDRESS_LEN, &written) != ESP_OK ||
+        written != ETH_ADDRESS_LEN) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief 将地址格式化为"0x"开头的小写十六进制
+ */
+static inline void eth_address_to_hex(const eth_address_t address, char out[ETH_ADDRESS_HEX_LEN]) {
+    eth_hex_encode(address, ETH_ADDRESS_LEN, out, ETH_ADDRESS_HEX_LEN, true);
+}
+
+/**
+ * @brief 解析十六进制哈希 (可带"0x"前缀，必须正好32字节)
+ *
+ * @return esp_err_t ESP_OK成功，格式或长度错误返回ESP_ERR_INVALID_ARG
+ */
+static inline esp_err_t eth_hash_from_hex(const char* hex, eth_hash_t out) {
+    size_t written = 0;
+    if (!hex || eth_hex_decode(hex, strlen(hex), out, ETH_HASH_LEN, &written) != ESP_OK ||
+        written != ETH_HASH_LEN) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief 将哈希格式化为"0x"开头的小写十六进制
+ */
+static inline void eth_hash_to_hex(const eth_hash_t hash, char out[ETH_HASH_HEX_LEN]) {
+    eth_hex_encode(hash, ETH_HASH_LEN, out, ETH_HASH_HEX_LEN, true);
+}
+
+#endif /* ETH_TYPES_H */
@@ -0,0 +1,412 @@
+#include "eth_uint256.h"
+#include "eth_hex.h"
+#include <string.h>
+
+static const uint32_t pow10_u32[10] = {
+    1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u, 1000000000u
+};
+
+// 64x64 -> 128位乘法，ESP32没有128位整数类型，按32位拆分计算
+static inline void mul64(uint64_t a, uint64_t b, uint64_t* hi, uint64_t* lo) {
+    uint64_t a0 = (uint32_t)a, a1 = a >> 32;
+    uint64_t b0 = (uint32_t)b, b1 = b >> 32;
+    uint64_t p00 = a0 * b0;
+    uint64_t p01 = a0 * b1;
+    uint64_t p10 = a1 * b0;
+    uint64_t p11 = a1 * b1;
+    uint64_t mid = (p00 >> 32) + (uint32_t)p01 + (uint32_t)p10;
+    *lo = (mid << 32) | (uint32_t)p00;
+    *hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+}
+
+int uint256_cmp(const uint256_t* a, const uint256_t* b) {
+    for (int i = 3; i >= 0; i--) {
+        if (a->limbs[i] != b->limbs[i]) {
+            return a->limbs[i] < b->limbs[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+bool uint256_to_u64(const uint256_t* a, uint64_t* out) {
+    if (a->limbs[1] | a->limbs[2] | a->limbs[3]) {
+        return false;
+    }
+    *out = a->limbs[0];
+    return true;
+}
+
+unsigned uint256_bit_length(const uint256_t* a) {
+    for (int i = 3; i >= 0; i--) {
+        if (a->limbs[i]) {
+            return (unsigned)i * 64 + 64 - (unsigned)__builtin_clzll(a->limbs[i]);
+        }
+    }
+    return 0;
+}
+
+bool uint256_add(const uint256_t* a, const uint256_t* b, uint256_t* r) {
+    uint64_t carry = 0;
+    for (int i = 0; i < 4; i++) {
+        uint64_t s = a->limbs[i] + carry;
+        carry = s < carry;
+        s += b->limbs[i];
+        carry |= s < b->limbs[i];
+        r->limbs[i] = s;
+    }
+    return carry != 0;
+}
+
+bool uint256_sub(const uint256_t* a, const uint256_t* b, uint256_t* r) {
+    uint64_t borrow = 0;
+    for (int i = 0; i < 4; i++) {
+        uint64_t ai = a->limbs[i];
+        uint64_t d = ai - b->limbs[i];
+        uint64_t borrow_out = ai < b->limbs[i];
+        borrow_out |= d < borrow;
+        r->limbs[i] = d - borrow;
+        borrow = borrow_out;
+    }
+    return borrow != 0;
+}
+
+bool uint256_mul(const uint256_t* a, const uint256_t* b, uint256_t* r) {
+    uint64_t prod[8] = { 0 };
+    for (int i = 0; i < 4; i++) {
+        uint64_t carry = 0;
+        for (int j = 0; j < 4; j++) {
+            uint64_t hi, lo;
+            mul64(a->limbs[i], b->limbs[j], &hi, &lo);
+            lo += carry;
+            hi += lo < carry;
+            uint64_t t = prod[i + j] + lo;
+            hi += t < lo;
+            prod[i + j] = t;
+            carry = hi;
+        }
+        prod[i + 4] = carry;
+    }
+    memcpy(r->limbs, prod, sizeof(r->limbs));
+    return (prod[4] | prod[5] | prod[6] | prod[7]) != 0;
+}
+
+bool uint256_mul_u64(const uint256_t* a, uint64_t b, uint256_t* r) {
+    uint64_t carry = 0;
+    for (int i = 0; i < 4; i++) {
+        uint64_t hi, lo;
+        mul64(a->limbs[i], b, &hi, &lo);
+        lo += carry;
+        hi += lo < carry;
+        r->limbs[i] = lo;
+        carry = hi;
+    }
+    return carry != 0;
+}
+
+void uint256_shl(const uint256_t* a, unsigned bits, uint256_t* r) {
+    uint256_t t = UINT256_ZERO;
+    if (bits < 256) {
+        unsigned limb = bits / 64, shift = bits % 64;
+        for (int i = 3; i >= (int)limb; i--) {
+            uint64_t v = a->limbs[i - limb] << shift;
+            if (shift && i - (int)limb - 1 >= 0) {
+                v |= a->limbs[i - limb - 1] >> (64 - shift);
+            }
+            t.limbs[i] = v;
+        }
+    }
+    *r = t;
+}
+
+void uint256_shr(const uint256_t* a, unsigned bits, uint256_t* r) {
+    uint256_t t = UINT256_ZERO;
+    if (bits < 256) {
+        unsigned limb = bits / 64, shift = bits % 64;
+        for (unsigned i = 0; i + limb < 4; i++) {
+            uint64_t v = a->limbs[i + limb] >> shift;
+            if (shift && i + limb + 1 < 4) {
+                v |= a->limbs[i + limb + 1] << (64 - shift);
+            }
+            t.limbs[i] = v;
+        }
+    }
+    *r = t;
+}
+
+esp_err_t uint256_divmod_u32(const uint256_t* a, uint32_t b, uint256_t* q, uint32_t* rem) {
+    if (b == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 按32位为一位做短除法，每步的被除数 (余数 << 32 | 下一位) 不超过64位
+    uint256_t quot;
+    uint64_t r = 0;
+    for (int i = 3; i >= 0; i--) {
+        uint64_t limb = a->limbs[i];
+        uint64_t cur = (r << 32) | (limb >> 32);
+        uint64_t q_hi = cur / b;
+        r = cur % b;
+        cur = (r << 32) | (uint32_t)limb;
+        uint64_t q_lo = cur / b;
+        r = cur % b;
+        quot.limbs[i] = (q_hi << 32) | q_lo;
+    }
+
+    if (q) {
+        *q = quot;
+    }
+    if (rem) {
+        *rem = (uint32_t)r;
+    }
+    return ESP_OK;
+}
+
+esp_err_t uint256_divmod(const uint256_t* a, const uint256_t* b, uint256_t* q, uint256_t* rem) {
+    if (uint256_is_zero(b)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!(b->limbs[0] >> 32) && !(b->limbs[1] | b->limbs[2] | b->limbs[3])) {
+        uint32_t r32 = 0;
+        uint256_divmod_u32(a, (uint32_t)b->limbs[0], q, &r32);
+        if (rem) {
+            uint256_set_u64(rem, r32);
+        }
+        return ESP_OK;
+    }
+
+    uint256_t quot = UINT256_ZERO;
+    uint256_t r = *a;
+    if (uint256_cmp(a, b) >= 0) {
+        // 移位相减，迭代次数为两数位长之差
+        unsigned shift = uint256_bit_length(a) - uint256_bit_length(b);
+        uint256_t d;
+        uint256_shl(b, shift, &d);
+        for (int i = (int)shift; i >= 0; i--) {
+            if (uint256_cmp(&r, &d) >= 0) {
+                uint256_sub(&r, &d, &r);
+                quot.limbs[i / 64] |= 1ULL << (i % 64);
+            }
+            uint256_shr(&d, 1, &d);
+        }
+    }
+
+    if (q) {
+        *q = quot;
+    }
+    if (rem) {
+        *rem = r;
+    }
+    return ESP_OK;
+}
+
+esp_err_t uint256_pow10(unsigned n, uint256_t* r) {
+    if (n > UINT256_MAX_POW10) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint256_set_u64(r, 1);
+    while (n > 0) {
+        unsigned step = n > 9 ? 9 : n;
+        uint256_mul_u64(r, pow10_u32[step], r);
+        n -= step;
+    }
+    return ESP_OK;
+}
+
+esp_err_t uint256_mul_pow10(const uint256_t* a, unsigned n, uint256_t* r) {
+    if (uint256_is_zero(a)) {
+        *r = UINT256_ZERO;
+        return ESP_OK;
+    }
+    if (n > UINT256_MAX_POW10) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    uint256_t p;
+    uint256_pow10(n, &p);
+    return uint256_mul(a, &p, r) ? ESP_ERR_INVALID_SIZE : ESP_OK;
+}
+
+esp_err_t uint256_divmod_pow10(const uint256_t* a, unsigned n, uint256_t* q, uint256_t* rem) {
+    if (n > UINT256_MAX_POW10) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 每次除以不超过10^9，全部走32位短除法；余数按位权累加
+    uint256_t cur = *a;
+    uint256_t r = UINT256_ZERO;
+    uint256_t weight;
+    uint256_set_u64(&weight, 1);
+    while (n > 0) {
+        unsigned step = n > 9 ? 9 : n;
+        uint32_t part = 0;
+        uint256_divmod_u32(&cur, pow10_u32[step], &cur, &part);
+
+        uint256_t t;
+        uint256_mul_u64(&weight, part, &t);
+        uint256_add(&r, &t, &r);
+        uint256_mul_u64(&weight, pow10_u32[step], &weight);
+        n -= step;
+    }
+
+    if (q) {
+        *q = cur;
+    }
+    if (rem) {
+        *rem = r;
+    }
+    return ESP_OK;
+}
+
+esp_err_t uint256_from_be_bytes(const uint8_t* bytes, size_t len, uint256_t* r) {
+    if ((!bytes && len > 0) || !r) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len > UINT256_BYTES) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    *r = UINT256_ZERO;
+    for (size_t i = 0; i < len; i++) {
+        size_t pos = len - 1 - i;  // 从最低字节开始
+        r->limbs[i / 8] |= (uint64_t)bytes[pos] << (8 * (i % 8));
+    }
+    return ESP_OK;
+}
+
+void uint256_to_be_bytes(const uint256_t* a, uint8_t out[UINT256_BYTES]) {
+    for (int i = 0; i < UINT256_BYTES; i++) {
+        out[UINT256_BYTES - 1 - i] = (uint8_t)(a->limbs[i / 8] >> (8 * (i % 8)));
+    }
+}
+
+esp_err_t uint256_from_hex(const char* hex, size_t len, uint256_t* r) {
+    if (!hex || !r) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (len >= 2 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) {
+        hex += 2;
+        len -= 2;
+    }
+    if (len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 前导0不计入长度限制
+    size_t skip = 0;
+    while (skip < len - 1 && hex[skip] == '0') {
+        skip++;
+    }
+    hex += skip;
+    len -= skip;
+    if (len > 64) {
+        for (size_t i = 0; i < len; i++) {
+            if (eth_hex_nibble(hex[i]) < 0) {
+                return ESP_ERR_INVALID_ARG;
+            }
+        }
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    uint256_t v = UINT256_ZERO;
+    for (size_t i = 0; i < len; i++) {
+        int n = eth_hex_nibble(hex[len - 1 - i]);
+        if (n < 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        v.limbs[i / 16] |= (uint64_t)n << (4 * (i % 16));
+    }
+    *r = v;
+    return ESP_OK;
+}
+
+esp_err_t uint256_from_dec(const char* dec, size_t len, uint256_t* r) {
+    if (!dec || !r) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 每9位十进制累加一次: v = v * 10^k + chunk
+    uint256_t v = UINT256_ZERO;
+    bool overflow = false;
+    size_t i = 0;
+    while (i < len) {
+        size_t step = len - i > 9 ? 9 : len - i;
+        uint32_t chunk = 0;
+        for (size_t k = 0; k < step; k++) {
+            char c = dec[i + k];
+            if (c < '0' || c > '9') {
+                return ESP_ERR_INVALID_ARG;
+            }
+            chunk = chunk * 10 + (uint32_t)(c - '0');
+        }
+        uint256_t c256;
+        uint256_set_u64(&c256, chunk);
+        overflow |= uint256_mul_u64(&v, pow10_u32[step], &v);
+        overflow |= uint256_add(&v, &c256, &v);
+        i += step;
+    }
+
+    if (overflow) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    *r = v;
+    return ESP_OK;
+}
+
+esp_err_t uint256_to_hex(const uint256_t* a, char* out, size_t out_len) {
+    if (!a || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    unsigned digits = (uint256_bit_length(a) + 3) / 4;
+    if (digits == 0) {
+        digits = 1;
+    }
+    if (out_len < digits + 3) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    static const char hex_chars[] = "0123456789abcdef";
+    out[0] = '0';
+    out[1] = 'x';
+    for (unsigned i = 0; i < digits; i++) {
+        unsigned nibble = (unsigned)(a->limbs[i / 16] >> (4 * (i % 16))) & 0xF;
+        out[2 + digits - 1 - i] = hex_chars[nibble];
+    }
+    out[2 + digits] = '\0';
+    return ESP_OK;
+}
+
+esp_err_t uint256_to_dec(const uint256_t* a, char* out, size_t out_len) {
+    if (!a || !out || out_len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 每次除以10^9取出9位，低位在前写入临时缓冲区
+    char digits[UINT256_DEC_BUF_LEN];
+    size_t n = 0;
+    uint256_t cur = *a;
+    do {
+        uint32_t part = 0;
+        uint256_divmod_u32(&cur, pow10_u32[9], &cur, &part);
+        bool last = uint256_is_zero(&cur);
+        for (int k = 0; k < 9 && (!last || part > 0 || k == 0); k++) {
+            digits[n++] = (char)('0' + part % 10);
+            part /= 10;
+        }
+    } while (!uint256_is_zero(&cur));
+
+    if (out_len < n + 1) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    for (size_t i = 0; i < n; i++) {
+        out[i] = digits[n - 1 - i];
+    }
+    out[n] = '\0';
+    return ESP_OK;
+}
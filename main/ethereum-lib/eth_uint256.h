@@ -0,0 +1,206 @@
+/*
+    256位无符号整数
+
+    以太坊的金额、gas费用和ABI整数都是uint256，原先通过十进制字符串运算
+    和double近似处理。这里用4个64位limb (小端序，limbs[0]为最低位) 做定长
+    运算，结果精确，耗时与数值大小无关。
+
+    uint256_t wei, ether, rem;
+    uint256_from_hex("0x21e19e0c9bab2400000", 21, &wei);
+    uint256_divmod_pow10(&wei, 18, &ether, &rem);   // ether = 10000, rem = 0
+
+    加减乘在溢出时返回true，结果按2^256取模。
+
+*/
+
+#ifndef ETH_UINT256_H
+#define ETH_UINT256_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <esp_err.h>
+
+#define UINT256_BYTES        32
+#define UINT256_MAX_POW10    77   // 10^77 < 2^256 < 10^78
+#define UINT256_HEX_BUF_LEN  67   // "0x" + 64位十六进制 + '\0'
+#define UINT256_DEC_BUF_LEN  79   // 78位十进制 + '\0'
+
+#define ETH_ETHER_DECIMALS   18   // 1 ETH = 10^18 wei
+#define ETH_GWEI_DECIMALS    9    // 1 Gwei = 10^9 wei
+
+/**
+ * @brief 256位无符号整数
+ */
+typedef struct {
+    uint64_t limbs[4];  // 小端序，limbs[0]为最低64位
+} uint256_t;
+
+#define UINT256_ZERO ((uint256_t){ { 0, 0, 0, 0 } })
+
+/**
+ * @brief 设置为64位整数值
+ */
+static inline void uint256_set_u64(uint256_t* r, uint64_t v) {
+    r->limbs[0] = v;
+    r->limbs[1] = 0;
+    r->limbs[2] = 0;
+    r->limbs[3] = 0;
+}
+
+/**
+ * @brief 是否为0
+ */
+static inline bool uint256_is_zero(const uint256_t* a) {
+    return (a->limbs[0] | a->limbs[1] | a->limbs[2] | a->limbs[3]) == 0;
+}
+
+/**
+ * @brief 比较两个数
+ *
+ * @return int a < b返回-1，相等返回0，a > b返回1
+ */
+int uint256_cmp(const uint256_t* a, const uint256_t* b);
+
+/**
+ * @brief 转换为64位整数
+ *
+ * @return bool 数值超过64位时返回false (out不变)
+ */
+bool uint256_to_u64(const uint256_t* a, uint64_t* out);
+
+/**
+ * @brief 有效位数 (0表示数值为0)
+ */
+unsigned uint256_bit_length(const uint256_t* a);
+
+/**
+ * @brief r = a + b
+ *
+ * @return bool 溢出返回true
+ */
+bool uint256_add(const uint256_t* a, const uint256_t* b, uint256_t* r);
+
+/**
+ * @brief r = a - b
+ *
+ * @return bool a < b (借位) 返回true
+ */
+bool uint256_sub(const uint256_t* a, const uint256_t* b, uint256_t* r);
+
+/**
+ * @brief r = a * b (保留低256位)
+ *
+ * @return bool 乘积超过256位返回true
+ */
+bool uint256_mul(const uint256_t* a, const uint256_t* b, uint256_t* r);
+
+/**
+ * @brief r = a * b，b为64位整数
+ *
+ * @return bool 乘积超过256位返回true
+ */
+bool uint256_mul_u64(const uint256_t* a, uint64_t b, uint256_t* r);
+
+/**
+ * @brief q = a / b, rem = a % b
+ *
+ * @param q 商，可为NULL
+ * @param rem 余数，可为NULL
+ * @return esp_err_t ESP_OK成功，除数为0返回ESP_ERR_INVALID_ARG
+ */
+esp_err_t uint256_divmod(const uint256_t* a, const uint256_t* b, uint256_t* q, uint256_t* rem);
+
+/**
+ * @brief 除以32位整数 (格式化十进制时使用的快速路径)
+ *
+ * @param q 商，可为NULL
+ * @param rem 余数，可为NULL
+ * @return esp_err_t ESP_OK成功，除数为0返回ESP_ERR_INVALID_ARG
+ */
+esp_err_t uint256_divmod_u32(const uint256_t* a, uint32_t b, uint256_t* q, uint32_t* rem);
+
+/**
+ * @brief 左移 (r可以与a相同)
+ */
+void uint256_shl(const uint256_t* a, unsigned bits, uint256_t* r);
+
+/**
+ * @brief 右移 (r可以与a相同)
+ */
+void uint256_shr(const uint256_t* a, unsigned bits, uint256_t* r);
+
+/**
+ * @brief r = 10^n
+ *
+ * @return esp_err_t ESP_OK成功，n超过UINT256_MAX_POW10返回ESP_ERR_INVALID_ARG
+ */
+esp_err_t uint256_pow10(unsigned n, uint256_t* r);
+
+/**
+ * @brief r = a * 10^n (如ETH转换为wei时n = 18)
+ *
+ * @return esp_err_t ESP_OK成功，溢出返回ESP_ERR_INVALID_SIZE
+ */
+esp_err_t uint256_mul_pow10(const uint256_t* a, unsigned n, uint256_t* r);
+
+/**
+ * @brief q = a / 10^n, rem = a % 10^n (如wei转换为ETH时n = 18)
+ *
+ * @param q 整数部分，可为NULL
+ * @param rem 小数部分，可为NULL
+ * @return esp_err_t ESP_OK成功，n超过UINT256_MAX_POW10返回ESP_ERR_INVALID_ARG
+ */
+esp_err_t uint256_divmod_pow10(const uint256_t* a, unsigned n, uint256_t* q, uint256_t* rem);
+
+/**
+ * @brief 从大端序字节读取 (如ABI编码中的32字节整数)
+ *
+ * @param bytes 大端序字节
+ * @param len 字节数，不超过32
+ * @return esp_err_t ESP_OK成功，超过32字节返回ESP_ERR_INVALID_SIZE
+ */
+esp_err_t uint256_from_be_bytes(const uint8_t* bytes, size_t len, uint256_t* r);
+
+/**
+ * @brief 写出32字节大端序 (可直接用于ABI_UINT(256, bytes))
+ */
+void uint256_to_be_bytes(const uint256_t* a, uint8_t out[UINT256_BYTES]);
+
+/**
+ * @brief 解析十六进制字符串，可带"0x"前缀
+ *
+ * @param hex 十六进制字符串 (不要求以'\0'结尾)
+ * @param len 字符串长度
+ * @return esp_err_t ESP_OK成功，没有数字或含非法字符返回ESP_ERR_INVALID_ARG，
+ *         超过256位返回ESP_ERR_INVALID_SIZE
+ */
+esp_err_t uint256_from_hex(const char* hex, size_t len, uint256_t* r);
+
+/**
+ * @brief 解析十进制字符串
+ *
+ * @param dec 十进制字符串 (不要求以'\0'结尾)
+ * @param len 字符串长度
+ * @return esp_err_t ESP_OK成功，没有数字或含非法字符返回ESP_ERR_INVALID_ARG，
+ *         超过256位返回ESP_ERR_INVALID_SIZE
+ */
+esp_err_t uint256_from_dec(const char* dec, size_t len, uint256_t* r);
+
+/**
+ * @brief 格式化为JSON-RPC数量格式的十六进制 ("0x0", "0x1a"，无前导0)
+ *
+ * @param out 输出缓冲区，UINT256_HEX_BUF_LEN字节足够
+ * @return esp_err_t ESP_OK成功，缓冲区不足返回ESP_ERR_INVALID_SIZE
+ */
+esp_err_t uint256_to_hex(const uint256_t* a, char* out, size_t out_len);
+
+/**
+ * @brief 格式化为十进制
+ *
+ * @param out 输出缓冲区，UINT256_DEC_BUF_LEN字节足够
+ * @return esp_err_t ESP_OK成功，缓冲区不足返回ESP_ERR_INVALID_SIZE
+ */
+esp_err_t uint256_to_dec(const uint256_t* a, char* out, size_t out_len);
+
+#endif /* ETH_UINT256_H */
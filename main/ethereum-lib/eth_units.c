@@ -0,0 +1,131 @@
+#include "eth_units.h"
+#include <string.h>
+
+static const uint32_t pow10_u32[10] = {
+    1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u, 1000000000u
+};
+
+// v = v * 10^chunk_len + chunk
+static bool append_chunk(uint256_t* v, uint32_t chunk, unsigned chunk_len) {
+    uint256_t c;
+    uint256_set_u64(&c, chunk);
+    bool overflow = uint256_mul_u64(v, pow10_u32[chunk_len], v);
+    overflow |= uint256_add(v, &c, v);
+    return overflow;
+}
+
+esp_err_t eth_units_parse(const char* str, size_t len, uint8_t decimals, uint256_t* out) {
+    if (!str || !out || decimals > UINT256_MAX_POW10) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 整数位和小数位作为一个数字序列累加，每9位做一次256位乘加
+    uint256_t v = UINT256_ZERO;
+    bool overflow = false;
+    bool seen_point = false;
+    size_t digits = 0;
+    unsigned frac = 0;
+    uint32_t chunk = 0;
+    unsigned chunk_len = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        char c = str[i];
+        if (c == '.') {
+            if (seen_point) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            seen_point = true;
+            continue;
+        }
+        if (c < '0' || c > '9') {
+            return ESP_ERR_INVALID_ARG;
+        }
+        digits++;
+
+        if (seen_point) {
+            if (frac == decimals) {
+                // 超出精度的部分只允许是0
+                if (c != '0') {
+                    return ESP_ERR_INVALID_ARG;
+                }
+                continue;
+            }
+            frac++;
+        }
+
+        chunk = chunk * 10 + (uint32_t)(c - '0');
+        if (++chunk_len == 9) {
+            overflow |= append_chunk(&v, chunk, chunk_len);
+            chunk = 0;
+            chunk_len = 0;
+        }
+    }
+
+    if (digits == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (chunk_len > 0) {
+        overflow |= append_chunk(&v, chunk, chunk_len);
+    }
+    if (overflow || uint256_mul_pow10(&v, decimals - frac, &v) != ESP_OK) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    *out = v;
+    return ESP_OK;
+}
+
+esp_err_t eth_units_format(const uint256_t* value, uint8_t decimals, uint8_t frac_digits,
+                           char* out, size_t out_len) {
+    if (!value || !out || out_len == 0 || decimals > UINT256_MAX_POW10) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 先整体转换为十进制，再在 decimals 位处插入小数点，不做额外的除法
+    char digits[UINT256_DEC_BUF_LEN];
+    uint256_to_dec(value, digits, sizeof(digits));
+    size_t n = strlen(digits);
+    size_t int_len = n > decimals ? n - decimals : 0;
+    size_t lead_zeros = decimals - (n - int_len);  // 小数部分中数字之前的0
+    const char* frac_src = digits + int_len;
+
+    size_t frac_len;
+    size_t pad = 0;
+    if (frac_digits == ETH_UNITS_FULL_PRECISION) {
+        frac_len = decimals;
+        while (frac_len > lead_zeros && frac_src[frac_len - lead_zeros - 1] == '0') {
+            frac_len--;
+        }
+        if (frac_len == lead_zeros) {
+            frac_len = 0;  // 小数部分全为0
+        }
+    } else if (frac_digits > decimals) {
+        frac_len = decimals;
+        pad = frac_digits - decimals;
+    } else {
+        frac_len = frac_digits;
+    }
+
+    size_t total = (int_len ? int_len : 1) + (frac_len + pad ? 1 + frac_len + pad : 0);
+    if (out_len < total + 1) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    char* p = out;
+    if (int_len) {
+        memcpy(p, digits, int_len);
+        p += int_len;
+    } else {
+        *p++ = '0';
+    }
+    if (frac_len + pad) {
+        *p++ = '.';
+        for (size_t k = 0; k < frac_len; k++) {
+            *p++ = k < lead_zeros ? '0' : frac_src[k - lead_zeros];
+        }
+        memset(p, '0', pad);
+        p += pad;
+    }
+    *p = '\0';
+    return ESP_OK;
+}
@@ -0,0 +1,57 @@
+/*
+    代币单位换算
+
+    在uint256基础单位 (wei、USDC的最小单位等) 与十进制定点文本之间转换，
+    小数位数由 decimals 指定 (ETH为18，USDC为6)，全程整数运算，没有浮点误差。
+
+    uint256_t wei;
+    eth_units_parse("1.25", 4, ETH_ETHER_DECIMALS, &wei);     // 1250000000000000000
+    eth_units_format(&wei, ETH_ETHER_DECIMALS, ETH_UNITS_FULL_PRECISION, buf, sizeof(buf));  // "1.25"
+    eth_units_format(&wei, ETH_ETHER_DECIMALS, 4, buf, sizeof(buf));                         // "1.2500"
+
+*/
+
+#ifndef ETH_UNITS_H
+#define ETH_UNITS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <esp_err.h>
+#include "eth_uint256.h"
+
+// 输出全部有效小数位，去掉末尾的0 (没有小数部分时只输出整数)
+#define ETH_UNITS_FULL_PRECISION 0xFF
+
+// 格式化缓冲区大小上限 (frac_digits不超过UINT256_MAX_POW10时): 78位数字 + 小数点 + 补足的0 + '\0'
+#define ETH_UNITS_BUF_LEN (UINT256_DEC_BUF_LEN + UINT256_MAX_POW10 + 2)
+
+/**
+ * @brief 将十进制定点文本解析为基础单位
+ *
+ * 接受 "1"、"1.25"、"0.000001"、".5" 这样的格式，不接受符号和指数。
+ * 小数位超过decimals时，多出的部分必须全为0，否则返回错误而不是截断。
+ *
+ * @param str 十进制文本 (不要求以'\0'结尾)
+ * @param len 文本长度
+ * @param decimals 小数位数 (不超过UINT256_MAX_POW10)
+ * @param out 输出的基础单位数量
+ * @return esp_err_t ESP_OK成功，格式错误或精度超出decimals返回ESP_ERR_INVALID_ARG，
+ *         超过256位返回ESP_ERR_INVALID_SIZE
+ */
+esp_err_t eth_units_parse(const char* str, size_t len, uint8_t decimals, uint256_t* out);
+
+/**
+ * @brief 将基础单位格式化为十进制定点文本
+ *
+ * @param value 基础单位数量
+ * @param decimals 小数位数 (不超过UINT256_MAX_POW10)
+ * @param frac_digits 输出的小数位数，多余部分截断、不足补0；
+ *                    ETH_UNITS_FULL_PRECISION表示输出全部有效小数位
+ * @param out 输出缓冲区，frac_digits不超过UINT256_MAX_POW10时ETH_UNITS_BUF_LEN字节足够
+ * @param out_len 缓冲区大小
+ * @return esp_err_t ESP_OK成功，缓冲区不足返回ESP_ERR_INVALID_SIZE
+ */
+esp_err_t eth_units_format(const uint256_t* value, uint8_t decimals, uint8_t frac_digits,
+                           char* out, size_t out_len);
+
+#endif /* ETH_UNITS_H */
@@ -1,49 +1,146 @@
 #include "web3.h"
 #include <string.h>
 #include <esp_log.h>
-#include <cJSON.h>
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "eth_json.h"
+#include "web3_transport.h"
 #include <stdlib.h>
 
 static const char *TAG = "WEB3";
 
-// 全局响应缓冲区用于事件处理器中存储数据
-typedef struct {
-    char *buffer;
-    size_t buffer_size;
-    size_t data_length;
-} http_response_buffer_t;
-
-// HTTP事件处理函数
-esp_err_t http_event_handler(esp_http_client_event_t *evt)
-{
-    http_response_buffer_t *buffer = (http_response_buffer_t *)evt->user_data;
-    
-    switch(evt->event_id) {
-        case HTTP_EVENT_ON_DATA:
-            // 如果接收到的数据可以放入缓冲区
-            if (buffer->data_length + evt->data_len < buffer->buffer_size) {
-                // 将数据复制到用户提供的缓冲区
-                memcpy(buffer->buffer + buffer->data_length, evt->data, evt->data_len);
-                buffer->data_length += evt->data_len;
-                buffer->buffer[buffer->data_length] = 0; // 确保结尾有null字符
-                ESP_LOGI(TAG, "Received %d bytes, total: %d", evt->data_len, buffer->data_length);
-            } else {
-                ESP_LOGE(TAG, "Response too large for buffer! buffer_size=%zu, data_len=%zu", 
-                         buffer->buffer_size, buffer->data_length + evt->data_len);
+void web3_sink_init_fixed(web3_response_sink_t* sink, char* buffer, size_t buffer_len) {
+    memset(sink, 0, sizeof(*sink));
+    sink->type = WEB3_SINK_FIXED;
+    sink->buffer = buffer;
+    sink->capacity = buffer_len;
+}
+
+void web3_sink_init_growable(web3_response_sink_t* sink, size_t max_size) {
+    memset(sink, 0, sizeof(*sink));
+    sink->type = WEB3_SINK_GROWABLE;
+    sink->max_size = max_size ? max_size : WEB3_RESPONSE_MAX_SIZE;
+    sink->caps = WEB3_SINK_DEFAULT_CAPS;
+}
+
+void web3_sink_init_stream(web3_response_sink_t* sink, web3_sink_write_fn write, void* user_ctx) {
+    memset(sink, 0, sizeof(*sink));
+    sink->type = WEB3_SINK_STREAM;
+    sink->write = write;
+    sink->user_ctx = user_ctx;
+}
+
+void web3_sink_reset(web3_response_sink_t* sink) {
+    sink->length = 0;
+    sink->err = ESP_OK;
+    if (sink->buffer && sink->capacity > 0 && sink->type != WEB3_SINK_STREAM) {
+        sink->buffer[0] = '\0';
+    }
+}
+
+void web3_sink_free(web3_response_sink_t* sink) {
+    if (sink->type == WEB3_SINK_GROWABLE && sink->buffer) {
+        heap_caps_free(sink->buffer);
+    }
+    if (sink->type == WEB3_SINK_GROWABLE) {
+        sink->buffer = NULL;
+        sink->capacity = 0;
+    }
+    sink->length = 0;
+}
+
+// 确保可增长缓冲区能再容纳additional字节 (外加结尾'\0')
+esp_err_t web3_sink_reserve(web3_response_sink_t* sink, size_t additional, bool exact) {
+    size_t needed = sink->length + additional + 1;
+    if (needed <= sink->capacity) {
+        return ESP_OK;
+    }
+    if (needed > sink->max_size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    
+    // 已知总长度 (Content-Length) 时一次分配到位，否则按倍数增长
+    size_t new_capacity = needed;
+    if (!exact) {
+        new_capacity = sink->capacity ? sink->capacity * 2 : 512;
+        if (new_capacity < needed) {
+            new_capacity = needed;
+        }
+        if (new_capacity > sink->max_size) {
+            new_capacity = sink->max_size;
+        }
+    }
+    
+    // 优先放在PSRAM，没有PSRAM或PSRAM不足时退回内部RAM
+    char *buffer = heap_caps_realloc(sink->buffer, new_capacity, sink->caps);
+    if (!buffer && sink->caps != MALLOC_CAP_DEFAULT) {
+        buffer = heap_caps_realloc(sink->buffer, new_capacity, MALLOC_CAP_DEFAULT);
+    }
+    if (!buffer) {
+        return ESP_ERR_NO_MEM;
+    }
+    
+    sink->buffer = buffer;
+    sink->capacity = new_capacity;
+    return ESP_OK;
+}
+
+esp_err_t web3_sink_write(web3_response_sink_t* sink, const char* data, size_t len) {
+    // 出错后丢弃剩余数据，错误在请求结束时返回给调用者
+    if (sink->err != ESP_OK) {
+        return sink->err;
+    }
+    
+    esp_err_t err = ESP_OK;
+    switch (sink->type) {
+        case WEB3_SINK_FIXED:
+            if (sink->length + len >= sink->capacity) {
+                err = ESP_ERR_INVALID_SIZE;
+            }
+            break;
+        case WEB3_SINK_GROWABLE:
+            err = web3_sink_reserve(sink, len, false);
+            break;
+        case WEB3_SINK_STREAM:
+            err = sink->write ? sink->write(sink->user_ctx, data, len) : ESP_ERR_INVALID_STATE;
+            if (err == ESP_OK) {
+                sink->length += len;
             }
-            return ESP_OK;
-            
-        case HTTP_EVENT_ON_FINISH:
-            ESP_LOGI(TAG, "HTTP request completed");
-            return ESP_OK;
-            
-        case HTTP_EVENT_ERROR:
-            ESP_LOGE(TAG, "HTTP error");
-            return ESP_FAIL;
-            
-        default:
-            return ESP_OK;
+            break;
+    }
+    
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Response sink rejected %d bytes after %d: %s",
+                 (int)len, (int)sink->length, esp_err_to_name(err));
+        sink->err = err;
+        return err;
+    }
+    
+    if (sink->type != WEB3_SINK_STREAM) {
+        memcpy(sink->buffer + sink->length, data, len);
+        sink->length += len;
+        sink->buffer[sink->length] = '\0';
     }
+    return ESP_OK;
+}
+
+esp_err_t web3_init_with_transport(web3_context_t* context, const char* url, web3_transport_t* transport) {
+    if (!context || !transport) {
+        if (transport) {
+            transport->ops->destroy(transport);
+        }
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    context->url = strdup(url ? url : "");
+    if (!context->url) {
+        transport->ops->destroy(transport);
+        return ESP_ERR_NO_MEM;
+    }
+    context->transport = transport;
+    ESP_LOGI(TAG, "Web3 initialized successfully (%s)", transport->ops->name);
+    return ESP_OK;
 }
 
 esp_err_t web3_init(web3_context_t* context, const char* url) {
@@ -52,39 +149,223 @@ esp_err_t web3_init(web3_context_t* context, const char* url) {
     }
     
     ESP_LOGI(TAG, "Initializing web3 with URL: %s", url);
+    context->url = NULL;
+    context->transport = NULL;
     
-    context->url = strdup(url);
-    if (!context->url) {
-        return ESP_ERR_NO_MEM;
+    // WebSocket连接建立后常驻，请求和订阅通知复用同一连接
+    web3_transport_t* transport = NULL;
+    esp_err_t err;
+    if (web3_ws_is_url(url)) {
+        err = web3_transport_ws_create(url, &transport);
+    } else {
+#if CONFIG_IDF_TARGET_LINUX
+        // Linux目标没有esp_http_client，使用原始socket后端
+        err = web3_transport_socket_create(url, &transport);
+#else
+        err = web3_transport_http_create(url, &transport);
+#endif
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create transport for %s: %s", url, esp_err_to_name(err));
+        return err;
+    }
+    return web3_init_with_transport(context, url, transport);
+}
+
+// JSON-RPC请求id，单次请求与批量请求共用，多个任务并发请求时由自旋锁保护
+static uint32_t s_request_id = 1;
+static portMUX_TYPE s_request_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// 请求体写入统计
+static web3_request_stats_t s_request_stats;
+
+// 请求信封: params原样拼接，不再解析和重新序列化
+#define WEB3_REQUEST_FORMAT "{\"jsonrpc\":\"2.0\",\"method\":\"%s\",\"params\":%s,\"id\":%lu}"
+// 信封的固定部分加上id的最大位数
+#define WEB3_REQUEST_OVERHEAD (sizeof(WEB3_REQUEST_FORMAT) + 10)
+
+// 预留count个连续的请求id，返回第一个
+static uint32_t web3_reserve_request_ids(size_t count) {
+    taskENTER_CRITICAL(&s_request_lock);
+    uint32_t first_id = s_request_id;
+    s_request_id += (uint32_t)count;
+    taskEXIT_CRITICAL(&s_request_lock);
+    return first_id;
+}
+
+void web3_record_connection(bool opened, bool idle_reconnect, bool replayed) {
+    taskENTER_CRITICAL(&s_request_lock);
+    if (opened) {
+        s_request_stats.connections_opened++;
+    } else {
+        s_request_stats.connections_reused++;
+    }
+    if (idle_reconnect) {
+        s_request_stats.idle_reconnects++;
+    }
+    if (replayed) {
+        s_request_stats.stale_replays++;
+    }
+    taskEXIT_CRITICAL(&s_request_lock);
+}
+
+static void web3_record_request(size_t bytes, bool allocated) {
+    taskENTER_CRITICAL(&s_request_lock);
+    s_request_stats.requests++;
+    s_request_stats.bytes_written += bytes;
+    if (allocated) {
+        s_request_stats.heap_allocations++;
+    }
+    taskEXIT_CRITICAL(&s_request_lock);
+}
+
+// 检查params是否恰好是一个合法的JSON数组 (之后没有多余内容)，不合法时与以前一样退回空数组
+static const char* web3_checked_params(const char* params) {
+    if (!params) {
+        return "[]";
     }
     
-    // 判断是否为HTTPS连接
-    bool is_https = (strncmp(url, "https://", 8) == 0);
-    
-    context->config = (esp_http_client_config_t) {
-        .url = context->url,
-        .method = HTTP_METHOD_POST,
-        .timeout_ms = 10000,
-        // 对于HTTPS连接，跳过证书验证
-        .skip_cert_common_name_check = is_https,
-        .crt_bundle_attach = NULL, // 不使用证书捆绑
-        .cert_pem = NULL,
-        .client_cert_pem = NULL,
-        .client_key_pem = NULL,
-        // 添加事件处理器
-        .event_handler = http_event_handler,
-    };
-    
-    context->client = esp_http_client_init(&context->config);
-    if (!context->client) {
-        ESP_LOGE(TAG, "Failed to initialize HTTP client");
-        free(context->url);
-        return ESP_FAIL;
+    size_t len = strlen(params);
+    eth_json_token_t root;
+    if (eth_json_validate(params, len) != ESP_OK ||
+        eth_json_parse(params, len, &root) != ESP_OK || root.type != ETH_JSON_ARRAY) {
+        ESP_LOGW(TAG, "Failed to parse params: %s, using empty array", params);
+        return "[]";
+    }
+    return params;
+}
+
+// 请求对象的最大长度 (不含结尾'\0')
+static size_t web3_request_size(const char* method, const char* params) {
+    return WEB3_REQUEST_OVERHEAD + strlen(method) + strlen(params);
+}
+
+// 将请求对象写入buf，返回写入的字节数
+static size_t web3_write_request(char* buf, size_t buf_len, const char* method, const char* params, uint32_t id) {
+    int written = snprintf(buf, buf_len, WEB3_REQUEST_FORMAT, method, params, (unsigned long)id);
+    return written > 0 ? (size_t)written : 0;
+}
+
+/*
+    web3_render_request生成的请求体以定宽的id结尾 ("id":12        })，
+    数字左对齐、空格补齐 (JSON允许数字后的空白)。web3_send_body_sink每次发送前
+    在原位写入新的id，重复发送的请求体也不会与之前超时请求迟到的响应同id。
+*/
+#define WEB3_REQUEST_ID_WIDTH 10
+#define WEB3_RENDERED_FORMAT "{\"jsonrpc\":\"2.0\",\"method\":\"%s\",\"params\":%s,\"id\":%-10lu}"
+
+static void web3_stamp_request_id(char* body, size_t body_len) {
+    static const char key[] = "\"id\":";
+    if (body_len < sizeof(key) + WEB3_REQUEST_ID_WIDTH || body[body_len - 1] != '}') {
+        return;
+    }
+    char* slot = body + body_len - 1 - WEB3_REQUEST_ID_WIDTH;
+    if (memcmp(slot - (sizeof(key) - 1), key, sizeof(key) - 1) != 0) {
+        return;
+    }
+    char id[WEB3_REQUEST_ID_WIDTH + 1];
+    snprintf(id, sizeof(id), "%-*lu", WEB3_REQUEST_ID_WIDTH, (unsigned long)web3_reserve_request_ids(1));
+    memcpy(slot, id, WEB3_REQUEST_ID_WIDTH);
+}
+
+esp_err_t web3_get_request_stats(web3_request_stats_t* stats) {
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    taskENTER_CRITICAL(&s_request_lock);
+    *stats = s_request_stats;
+    taskEXIT_CRITICAL(&s_request_lock);
+    return ESP_OK;
+}
+
+esp_err_t web3_keep_alive(web3_context_t* context) {
+    if (!context || !context->transport) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!context->transport->ops->idle_ms) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    int64_t idle_ms = context->transport->ops->idle_ms(context->transport);
+    if (idle_ms >= 0 && idle_ms < WEB3_HTTP_KEEPALIVE_MS) {
+        return ESP_OK;
+    }
+
+    // 连接快到空闲超时 (或已关闭) 时发送最便宜的请求，过期的连接由后端在发送前重连
+    char result[96];
+    esp_err_t err = web3_send_request(context, "eth_chainId", "[]", result, sizeof(result));
+    if (err == ESP_OK) {
+        taskENTER_CRITICAL(&s_request_lock);
+        s_request_stats.keep_alives++;
+        taskEXIT_CRITICAL(&s_request_lock);
+    }
+    return err;
+}
+
+// 连接失效时可以安全重发的只读方法 (eth_getFilterChanges会推进过滤器游标，不在其列)
+static const char* const WEB3_IDEMPOTENT_METHODS[] = {
+    "eth_call", "eth_blockNumber", "eth_chainId", "eth_gasPrice", "eth_estimateGas",
+    "eth_getBalance", "eth_getCode", "eth_getStorageAt", "eth_getTransactionCount",
+    "eth_getTransactionReceipt", "eth_getTransactionByHash", "eth_getBlockByNumber",
+    "eth_getBlockByHash", "eth_getLogs", "eth_syncing", "eth_protocolVersion",
+    "eth_feeHistory", "eth_maxPriorityFeePerGas",
+    "net_version", "net_listening", "net_peerCount", "web3_clientVersion", "web3_sha3",
+};
+
+static bool web3_method_is_idempotent(const char* method, size_t len) {
+    for (size_t i = 0; i < sizeof(WEB3_IDEMPOTENT_METHODS) / sizeof(WEB3_IDEMPOTENT_METHODS[0]); i++) {
+        if (strlen(WEB3_IDEMPOTENT_METHODS[i]) == len && memcmp(WEB3_IDEMPOTENT_METHODS[i], method, len) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 请求体 (单个请求或批量数组) 中的每个方法都是只读方法时才可以重发，只在失败路径上扫描
+bool web3_body_is_idempotent(const char* body, size_t body_len) {
+    static const char key[] = "\"method\":\"";
+    const char* end = body + body_len;
+    const char* p = body;
+    bool found = false;
+    while ((p = memmem(p, end - p, key, sizeof(key) - 1)) != NULL) {
+        p += sizeof(key) - 1;
+        const char* quote = memchr(p, '"', end - p);
+        if (!quote || !web3_method_is_idempotent(p, quote - p)) {
+            return false;
+        }
+        found = true;
+        p = quote;
+    }
+    return found;
+}
+
+// 经由传输后端发送请求体，检查响应是否完整
+static esp_err_t web3_perform_post(web3_context_t* context, const char* post_data, size_t post_len,
+                                   web3_response_sink_t* sink) {
+    if (!context->transport) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    esp_err_t err = context->transport->ops->perform(context->transport, post_data, post_len, sink);
+    if (err != ESP_OK) {
+        return err;
     }
     
-    esp_http_client_set_header(context->client, "Content-Type", "application/json");
-    ESP_LOGI(TAG, "Web3 initialized successfully");
+    // 响应超出缓冲区或流式回调出错时不再返回被截断的数据
+    if (sink->err != ESP_OK) {
+        ESP_LOGE(TAG, "响应未能完整接收 (%d 字节): %s", (int)sink->length, esp_err_to_name(sink->err));
+        return sink->err;
+    }
     
+    if (sink->length == 0) {
+        ESP_LOGE(TAG, "没有接收到响应数据");
+        return ESP_FAIL;
+    }
+    
+    if (sink->type != WEB3_SINK_STREAM) {
+        ESP_LOGI(TAG, "响应: %s", sink->buffer);
+    }
     return ESP_OK;
 }
 
@@ -102,91 +383,197 @@ esp_err_t web3_send_request(web3_context_t* context, const char* method,
     // 清空结果缓冲区
     memset(result, 0, result_len);
     
-    // 创建响应缓冲区结构体
-    http_response_buffer_t response_buffer = {
-        .buffer = result,
-        .buffer_size = result_len,
-        .data_length = 0
-    };
+    web3_response_sink_t sink;
+    web3_sink_init_fixed(&sink, result, result_len);
+    return web3_send_request_sink(context, method, params, &sink);
+}
+
+esp_err_t web3_send_request_sink(web3_context_t* context, const char* method,
+                                 const char* params, web3_response_sink_t* sink) {
+    if (!context || !method || !sink) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    web3_sink_reset(sink);
+    params = web3_checked_params(params);
     
-    // 设置事件处理器的用户数据为响应缓冲区
-    esp_http_client_set_user_data(context->client, &response_buffer);
+    // 常见的小请求直接写在栈上，只有大负载 (如原始交易) 才按实际大小分配一次
+    char stack_buffer[WEB3_REQUEST_STACK_BUFFER];
+    char *post_data = stack_buffer;
+    size_t post_len = web3_request_size(method, params) + 1;
+    bool allocated = post_len > sizeof(stack_buffer);
+    if (allocated) {
+        post_data = malloc(post_len);
+        if (!post_data) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
     
-    static int request_id = 1;
-    cJSON *root = cJSON_CreateObject();
-    if (!root) {
+    size_t written = web3_write_request(post_data, post_len, method, params, web3_reserve_request_ids(1));
+    web3_record_request(written, allocated);
+    
+    esp_err_t err = web3_perform_post(context, post_data, written, sink);
+    if (allocated) {
+        free(post_data);
+    }
+    return err;
+}
+
+esp_err_t web3_render_request(const char* method, const char* params, char** body, size_t* body_len) {
+    if (!method || !body || !body_len) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    params = web3_checked_params(params);
+    size_t len = web3_request_size(method, params) + 1;
+    char* buf = malloc(len);
+    if (!buf) {
         return ESP_ERR_NO_MEM;
     }
     
-    cJSON_AddStringToObject(root, "jsonrpc", "2.0");
-    cJSON_AddStringToObject(root, "method", method);
+    int written = snprintf(buf, len, WEB3_RENDERED_FORMAT, method, params,
+                           (unsigned long)web3_reserve_request_ids(1));
+    *body_len = written > 0 ? (size_t)written : 0;
+    *body = buf;
+    return ESP_OK;
+}
+
+esp_err_t web3_send_body_sink(web3_context_t* context, char* body, size_t body_len,
+                              web3_response_sink_t* sink) {
+    if (!context || !body || body_len == 0 || !sink) {
+        return ESP_ERR_INVALID_ARG;
+    }
     
-    if (params) {
-        cJSON *params_json = cJSON_Parse(params);
-        if (params_json) {
-            cJSON_AddItemToObject(root, "params", params_json);
-        } else {
-            // 如果解析失败，添加一个空数组
-            cJSON_AddArrayToObject(root, "params");
-            ESP_LOGW(TAG, "Failed to parse params: %s, using empty array", params);
-        }
-    } else {
-        // 添加空数组作为参数
-        cJSON_AddArrayToObject(root, "params");
+    // 请求体由调用者预先生成，只改写id后直接交给HTTP客户端，不复制也不分配
+    web3_stamp_request_id(body, body_len);
+    web3_sink_reset(sink);
+    web3_record_request(body_len, false);
+    return web3_perform_post(context, body, body_len, sink);
+}
+
+esp_err_t web3_send_batch(web3_context_t* context, web3_batch_entry_t* entries, size_t count) {
+    if (!context || !entries || count == 0) {
+        return ESP_ERR_INVALID_ARG;
     }
     
-    cJSON_AddNumberToObject(root, "id", request_id++);
+    // 请求数组一次性分配: '[' + 各请求 + ',' 分隔 + ']' + '\0'
+    size_t post_len = 3;
     
-    char *post_data = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
+    for (size_t i = 0; i < count; i++) {
+        if (!entries[i].method || !entries[i].result || entries[i].result_len == 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        
+        entries[i].err = ESP_ERR_NOT_FOUND;
+        memset(entries[i].result, 0, entries[i].result_len);
+        // 不合法的params会被替换为"[]"，按原文长度估算总是足够
+        post_len += web3_request_size(entries[i].method, entries[i].params ? entries[i].params : "[]") + 1;
+    }
     
+    char *post_data = malloc(post_len);
     if (!post_data) {
         return ESP_ERR_NO_MEM;
     }
     
-    // 记录完整URL和请求内容
-    char full_url[256];
-    strncpy(full_url, context->url, sizeof(full_url) - 1);
-    full_url[sizeof(full_url) - 1] = '\0';
+    // 条目i使用id = first_id + i
+    int first_id = (int)web3_reserve_request_ids(count);
+    size_t offset = 0;
+    post_data[offset++] = '[';
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0) {
+            post_data[offset++] = ',';
+        }
+        offset += web3_write_request(post_data + offset, post_len - offset, entries[i].method,
+                                     web3_checked_params(entries[i].params), (uint32_t)(first_id + (int)i));
+    }
+    post_data[offset++] = ']';
+    post_data[offset] = '\0';
+    web3_record_request(offset, true);
     
-    ESP_LOGI(TAG, "发送请求到 %s: %s", full_url, post_data);
-    esp_http_client_set_url(context->client, full_url); // 确保URL设置正确
-    esp_http_client_set_post_field(context->client, post_data, strlen(post_data));
+    // 响应大小取决于节点，放入可增长缓冲区 (按Content-Length一次分配)
+    web3_response_sink_t sink;
+    web3_sink_init_growable(&sink, 0);
+    
+    esp_err_t err = web3_perform_post(context, post_data, offset, &sink);
+    free(post_data);
     
-    // 执行请求
-    esp_err_t err = esp_http_client_perform(context->client);
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "HTTP POST 请求发送失败: %s", esp_err_to_name(err));
-        free(post_data);
+        web3_sink_free(&sink);
         return err;
     }
     
-    int status_code = esp_http_client_get_status_code(context->client);
-    ESP_LOGI(TAG, "HTTP 状态 = %d", status_code);
-    
-    if (status_code != 200) {
-        ESP_LOGE(TAG, "HTTP 状态异常 %d", status_code);
-        free(post_data);
+    // 直接在接收缓冲区上扫描，不构建cJSON树
+    eth_json_token_t root;
+    if (eth_json_parse(sink.buffer, sink.length, &root) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to parse batch response");
+        web3_sink_free(&sink);
         return ESP_FAIL;
     }
     
-    free(post_data);
-    
-    // 如果事件处理器成功收集了响应数据
-    if (response_buffer.data_length > 0) {
-        // 确保字符串以null字符结尾
-        if (response_buffer.data_length < result_len) {
-            result[response_buffer.data_length] = '\0';
+    // 节点不支持批量请求时通常返回单个错误对象
+    if (root.type != ETH_JSON_ARRAY) {
+        eth_rpc_response_t resp;
+        if (eth_json_parse_response(root.start, root.len, &resp) == ESP_OK &&
+            resp.error_message.type == ETH_JSON_STRING) {
+            ESP_LOGE(TAG, "Batch rejected by node: %.*s", (int)resp.error_message.len, resp.error_message.start);
         } else {
-            result[result_len - 1] = '\0';
+            ESP_LOGE(TAG, "Batch response is not an array");
+        }
+        web3_sink_free(&sink);
+        return ESP_FAIL;
+    }
+    
+    // 响应顺序不保证与请求一致，按id匹配
+    const char *cursor = NULL;
+    eth_json_token_t item;
+    while (eth_json_array_next(&root, &cursor, &item) == ESP_OK) {
+        eth_rpc_response_t resp;
+        uint64_t id = 0;
+        if (item.type != ETH_JSON_OBJECT ||
+            eth_json_parse_response(item.start, item.len, &resp) != ESP_OK ||
+            resp.id.type != ETH_JSON_NUMBER || eth_json_token_to_uint64(&resp.id, &id) != ESP_OK) {
+            ESP_LOGW(TAG, "Batch response item without numeric id, skipped");
+            continue;
         }
         
-        ESP_LOGI(TAG, "响应: %s", result);
-        return ESP_OK;
+        int index = (int)id - first_id;
+        if (index < 0 || (size_t)index >= count) {
+            ESP_LOGW(TAG, "Batch response id %d does not belong to this batch", (int)id);
+            continue;
+        }
+        
+        web3_batch_entry_t *entry = &entries[index];
+        if (eth_json_token_copy_raw(&item, entry->result, entry->result_len) != ESP_OK) {
+            ESP_LOGE(TAG, "Result buffer too small for batch entry %d (%s)", index, entry->method);
+            entry->result[0] = '\0';
+            entry->err = ESP_ERR_INVALID_SIZE;
+            continue;
+        }
+        
+        if (resp.error.type != ETH_JSON_NONE) {
+            if (resp.error_message.type == ETH_JSON_STRING) {
+                ESP_LOGE(TAG, "Error from Ethereum node (%s): %.*s", entry->method,
+                         (int)resp.error_message.len, resp.error_message.start);
+            }
+            entry->err = ESP_FAIL;
+        } else {
+            entry->err = ESP_OK;
+        }
+    }
+    
+    web3_sink_free(&sink);
+    
+    err = ESP_OK;
+    for (size_t i = 0; i < count; i++) {
+        if (entries[i].err == ESP_ERR_NOT_FOUND) {
+            ESP_LOGE(TAG, "No response for batch entry %d (%s)", (int)i, entries[i].method);
+        }
+        if (entries[i].err != ESP_OK) {
+            err = ESP_FAIL;
+        }
     }
     
-    ESP_LOGE(TAG, "没有接收到响应数据");
-    return ESP_FAIL;
+    return err;
 }
 
 esp_err_t web3_cleanup(web3_context_t* context) {
@@ -194,12 +581,14 @@ esp_err_t web3_cleanup(web3_context_t* context) {
         return ESP_ERR_INVALID_ARG;
     }
     
-    if (context->client) {
-        esp_http_client_cleanup(context->client);
+    if (context->transport) {
+        context->transport->ops->destroy(context->transport);
+        context->transport = NULL;
     }
     
     if (context->url) {
         free(context->url);
+        context->url = NULL;
     }
     
     return ESP_OK;
@@ -1,7 +1,7 @@
 /*
     介绍：
     这是一个用于与以太坊节点进行通信的库，支持发送JSON-RPC请求。
-    该库使用ESP-IDF的HTTP客户端库来发送请求和接收响应。
+    请求经由可替换的传输后端发送和接收 (默认使用ESP-IDF的HTTP客户端，见web3_transport.h)。
     它提供了初始化、发送请求和清理上下文的功能。
     该库支持的请求包括获取区块号、账户余额、交易收据、客户端版本和Keccak256哈希值。
     该库还提供了一个测试函数，用于测试与指定主机和端口的TCP连接。
@@ -11,41 +11,320 @@
 
 */
 
-#include <esp_http_client.h>
 #include <esp_err.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <esp_heap_caps.h>
 
 #ifndef WEB3_H
 #define WEB3_H
 
+// 请求体不超过该长度时写在栈上，不做堆分配
+#ifndef WEB3_REQUEST_STACK_BUFFER
+#define WEB3_REQUEST_STACK_BUFFER 256
+#endif
+
+// 可增长响应缓冲区的默认上限
+#ifndef WEB3_RESPONSE_MAX_SIZE
+#define WEB3_RESPONSE_MAX_SIZE (256 * 1024)
+#endif
+
+// 可增长响应缓冲区优先使用的内存 (没有PSRAM时自动退回内部RAM)
+#ifndef WEB3_SINK_DEFAULT_CAPS
+#define WEB3_SINK_DEFAULT_CAPS (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+#endif
+
+/**
+ * @brief 流式响应回调，每收到一段数据调用一次
+ * 
+ * @param user_ctx 用户上下文
+ * @param data 本段数据 (不以'\0'结尾)
+ * @param len 数据长度
+ * @return esp_err_t 返回非ESP_OK时丢弃剩余数据，请求以该错误结束
+ */
+typedef esp_err_t (*web3_sink_write_fn)(void* user_ctx, const char* data, size_t len);
+
+/**
+ * @brief 响应数据的去向
+ */
+typedef enum {
+    WEB3_SINK_FIXED,      // 调用者提供的固定缓冲区，放不下时请求失败 (ESP_ERR_INVALID_SIZE)
+    WEB3_SINK_GROWABLE,   // 按Content-Length预分配、必要时倍增的堆缓冲区 (优先PSRAM)
+    WEB3_SINK_STREAM,     // 数据直接交给回调，不做缓存
+} web3_sink_type_t;
+
+/**
+ * @brief 响应sink
+ * 
+ * FIXED和GROWABLE类型的buffer始终以'\0'结尾；GROWABLE类型用完后需调用
+ * web3_sink_free释放。
+ */
+typedef struct {
+    web3_sink_type_t type;
+    char* buffer;               // 响应数据 (FIXED/GROWABLE)
+    size_t capacity;            // 缓冲区大小
+    size_t length;              // 已接收字节数
+    size_t max_size;            // GROWABLE的上限
+    uint32_t caps;              // GROWABLE的分配属性
+    web3_sink_write_fn write;   // STREAM回调
+    void* user_ctx;             // STREAM回调的用户上下文
+    esp_err_t err;              // 接收过程中的第一个错误
+} web3_response_sink_t;
+
+struct web3_transport;
+
 typedef struct {
     char* url;
-    esp_http_client_config_t config;
-    esp_http_client_handle_t client;
+    struct web3_transport* transport;   // 发送请求体、接收响应的后端，由web3_cleanup释放
 } web3_context_t;
 
 /**
  * @brief 初始化web3上下文
  * 
+ * URL为http://或https://时使用HTTP POST；为ws://或wss://时建立WebSocket连接，
+ * 请求接口不变，另外可以用web3_subscribe接收节点推送。
+ * 
  * @param context web3上下文
  * @param url Ethereum节点的RPC URL
  * @return esp_err_t ESP_OK成功，其他值失败
  */
 esp_err_t web3_init(web3_context_t* context, const char* url);
 
+/**
+ * @brief 使用指定的传输后端初始化web3上下文
+ * 
+ * 用于选择原始socket或mock后端 (见web3_transport.h)。无论成功与否，
+ * transport都归上下文所有，由web3_cleanup或本函数在失败时释放。
+ * 
+ * @param context web3上下文
+ * @param url 节点URL，仅用于日志，可为NULL
+ * @param transport 传输后端
+ * @return esp_err_t ESP_OK成功，其他值失败
+ */
+esp_err_t web3_init_with_transport(web3_context_t* context, const char* url, struct web3_transport* transport);
+
+/**
+ * @brief 使用调用者提供的固定缓冲区作为sink
+ */
+void web3_sink_init_fixed(web3_response_sink_t* sink, char* buffer, size_t buffer_len);
+
+/**
+ * @brief 使用可增长缓冲区作为sink
+ * 
+ * @param sink 响应sink
+ * @param max_size 缓冲区上限，0表示WEB3_RESPONSE_MAX_SIZE
+ */
+void web3_sink_init_growable(web3_response_sink_t* sink, size_t max_size);
+
+/**
+ * @brief 使用流式回调作为sink
+ */
+void web3_sink_init_stream(web3_response_sink_t* sink, web3_sink_write_fn write, void* user_ctx);
+
+/**
+ * @brief 清空已接收的数据 (保留已分配的缓冲区，可复用于下一次请求)
+ */
+void web3_sink_reset(web3_response_sink_t* sink);
+
+/**
+ * @brief 释放GROWABLE类型sink的缓冲区
+ */
+void web3_sink_free(web3_response_sink_t* sink);
+
+/**
+ * @brief 向sink写入数据 (HTTP事件处理器使用，也可用于其他传输方式)
+ * 
+ * @return esp_err_t ESP_OK成功，放不下时返回ESP_ERR_INVALID_SIZE，分配失败返回ESP_ERR_NO_MEM
+ */
+esp_err_t web3_sink_write(web3_response_sink_t* sink, const char* data, size_t len);
+
+/**
+ * @brief 请求体写入与连接复用统计
+ */
+typedef struct {
+    uint32_t requests;           // 已写入的请求体数量 (批量请求计为1个)
+    uint32_t heap_allocations;   // 其中需要堆分配的数量
+    uint64_t bytes_written;      // 请求体总字节数
+    uint32_t connections_opened; // 新建的HTTP连接数 (每次都有TCP/TLS握手)
+    uint32_t connections_reused; // 在已有keep-alive连接上完成的请求数
+    uint32_t idle_reconnects;    // 空闲超过WEB3_HTTP_IDLE_TIMEOUT_MS而在发送前主动关闭的连接数
+    uint32_t stale_replays;      // 复用的连接已被节点关闭、在新连接上重发的只读请求数
+    uint32_t keep_alives;        // web3_keep_alive发送的保活请求数
+} web3_request_stats_t;
+
 /**
  * @brief 发送JSON-RPC请求
  * 
+ * params文本先做一次严格的语法校验 (eth_json_validate)，再原样拼接进请求信封，
+ * 不经过重新序列化；不是恰好一个合法JSON数组时按空数组发送。请求体不超过
+ * WEB3_REQUEST_STACK_BUFFER时不做任何堆分配。
+ * 
  * @param context web3上下文
  * @param method RPC方法名
- * @param params JSON格式的参数
+ * @param params JSON数组格式的参数 (可为NULL，表示空数组)
  * @param result 结果缓冲区
  * @param result_len 结果缓冲区长度
- * @return esp_err_t ESP_OK成功，其他值失败
+ * @return esp_err_t ESP_OK成功，响应放不下时返回ESP_ERR_INVALID_SIZE，其他值失败
  */
 esp_err_t web3_send_request(web3_context_t* context, const char* method, 
                            const char* params, char* result, size_t result_len);
 
+/**
+ * @brief 发送JSON-RPC请求，响应写入指定的sink
+ * 
+ * 与web3_send_request相同，但响应大小不受调用者固定数组的限制；
+ * 响应不完整时返回sink中记录的错误，而不是截断的数据。
+ * 
+ * @param context web3上下文
+ * @param method RPC方法名
+ * @param params JSON数组格式的参数 (可为NULL，表示空数组)
+ * @param sink 响应sink (每次请求前会被重置)
+ * @return esp_err_t ESP_OK成功，其他值失败
+ */
+esp_err_t web3_send_request_sink(web3_context_t* context, const char* method,
+                                 const char* params, web3_response_sink_t* sink);
+
+/**
+ * @brief 生成完整的JSON-RPC请求体，供web3_send_body_sink重复发送
+ * 
+ * 请求体与web3_send_request_sink发送的格式相同，id占定宽位置 (数字后补空格)，
+ * web3_send_body_sink每次发送前在原位写入新的id。
+ * 
+ * @param method RPC方法名
+ * @param params JSON数组格式的参数 (可为NULL，表示空数组)
+ * @param body 输出的请求体 (以'\0'结尾，由调用者free)
+ * @param body_len 请求体长度 (不含'\0')
+ * @return esp_err_t ESP_OK成功，内存不足返回ESP_ERR_NO_MEM
+ */
+esp_err_t web3_render_request(const char* method, const char* params, char** body, size_t* body_len);
+
+/**
+ * @brief 发送预先生成的请求体，响应写入指定的sink
+ * 
+ * 请求体直接交给HTTP客户端，不复制、不分配，也不检查内容。由web3_render_request生成的
+ * 请求体每次发送前在原位写入新的id，重复发送时迟到的旧响应不会被当作本次的响应。
+ * 
+ * @param context web3上下文
+ * @param body 完整的JSON-RPC请求体 (以'\0'结尾，id位置会被改写)
+ * @param body_len 请求体长度
+ * @param sink 响应sink (每次请求前会被重置)
+ * @return esp_err_t ESP_OK成功，其他值失败
+ */
+esp_err_t web3_send_body_sink(web3_context_t* context, char* body, size_t body_len,
+                              web3_response_sink_t* sink);
+
+/**
+ * @brief JSON-RPC批量请求中的单个条目
+ */
+typedef struct {
+    const char* method;   // RPC方法名
+    const char* params;   // JSON格式的参数 (可为NULL，表示空数组)
+    char* result;         // 该条目对应的响应对象 (与web3_send_request的结果格式相同)
+    size_t result_len;    // 结果缓冲区长度
+    esp_err_t err;        // 该条目的处理结果 (由web3_send_batch填写)
+} web3_batch_entry_t;
+
+/**
+ * @brief 在一次HTTP请求中发送多个JSON-RPC调用
+ * 
+ * 所有条目被打包为一个JSON-RPC数组POST给节点，响应按id匹配回对应条目。
+ * 每个条目的err字段单独给出结果：ESP_OK、节点返回error时为ESP_FAIL、
+ * 响应中缺少该id时为ESP_ERR_NOT_FOUND、结果缓冲区不足时为ESP_ERR_INVALID_SIZE。
+ * 
+ * @param context web3上下文
+ * @param entries 请求条目数组
+ * @param count 条目数量
+ * @return esp_err_t 所有条目都收到响应时返回ESP_OK，其他值失败
+ */
+esp_err_t web3_send_batch(web3_context_t* context, web3_batch_entry_t* entries, size_t count);
+
+/*
+    订阅 (仅WebSocket传输)
+
+    eth_subscribe返回的订阅ID与回调登记在上下文中，节点推送的eth_subscription
+    通知按ID分发。回调在WebSocket接收任务中执行，应尽快返回，且不能在回调中
+    通过同一个上下文发送请求 (响应也由该任务接收)。
+*/
+
+#define WEB3_SUBSCRIPTION_ID_LEN 67   // "0x" + 最多64个十六进制字符 + '\0'
+
+// 每个连接同时登记的订阅数
+#ifndef WEB3_WS_MAX_SUBSCRIPTIONS
+#define WEB3_WS_MAX_SUBSCRIPTIONS 4
+#endif
+
+/**
+ * @brief 订阅通知回调
+ * 
+ * @param user_ctx 订阅时传入的用户上下文
+ * @param result 通知中params.result的JSON文本 (不以'\0'结尾)，回调期间有效，可以原地修改
+ * @param result_len 文本长度
+ */
+typedef void (*web3_subscription_handler_t)(void* user_ctx, char* result, size_t result_len);
+
+/**
+ * @brief 发送eth_subscribe并登记回调
+ * 
+ * 回调在收到订阅响应的同时登记，不会漏掉紧跟在响应之后的通知。
+ * 
+ * @param context web3上下文 (必须使用WebSocket传输)
+ * @param params eth_subscribe的参数，如 "[\"newHeads\"]"
+ * @param handler 通知回调
+ * @param user_ctx 回调的用户上下文
+ * @param subscription_id 输出的订阅ID
+ * @return esp_err_t ESP_OK成功，HTTP传输返回ESP_ERR_NOT_SUPPORTED，
+ *         订阅数已满返回ESP_ERR_NO_MEM，其他值失败
+ */
+esp_err_t web3_subscribe(web3_context_t* context, const char* params, web3_subscription_handler_t handler,
+                         void* user_ctx, char subscription_id[WEB3_SUBSCRIPTION_ID_LEN]);
+
+/**
+ * @brief 注销回调并发送eth_unsubscribe
+ * 
+ * 返回前等待正在执行的通知回调结束，返回后回调不会再被调用，可以释放user_ctx。
+ * 同样不能在回调中调用。
+ * 
+ * @param context web3上下文
+ * @param subscription_id web3_subscribe返回的订阅ID
+ * @return esp_err_t ESP_OK成功，未找到该订阅返回ESP_ERR_NOT_FOUND，其他值失败
+ */
+esp_err_t web3_unsubscribe(web3_context_t* context, const char* subscription_id);
+
+/**
+ * @brief 订阅是否仍然有效
+ * 
+ * 连接断开时节点上的订阅全部失效 (客户端自动重连后不会恢复)，
+ * 调用者据此重新订阅，并补查断开期间可能错过的状态。
+ * 
+ * @param context web3上下文
+ * @param subscription_id web3_subscribe返回的订阅ID
+ * @return true 订阅仍在当前连接上有效
+ */
+bool web3_is_subscribed(web3_context_t* context, const char* subscription_id);
+
+/**
+ * @brief 在两次请求之间保持HTTP连接可用
+ * 
+ * 节点会关闭空闲超过几秒的keep-alive连接，请求间隔更长时每个请求都要先重新握手 (TCP/TLS)。
+ * 长时间等待的调用者每隔不超过WEB3_HTTP_KEEPALIVE_MS调用一次: 连接空闲超过该时间时发送一个
+ * eth_chainId，使节点重置空闲计时；连接已关闭或已过期时在这里重新建立。
+ * 代价是等待期间每隔WEB3_HTTP_KEEPALIVE_MS一个很小的请求；不调用时行为不变，重连发生在下一次请求内。
+ * 
+ * @param context web3上下文
+ * @return esp_err_t ESP_OK连接可用，后端没有HTTP连接 (WebSocket、mock) 时返回ESP_ERR_NOT_SUPPORTED，
+ *         其他值为保活请求的错误
+ */
+esp_err_t web3_keep_alive(web3_context_t* context);
+
+/**
+ * @brief 获取请求体写入与连接复用统计
+ * 
+ * @param stats 输出的统计数据
+ * @return esp_err_t ESP_OK成功，其他值失败
+ */
+esp_err_t web3_get_request_stats(web3_request_stats_t* stats);
+
 /**
  * @brief 清理web3上下文
  * 
@@ -0,0 +1,163 @@
+/*
+    传输后端
+
+    web3_context_t只通过web3_transport_ops_t发送请求体、把响应写入sink，
+    eth_rpc、eth_abi和签名代码都不依赖具体的网络库。现有后端:
+
+    - esp_http_client      web3_init对http://、https://的默认选择
+    - 原始socket HTTP/1.1  只支持http://，不经过HTTP客户端的缓冲区和状态机，
+                           每个请求的CPU和RAM开销更小，也能在Linux上编译
+    - WebSocket            web3_init对ws://、wss://的选择，支持web3_subscribe
+    - 进程内mock           不访问网络，由回调生成响应，用于主机上的测试和压测
+
+    web3_context_t context;
+    web3_transport_t* transport;
+    web3_transport_socket_create("http://192.168.1.100:8545", &transport);
+    web3_init_with_transport(&context, "http://192.168.1.100:8545", transport);  // 上下文接管transport
+
+*/
+
+#ifndef WEB3_TRANSPORT_H
+#define WEB3_TRANSPORT_H
+
+#include "web3.h"
+
+/*
+    HTTP keep-alive (esp_http_client和原始socket后端)
+
+    节点未要求关闭时连接保持打开，下一次请求直接复用。节点的空闲超时
+    (Node.js/Hardhat默认5秒) 到期后会关闭连接，此时复用会失败。因此:
+    - 空闲超过WEB3_HTTP_IDLE_TIMEOUT_MS的连接在发送前主动关闭，请求在新连接上发送；
+    - 复用的连接仍然失败且尚未收到任何数据时，只读请求在新连接上自动重发一次
+      (eth_sendRawTransaction、eth_getFilterChanges等不重发)；
+    - 两次请求间隔长于空闲超时时，重连发生在下一次请求内。长时间等待的调用者
+      每隔WEB3_HTTP_KEEPALIVE_MS调用web3_keep_alive，使连接保持可用，重连移出请求路径。
+*/
+#ifndef WEB3_HTTP_IDLE_TIMEOUT_MS
+#define WEB3_HTTP_IDLE_TIMEOUT_MS 4000
+#endif
+
+// 连接空闲超过该时间时web3_keep_alive发送保活请求，需小于WEB3_HTTP_IDLE_TIMEOUT_MS
+#ifndef WEB3_HTTP_KEEPALIVE_MS
+#define WEB3_HTTP_KEEPALIVE_MS (WEB3_HTTP_IDLE_TIMEOUT_MS - 1000)
+#endif
+
+// 连接、发送和等待响应的超时
+#ifndef WEB3_HTTP_TIMEOUT_MS
+#define WEB3_HTTP_TIMEOUT_MS 10000
+#endif
+
+typedef struct web3_transport web3_transport_t;
+
+/**
+ * @brief 传输后端的函数表
+ */
+typedef struct {
+    const char* name;
+
+    /**
+     * @brief 发送一个请求体，把完整的响应写入sink
+     *
+     * 只返回传输层的错误 (连接、超时、HTTP状态)；sink中的错误和空响应由调用者检查。
+     * 同一个后端不会被并发调用。
+     */
+    esp_err_t (*perform)(web3_transport_t* transport, const char* body, size_t body_len,
+                         web3_response_sink_t* sink);
+
+    /**
+     * @brief 当前连接已空闲的毫秒数，没有打开的连接时返回-1
+     *
+     * 可为NULL: 后端没有需要保活的HTTP连接 (WebSocket由客户端的ping保持，mock不联网)。
+     */
+    int64_t (*idle_ms)(web3_transport_t* transport);
+
+    /**
+     * @brief 关闭连接并释放后端
+     */
+    void (*destroy)(web3_transport_t* transport);
+} web3_transport_ops_t;
+
+/**
+ * @brief 后端的公共头部，具体后端把它作为结构体的第一个成员
+ */
+struct web3_transport {
+    const web3_transport_ops_t* ops;
+};
+
+/**
+ * @brief mock后端的请求回调
+ *
+ * @param user_ctx 创建时传入的用户上下文
+ * @param body 请求体 (不以'\0'结尾)
+ * @param body_len 请求体长度
+ * @param sink 响应写入这里 (web3_sink_write)
+ * @return esp_err_t 作为传输层结果返回给调用者
+ */
+typedef esp_err_t (*web3_mock_handler_t)(void* user_ctx, const char* body, size_t body_len,
+                                         web3_response_sink_t* sink);
+
+/**
+ * @brief 创建esp_http_client后端
+ *
+ * @param url http://或https://地址
+ * @param transport 输出的后端
+ * @return esp_err_t ESP_OK成功，内存不足返回ESP_ERR_NO_MEM，其他值失败
+ */
+esp_err_t web3_transport_http_create(const char* url, web3_transport_t** transport);
+
+/**
+ * @brief 创建原始socket HTTP/1.1后端
+ *
+ * 主机名在第一次连接时解析并缓存。响应需要带Content-Length，或以关闭连接结束；
+ * 不支持chunked编码。
+ *
+ * @param url http://主机[:端口][/路径]
+ * @param transport 输出的后端
+ * @return esp_err_t ESP_OK成功，https://返回ESP_ERR_NOT_SUPPORTED，URL无效返回ESP_ERR_INVALID_ARG
+ */
+esp_err_t web3_transport_socket_create(const char* url, web3_transport_t** transport);
+
+/**
+ * @brief 创建WebSocket后端并建立连接
+ *
+ * @param url ws://或wss://地址
+ * @param transport 输出的后端
+ * @return esp_err_t ESP_OK成功，连接超时返回ESP_ERR_TIMEOUT，其他值失败
+ */
+esp_err_t web3_transport_ws_create(const char* url, web3_transport_t** transport);
+
+/**
+ * @brief 判断URL是否使用WebSocket传输
+ */
+bool web3_ws_is_url(const char* url);
+
+/**
+ * @brief 创建进程内mock后端
+ *
+ * @param handler 为每个请求生成响应的回调
+ * @param user_ctx 回调的用户上下文
+ * @param transport 输出的后端
+ * @return esp_err_t ESP_OK成功，其他值失败
+ */
+esp_err_t web3_transport_mock_create(web3_mock_handler_t handler, void* user_ctx, web3_transport_t** transport);
+
+/*
+    后端共用的辅助函数 (库内部使用)
+*/
+
+/**
+ * @brief 确保可增长sink能再容纳additional字节，exact为true时一次分配到位 (已知Content-Length)
+ */
+esp_err_t web3_sink_reserve(web3_response_sink_t* sink, size_t additional, bool exact);
+
+/**
+ * @brief 请求体 (单个请求或批量数组) 中的每个方法都是只读方法时返回true
+ */
+bool web3_body_is_idempotent(const char* body, size_t body_len);
+
+/**
+ * @brief 记录一次成功请求的连接情况，计入web3_request_stats_t
+ */
+void web3_record_connection(bool opened, bool idle_reconnect, bool replayed);
+
+#endif /* WEB3_TRANSPORT_H */
@@ -0,0 +1,225 @@
+#include "web3_transport.h"
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <esp_http_client.h>
+
+static const char *TAG = "WEB3_HTTP";
+
+typedef struct {
+    web3_transport_t base;
+    char* url;
+    esp_http_client_config_t config;
+    esp_http_client_handle_t client;
+    bool connected;               // 连接当前是否保持打开
+    uint32_t connection_requests; // 当前连接上已完成的请求数
+    int64_t last_activity_us;     // 上一次请求结束的时间
+} web3_http_transport_t;
+
+// 一次HTTP请求期间事件处理器的上下文
+typedef struct {
+    web3_http_transport_t* http;
+    web3_response_sink_t* sink;
+    bool opened;                  // 本次请求新建了连接
+} web3_http_exchange_t;
+
+// HTTP事件处理函数，响应数据写入user_data指向的请求上下文中的sink
+static esp_err_t http_event_handler(esp_http_client_event_t *evt)
+{
+    // 请求之外 (主动关闭或清理时) user_data为NULL
+    web3_http_exchange_t *exchange = (web3_http_exchange_t *)evt->user_data;
+    web3_response_sink_t *sink = exchange ? exchange->sink : NULL;
+
+    switch(evt->event_id) {
+        case HTTP_EVENT_ON_CONNECTED:
+            if (exchange) {
+                exchange->opened = true;
+                exchange->http->connected = true;
+                exchange->http->connection_requests = 0;
+            }
+            return ESP_OK;
+
+        case HTTP_EVENT_DISCONNECTED:
+            // 节点返回Connection: close时客户端在请求结束后自行关闭
+            if (exchange) {
+                exchange->http->connected = false;
+            }
+            return ESP_OK;
+
+        case HTTP_EVENT_ON_HEADER:
+            // 可增长缓冲区按Content-Length一次分配到位
+            if (sink && sink->type == WEB3_SINK_GROWABLE && sink->err == ESP_OK &&
+                strcasecmp(evt->header_key, "Content-Length") == 0) {
+                size_t content_length = strtoul(evt->header_value, NULL, 10);
+                esp_err_t err = web3_sink_reserve(sink, content_length, true);
+                if (err != ESP_OK) {
+                    ESP_LOGE(TAG, "Response of %d bytes exceeds sink limit: %s",
+                             (int)content_length, esp_err_to_name(err));
+                    sink->err = err;
+                }
+            }
+            return ESP_OK;
+
+        case HTTP_EVENT_ON_DATA:
+            if (sink && web3_sink_write(sink, evt->data, evt->data_len) == ESP_OK) {
+                ESP_LOGD(TAG, "Received %d bytes, total: %d", evt->data_len, (int)sink->length);
+            }
+            return ESP_OK;
+
+        case HTTP_EVENT_ON_FINISH:
+            ESP_LOGI(TAG, "HTTP request completed");
+            return ESP_OK;
+
+        case HTTP_EVENT_ERROR:
+            ESP_LOGE(TAG, "HTTP error");
+            return ESP_FAIL;
+
+        default:
+            return ESP_OK;
+    }
+}
+
+/*
+    复用的连接是否已被节点关闭: 读响应头时收到FIN，或写入/读取时连接被重置。
+    读超时说明请求可能已到达节点，不属于此类，重发只会让调用者再等一个超时
+*/
+static bool web3_http_connection_closed(web3_http_transport_t* http, esp_err_t err) {
+    if (err == ESP_ERR_HTTP_CONNECTION_CLOSED) {
+        return true;
+    }
+    if (err != ESP_ERR_HTTP_WRITE_DATA && err != ESP_ERR_HTTP_FETCH_HEADER) {
+        return false;
+    }
+    int sock_errno = esp_http_client_get_errno(http->client);
+    return sock_errno == ECONNRESET || sock_errno == EPIPE || sock_errno == ENOTCONN || sock_errno == ECONNABORTED;
+}
+
+static esp_err_t web3_http_perform(web3_transport_t* transport, const char* post_data, size_t post_len,
+                                   web3_response_sink_t* sink) {
+    web3_http_transport_t* http = (web3_http_transport_t*)transport;
+
+    // 空闲太久的连接可能已被节点关闭，发送前主动关闭，避免请求写进失效的socket后再重试
+    bool idle_reconnect = false;
+    if (http->connected &&
+        esp_timer_get_time() - http->last_activity_us > (int64_t)WEB3_HTTP_IDLE_TIMEOUT_MS * 1000) {
+        ESP_LOGD(TAG, "连接空闲超过 %d ms，重新连接", WEB3_HTTP_IDLE_TIMEOUT_MS);
+        esp_http_client_close(http->client);
+        http->connected = false;
+        idle_reconnect = true;
+    }
+
+    // URL在初始化时已设置，连接打开时直接复用，不再重新解析
+    web3_http_exchange_t exchange = { .http = http, .sink = sink };
+    esp_http_client_set_user_data(http->client, &exchange);
+    ESP_LOGI(TAG, "发送请求到 %s: %s", http->url, post_data);
+    esp_http_client_set_post_field(http->client, post_data, (int)post_len);
+
+    // 执行请求
+    bool reused = http->connected;
+    esp_err_t err = esp_http_client_perform(http->client);
+
+    // 复用的连接已被节点关闭: 尚未收到任何数据的只读请求在新连接上重发一次；
+    // 超时和HTTP层错误原样返回
+    bool replayed = false;
+    if (err != ESP_OK && reused && !exchange.opened && sink->length == 0 &&
+        web3_http_connection_closed(http, err) && web3_body_is_idempotent(post_data, post_len)) {
+        ESP_LOGW(TAG, "keep-alive连接已失效 (%s)，在新连接上重发", esp_err_to_name(err));
+        esp_http_client_close(http->client);
+        http->connected = false;
+        web3_sink_reset(sink);
+        replayed = true;
+        err = esp_http_client_perform(http->client);
+    }
+
+    // 下一次请求前的关闭/清理不再引用栈上的exchange
+    esp_http_client_set_user_data(http->client, NULL);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "HTTP POST 请求发送失败: %s", esp_err_to_name(err));
+        esp_http_client_close(http->client);
+        http->connected = false;
+        return err;
+    }
+    http->connection_requests++;
+    http->last_activity_us = esp_timer_get_time();
+    web3_record_connection(exchange.opened, idle_reconnect, replayed);
+
+    int status_code = esp_http_client_get_status_code(http->client);
+    ESP_LOGI(TAG, "HTTP 状态 = %d", status_code);
+
+    if (status_code != 200) {
+        ESP_LOGE(TAG, "HTTP 状态异常 %d", status_code);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+static int64_t web3_http_idle_ms(web3_transport_t* transport) {
+    web3_http_transport_t* http = (web3_http_transport_t*)transport;
+    return http->connected ? (esp_timer_get_time() - http->last_activity_us) / 1000 : -1;
+}
+
+static void web3_http_destroy(web3_transport_t* transport) {
+    web3_http_transport_t* http = (web3_http_transport_t*)transport;
+    if (http->client) {
+        esp_http_client_cleanup(http->client);
+    }
+    free(http->url);
+    free(http);
+}
+
+static const web3_transport_ops_t WEB3_HTTP_OPS = {
+    .name = "esp_http_client",
+    .perform = web3_http_perform,
+    .idle_ms = web3_http_idle_ms,
+    .destroy = web3_http_destroy,
+};
+
+esp_err_t web3_transport_http_create(const char* url, web3_transport_t** transport) {
+    if (!url || !transport) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    web3_http_transport_t* http = calloc(1, sizeof(*http));
+    if (!http) {
+        return ESP_ERR_NO_MEM;
+    }
+    http->base.ops = &WEB3_HTTP_OPS;
+    http->url = strdup(url);
+    if (!http->url) {
+        free(http);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // 判断是否为HTTPS连接
+    bool is_https = (strncmp(url, "https://", 8) == 0);
+
+    http->config = (esp_http_client_config_t) {
+        .url = http->url,
+        .method = HTTP_METHOD_POST,
+        .timeout_ms = WEB3_HTTP_TIMEOUT_MS,
+        // 对于HTTPS连接，跳过证书验证
+        .skip_cert_common_name_check = is_https,
+        .crt_bundle_attach = NULL, // 不使用证书捆绑
+        .cert_pem = NULL,
+        .client_cert_pem = NULL,
+        .client_key_pem = NULL,
+        // 添加事件处理器
+        .event_handler = http_event_handler,
+        // TCP保活探测，及时发现被NAT或节点静默丢弃的空闲连接
+        .keep_alive_enable = true,
+    };
+
+    http->client = esp_http_client_init(&http->config);
+    if (!http->client) {
+        ESP_LOGE(TAG, "Failed to initialize HTTP client");
+        web3_http_destroy(&http->base);
+        return ESP_FAIL;
+    }
+
+    esp_http_client_set_header(http->client, "Content-Type", "application/json");
+    *transport = &http->base;
+    return ESP_OK;
+}
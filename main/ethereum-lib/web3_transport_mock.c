@@ -0,0 +1,44 @@
+#include "web3_transport.h"
+#include <stdlib.h>
+#include <esp_log.h>
+
+static const char *TAG = "WEB3_MOCK";
+
+typedef struct {
+    web3_transport_t base;
+    web3_mock_handler_t handler;
+    void* user_ctx;
+} web3_mock_transport_t;
+
+static esp_err_t web3_mock_perform(web3_transport_t* transport, const char* body, size_t body_len,
+                                   web3_response_sink_t* sink) {
+    web3_mock_transport_t* mock = (web3_mock_transport_t*)transport;
+    ESP_LOGD(TAG, "Request: %.*s", (int)body_len, body);
+    return mock->handler(mock->user_ctx, body, body_len, sink);
+}
+
+static void web3_mock_destroy(web3_transport_t* transport) {
+    free(transport);
+}
+
+static const web3_transport_ops_t WEB3_MOCK_OPS = {
+    .name = "mock",
+    .perform = web3_mock_perform,
+    .destroy = web3_mock_destroy,
+};
+
+esp_err_t web3_transport_mock_create(web3_mock_handler_t handler, void* user_ctx, web3_transport_t** transport) {
+    if (!handler || !transport) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    web3_mock_transport_t* mock = calloc(1, sizeof(*mock));
+    if (!mock) {
+        return ESP_ERR_NO_MEM;
+    }
+    mock->base.ops = &WEB3_MOCK_OPS;
+    mock->handler = handler;
+    mock->user_ctx = user_ctx;
+    *transport = &mock->base;
+    return ESP_OK;
+}
@@ -0,0 +1,371 @@
+#include "web3_transport.h"
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <esp_log.h>
+
+static const char *TAG = "WEB3_SOCKET";
+
+// 状态行和响应头的最大长度，同时作为接收响应体的中转缓冲区
+#ifndef WEB3_SOCKET_HEADER_MAX
+#define WEB3_SOCKET_HEADER_MAX 1024
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+#ifndef MSG_MORE
+#define MSG_MORE 0
+#endif
+
+typedef struct {
+    web3_transport_t base;
+    char host[128];
+    char port[8];
+    char* request_head;          // 请求行和固定请求头，以"Content-Length: "结尾，创建时生成一次
+    size_t request_head_len;
+    struct sockaddr_storage addr;  // 第一次连接时解析并缓存，连接失败后重新解析
+    socklen_t addr_len;
+    int fd;                      // 保持打开的连接，-1表示未连接
+    int64_t last_activity_ms;    // 上一次请求结束的时间
+    char buffer[WEB3_SOCKET_HEADER_MAX];
+} web3_socket_transport_t;
+
+// 单调时钟 (毫秒)，Linux和ESP-IDF的newlib都支持
+static int64_t web3_socket_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void web3_socket_close(web3_socket_transport_t* sock) {
+    if (sock->fd >= 0) {
+        close(sock->fd);
+        sock->fd = -1;
+    }
+}
+
+static esp_err_t web3_socket_connect(web3_socket_transport_t* sock) {
+    if (sock->addr_len == 0) {
+        struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM };
+        struct addrinfo* res = NULL;
+        if (getaddrinfo(sock->host, sock->port, &hints, &res) != 0 || !res) {
+            ESP_LOGE(TAG, "Failed to resolve %s", sock->host);
+            return ESP_FAIL;
+        }
+        memcpy(&sock->addr, res->ai_addr, res->ai_addrlen);
+        sock->addr_len = res->ai_addrlen;
+        freeaddrinfo(res);
+    }
+
+    int fd = socket(sock->addr.ss_family, SOCK_STREAM, IPPROTO_TCP);
+    if (fd < 0) {
+        ESP_LOGE(TAG, "Failed to create socket: errno %d", errno);
+        return ESP_FAIL;
+    }
+
+    struct timeval timeout = {
+        .tv_sec = WEB3_HTTP_TIMEOUT_MS / 1000,
+        .tv_usec = (WEB3_HTTP_TIMEOUT_MS % 1000) * 1000,
+    };
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &one, sizeof(one));
+    // 请求头和请求体分两次写入，MSG_MORE把它们合并为一个报文段，不等待ACK
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    if (connect(fd, (struct sockaddr*)&sock->addr, sock->addr_len) != 0) {
+        ESP_LOGE(TAG, "Failed to connect to %s:%s: errno %d", sock->host, sock->port, errno);
+        close(fd);
+        // 节点地址可能已变化，下次重新解析
+        sock->addr_len = 0;
+        return ESP_FAIL;
+    }
+
+    sock->fd = fd;
+    return ESP_OK;
+}
+
+static esp_err_t web3_socket_send_all(int fd, const char* data, size_t len, int flags) {
+    while (len > 0) {
+        ssize_t sent = send(fd, data, len, flags | MSG_NOSIGNAL);
+        if (sent <= 0) {
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+            return ESP_FAIL;
+        }
+        data += sent;
+        len -= (size_t)sent;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t web3_socket_recv_error(void) {
+    return (errno == EAGAIN || errno == EWOULDBLOCK) ? ESP_ERR_TIMEOUT : ESP_FAIL;
+}
+
+// 响应头的一行是否为name (不区分大小写)，是则返回值的起始位置
+static const char* web3_socket_header_value(const char* line, const char* line_end, const char* name) {
+    size_t n = strlen(name);
+    if ((size_t)(line_end - line) <= n || strncasecmp(line, name, n) != 0 || line[n] != ':') {
+        return NULL;
+    }
+    const char* value = line + n + 1;
+    while (value < line_end && (*value == ' ' || *value == '\t')) {
+        value++;
+    }
+    return value;
+}
+
+static bool web3_socket_value_contains(const char* value, const char* end, const char* token) {
+    size_t n = strlen(token);
+    for (const char* p = value; p + n <= end; p++) {
+        if (strncasecmp(p, token, n) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+    发送请求并接收响应，响应体写入sink。
+    连接在请求前没有数据可读就被关闭时返回ESP_ERR_INVALID_STATE (复用了失效的连接)。
+*/
+static esp_err_t web3_socket_exchange(web3_socket_transport_t* sock, const char* body, size_t body_len,
+                                      web3_response_sink_t* sink, bool* opened, int* status) {
+    *opened = false;
+    if (sock->fd < 0) {
+        esp_err_t err = web3_socket_connect(sock);
+        if (err != ESP_OK) {
+            return err;
+        }
+        *opened = true;
+    }
+
+    char length_line[24];
+    int length_len = snprintf(length_line, sizeof(length_line), "%u\r\n\r\n", (unsigned)body_len);
+    if (web3_socket_send_all(sock->fd, sock->request_head, sock->request_head_len, MSG_MORE) != ESP_OK ||
+        web3_socket_send_all(sock->fd, length_line, (size_t)length_len, MSG_MORE) != ESP_OK ||
+        web3_socket_send_all(sock->fd, body, body_len, 0) != ESP_OK) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // 读到空行为止，buffer中可能已经包含一部分响应体
+    size_t received = 0;
+    const char* head_end = NULL;
+    while (!head_end) {
+        if (received == sizeof(sock->buffer)) {
+            ESP_LOGE(TAG, "Response header exceeds %d bytes", WEB3_SOCKET_HEADER_MAX);
+            return ESP_ERR_INVALID_SIZE;
+        }
+        ssize_t n = recv(sock->fd, sock->buffer + received, sizeof(sock->buffer) - received, 0);
+        if (n == 0) {
+            return received == 0 ? ESP_ERR_INVALID_STATE : ESP_ERR_INVALID_RESPONSE;
+        }
+        if (n < 0) {
+            return received == 0 && errno == ECONNRESET ? ESP_ERR_INVALID_STATE : web3_socket_recv_error();
+        }
+        size_t from = received > 3 ? received - 3 : 0;
+        received += (size_t)n;
+        head_end = memmem(sock->buffer + from, received - from, "\r\n\r\n", 4);
+    }
+
+    // 状态行: HTTP/1.x NNN ...
+    const char* p = sock->buffer;
+    if (received < 12 || strncmp(p, "HTTP/1.", 7) != 0) {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    bool keep_alive = p[7] == '1';
+    *status = atoi(p + 9);
+
+    long long content_length = -1;
+    const char* line = memchr(p, '\n', head_end + 2 - p) + 1;
+    while (line < head_end) {
+        const char* line_end = memchr(line, '\r', head_end + 2 - line);
+        const char* value;
+        if ((value = web3_socket_header_value(line, line_end, "Content-Length")) != NULL) {
+            content_length = strtoll(value, NULL, 10);
+        } else if ((value = web3_socket_header_value(line, line_end, "Connection")) != NULL) {
+            keep_alive = !web3_socket_value_contains(value, line_end, "close");
+        } else if ((value = web3_socket_header_value(line, line_end, "Transfer-Encoding")) != NULL &&
+                   web3_socket_value_contains(value, line_end, "chunked")) {
+            ESP_LOGE(TAG, "Chunked responses are not supported");
+            return ESP_ERR_NOT_SUPPORTED;
+        }
+        line = line_end + 2;
+    }
+
+    // 可增长缓冲区按Content-Length一次分配到位
+    if (content_length >= 0 && sink->type == WEB3_SINK_GROWABLE && sink->err == ESP_OK) {
+        esp_err_t err = web3_sink_reserve(sink, (size_t)content_length, true);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Response of %lld bytes exceeds sink limit: %s", content_length, esp_err_to_name(err));
+            sink->err = err;
+        }
+    }
+
+    // 没有Content-Length时读到连接关闭为止
+    size_t remaining = content_length >= 0 ? (size_t)content_length : SIZE_MAX;
+    const char* chunk = head_end + 4;
+    size_t chunk_len = received - (size_t)(chunk - sock->buffer);
+    for (;;) {
+        if (chunk_len > remaining) {
+            chunk_len = remaining;
+        }
+        if (chunk_len > 0) {
+            web3_sink_write(sink, chunk, chunk_len);
+            remaining -= chunk_len;
+        }
+        if (remaining == 0) {
+            break;
+        }
+        ssize_t n = recv(sock->fd, sock->buffer, sizeof(sock->buffer), 0);
+        if (n == 0 && content_length < 0) {
+            keep_alive = false;
+            break;
+        }
+        if (n <= 0) {
+            return n == 0 ? ESP_ERR_INVALID_RESPONSE : web3_socket_recv_error();
+        }
+        chunk = sock->buffer;
+        chunk_len = (size_t)n;
+    }
+
+    if (!keep_alive) {
+        web3_socket_close(sock);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t web3_socket_perform(web3_transport_t* transport, const char* body, size_t body_len,
+                                     web3_response_sink_t* sink) {
+    web3_socket_transport_t* sock = (web3_socket_transport_t*)transport;
+
+    // 空闲太久的连接可能已被节点关闭，发送前主动关闭
+    bool idle_reconnect = false;
+    if (sock->fd >= 0 && web3_socket_now_ms() - sock->last_activity_ms > WEB3_HTTP_IDLE_TIMEOUT_MS) {
+        ESP_LOGD(TAG, "连接空闲超过 %d ms，重新连接", WEB3_HTTP_IDLE_TIMEOUT_MS);
+        web3_socket_close(sock);
+        idle_reconnect = true;
+    }
+
+    ESP_LOGI(TAG, "发送请求到 %s:%s: %.*s", sock->host, sock->port, (int)body_len, body);
+    bool reused = sock->fd >= 0;
+    bool opened = false;
+    int status = 0;
+    esp_err_t err = web3_socket_exchange(sock, body, body_len, sink, &opened, &status);
+
+    // 复用的连接已被节点关闭 (ESP_ERR_INVALID_STATE): 只读请求在新连接上重发一次。
+    // 超时、响应格式错误等其他错误说明请求已到达节点，直接返回，不重复发送
+    bool replayed = false;
+    if (err == ESP_ERR_INVALID_STATE && reused && !opened && sink->length == 0 &&
+        web3_body_is_idempotent(body, body_len)) {
+        ESP_LOGW(TAG, "keep-alive连接已失效 (%s)，在新连接上重发", esp_err_to_name(err));
+        web3_socket_close(sock);
+        web3_sink_reset(sink);
+        replayed = true;
+        err = web3_socket_exchange(sock, body, body_len, sink, &opened, &status);
+    }
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "HTTP POST 请求发送失败: %s", esp_err_to_name(err));
+        web3_socket_close(sock);
+        return err;
+    }
+    sock->last_activity_ms = web3_socket_now_ms();
+    web3_record_connection(opened, idle_reconnect, replayed);
+
+    if (status != 200) {
+        ESP_LOGE(TAG, "HTTP 状态异常 %d", status);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+static int64_t web3_socket_idle_ms(web3_transport_t* transport) {
+    web3_socket_transport_t* sock = (web3_socket_transport_t*)transport;
+    return sock->fd >= 0 ? web3_socket_now_ms() - sock->last_activity_ms : -1;
+}
+
+static void web3_socket_destroy(web3_transport_t* transport) {
+    web3_socket_transport_t* sock = (web3_socket_transport_t*)transport;
+    web3_socket_close(sock);
+    free(sock->request_head);
+    free(sock);
+}
+
+static const web3_transport_ops_t WEB3_SOCKET_OPS = {
+    .name = "socket",
+    .perform = web3_socket_perform,
+    .idle_ms = web3_socket_idle_ms,
+    .destroy = web3_socket_destroy,
+};
+
+esp_err_t web3_transport_socket_create(const char* url, web3_transport_t** transport) {
+    if (!url || !transport) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (strncmp(url, "https://", 8) == 0) {
+        ESP_LOGE(TAG, "TLS is not supported by the socket transport");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (strncmp(url, "http://", 7) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // http://主机[:端口][/路径]
+    const char* host = url + 7;
+    size_t host_len = strcspn(host, ":/");
+    if (host_len == 0 || host_len >= sizeof(((web3_socket_transport_t*)0)->host)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const char* port = "80";
+    size_t port_len = 2;
+    const char* path = host + host_len;
+    if (*path == ':') {
+        port = path + 1;
+        port_len = strcspn(port, "/");
+        path = port + port_len;
+        if (port_len == 0 || port_len >= sizeof(((web3_socket_transport_t*)0)->port)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    if (*path == '\0') {
+        path = "/";
+    }
+
+    web3_socket_transport_t* sock = calloc(1, sizeof(*sock));
+    if (!sock) {
+        return ESP_ERR_NO_MEM;
+    }
+    sock->base.ops = &WEB3_SOCKET_OPS;
+    sock->fd = -1;
+    memcpy(sock->host, host, host_len);
+    memcpy(sock->port, port, port_len);
+
+    // 请求行和固定请求头每个请求都相同，只生成一次
+    static const char head_format[] =
+        "POST %s HTTP/1.1\r\nHost: %s:%s\r\nContent-Type: application/json\r\nContent-Length: ";
+    int head_len = snprintf(NULL, 0, head_format, path, sock->host, sock->port);
+    sock->request_head = malloc((size_t)head_len + 1);
+    if (!sock->request_head) {
+        free(sock);
+        return ESP_ERR_NO_MEM;
+    }
+    snprintf(sock->request_head, (size_t)head_len + 1, head_format, path, sock->host, sock->port);
+    sock->request_head_len = (size_t)head_len;
+
+    *transport = &sock->base;
+    return ESP_OK;
+}
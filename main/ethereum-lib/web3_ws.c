@@ -0,0 +1,513 @@
+#include "web3_transport.h"
+#include "eth_json.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <esp_log.h>
+#include <esp_websocket_client.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+static const char *TAG = "WEB3_WS";
+
+// 建立连接的等待时间和单个请求等待响应的时间
+#ifndef WEB3_WS_TIMEOUT_MS
+#define WEB3_WS_TIMEOUT_MS WEB3_HTTP_TIMEOUT_MS
+#endif
+
+// esp_websocket_client的接收缓冲区，更长的消息分多次DATA事件到达，在frame中重组
+#define WEB3_WS_RX_BUFFER 2048
+
+#define WS_OP_CONTINUATION 0x00
+#define WS_OP_TEXT         0x01
+
+typedef struct {
+    bool active;                           // 已收到订阅ID，通知按ID分发
+    bool pending;                          // 已占用，等待eth_subscribe的响应
+    char id[WEB3_SUBSCRIPTION_ID_LEN];
+    web3_subscription_handler_t handler;
+    void* user_ctx;
+} web3_ws_subscription_t;
+
+/*
+    同一连接上同时只有一个请求在等待响应，响应与订阅通知都在
+    esp_websocket_client的接收任务中处理。响应按JSON-RPC id与等待中的请求匹配，
+    超时请求迟到的响应不会写进下一个请求的sink。
+*/
+struct web3_ws {
+    web3_transport_t base;
+    esp_websocket_client_handle_t client;
+    SemaphoreHandle_t request_lock;        // 同一时间只有一个请求在等待响应
+    SemaphoreHandle_t state_lock;          // 保护pending和订阅表 (接收任务与请求任务共用)
+    SemaphoreHandle_t callback_lock;       // 从查找回调到回调返回期间持有，注销订阅时据此等待回调结束
+    SemaphoreHandle_t response_ready;      // 接收任务收到响应后释放
+    SemaphoreHandle_t connected;           // 首次连接成功后释放
+    web3_response_sink_t* pending;         // 当前请求的响应sink
+    uint64_t pending_first_id;             // 当前请求的id (批量请求为id范围)
+    uint64_t pending_last_id;
+    web3_ws_subscription_t* pending_subscription;  // 当前请求为eth_subscribe时登记的槽位
+    web3_response_sink_t frame;            // 分片消息的重组缓冲区，在连接内复用
+    web3_ws_subscription_t subscriptions[WEB3_WS_MAX_SUBSCRIPTIONS];
+};
+
+bool web3_ws_is_url(const char* url) {
+    return url && (strncmp(url, "ws://", 5) == 0 || strncmp(url, "wss://", 6) == 0);
+}
+
+// 订阅通知: {"jsonrpc":"2.0","method":"eth_subscription","params":{"subscription":"0x..","result":{...}}}
+static void web3_ws_dispatch_notification(struct web3_ws* ws, const eth_json_token_t* params) {
+    eth_json_token_t id, result;
+    if (eth_json_object_get(params, "subscription", &id) != ESP_OK || id.type != ETH_JSON_STRING ||
+        eth_json_object_get(params, "result", &result) != ESP_OK) {
+        ESP_LOGW(TAG, "Malformed subscription notification");
+        return;
+    }
+
+    // 查找与回调在同一段callback_lock内，web3_unsubscribe清除槽位后等待这段结束，
+    // 返回后回调不会再用到旧的user_ctx
+    web3_subscription_handler_t handler = NULL;
+    void* user_ctx = NULL;
+    xSemaphoreTake(ws->callback_lock, portMAX_DELAY);
+    xSemaphoreTake(ws->state_lock, portMAX_DELAY);
+    for (size_t i = 0; i < WEB3_WS_MAX_SUBSCRIPTIONS; i++) {
+        if (ws->subscriptions[i].active && eth_json_token_equals(&id, ws->subscriptions[i].id)) {
+            handler = ws->subscriptions[i].handler;
+            user_ctx = ws->subscriptions[i].user_ctx;
+            break;
+        }
+    }
+    xSemaphoreGive(ws->state_lock);
+
+    if (!handler) {
+        xSemaphoreGive(ws->callback_lock);
+        ESP_LOGD(TAG, "Notification for unknown subscription %.*s", (int)id.len, id.start);
+        return;
+    }
+    // result指向重组缓冲区，回调可以原地修改
+    handler(user_ctx, (char*)result.start, result.len);
+    xSemaphoreGive(ws->callback_lock);
+}
+
+// 消息中JSON-RPC id的范围: 单个对象取其id，批量数组取所有元素id的最小值和最大值
+static bool web3_ws_message_ids(const char* msg, size_t len, uint64_t* first, uint64_t* last) {
+    eth_json_token_t root, element, id;
+    uint64_t value;
+    if (eth_json_parse(msg, len, &root) != ESP_OK) {
+        return false;
+    }
+    if (root.type == ETH_JSON_OBJECT) {
+        if (eth_json_object_get(&root, "id", &id) != ESP_OK || eth_json_token_to_uint64(&id, &value) != ESP_OK) {
+            return false;
+        }
+        *first = *last = value;
+        return true;
+    }
+    if (root.type != ETH_JSON_ARRAY) {
+        return false;
+    }
+
+    bool found = false;
+    const char* cursor = NULL;
+    while (eth_json_array_next(&root, &cursor, &element) == ESP_OK) {
+        if (element.type != ETH_JSON_OBJECT || eth_json_object_get(&element, "id", &id) != ESP_OK ||
+            eth_json_token_to_uint64(&id, &value) != ESP_OK) {
+            return false;
+        }
+        if (!found || value < *first) {
+            *first = value;
+        }
+        if (!found || value > *last) {
+            *last = value;
+        }
+        found = true;
+    }
+    return found;
+}
+
+// 请求的响应: id匹配时写入等待中的sink；eth_subscribe的响应同时登记订阅ID
+static void web3_ws_dispatch_response(struct web3_ws* ws, const char* msg, size_t len) {
+    uint64_t first = 0, last = 0;
+    if (!web3_ws_message_ids(msg, len, &first, &last)) {
+        ESP_LOGW(TAG, "Response without numeric id dropped (%d bytes)", (int)len);
+        return;
+    }
+
+    xSemaphoreTake(ws->state_lock, portMAX_DELAY);
+    web3_response_sink_t* sink = ws->pending;
+    if (!sink || first < ws->pending_first_id || last > ws->pending_last_id) {
+        xSemaphoreGive(ws->state_lock);
+        // 之前超时的请求迟到的响应
+        ESP_LOGW(TAG, "Response id %llu does not match a pending request, dropped", (unsigned long long)first);
+        return;
+    }
+
+    web3_sink_write(sink, msg, len);
+
+    web3_ws_subscription_t* sub = ws->pending_subscription;
+    eth_rpc_response_t resp;
+    if (sub && eth_json_parse_response(msg, len, &resp) == ESP_OK && resp.result.type == ETH_JSON_STRING &&
+        eth_json_token_copy_string(&resp.result, sub->id, sizeof(sub->id)) == ESP_OK) {
+        sub->active = true;
+    }
+
+    ws->pending = NULL;
+    ws->pending_subscription = NULL;
+    xSemaphoreGive(ws->state_lock);
+    xSemaphoreGive(ws->response_ready);
+}
+
+static void web3_ws_dispatch(struct web3_ws* ws, char* msg, size_t len) {
+    eth_json_token_t root, method, params;
+    if (eth_json_parse(msg, len, &root) != ESP_OK) {
+        ESP_LOGW(TAG, "Malformed message dropped (%d bytes)", (int)len);
+        return;
+    }
+
+    if (root.type == ETH_JSON_OBJECT && eth_json_object_get(&root, "method", &method) == ESP_OK &&
+        eth_json_token_equals(&method, "eth_subscription")) {
+        if (eth_json_object_get(&root, "params", &params) == ESP_OK && params.type == ETH_JSON_OBJECT) {
+            web3_ws_dispatch_notification(ws, &params);
+        }
+        return;
+    }
+
+    // 单个响应对象或批量响应数组
+    web3_ws_dispatch_response(ws, msg, len);
+}
+
+// 连接断开时节点上的订阅随之失效，等待中的请求立即失败
+static void web3_ws_on_disconnected(struct web3_ws* ws) {
+    xSemaphoreTake(ws->state_lock, portMAX_DELAY);
+    for (size_t i = 0; i < WEB3_WS_MAX_SUBSCRIPTIONS; i++) {
+        if (ws->subscriptions[i].active) {
+            ESP_LOGW(TAG, "Subscription %s lost with the connection", ws->subscriptions[i].id);
+        }
+    }
+    memset(ws->subscriptions, 0, sizeof(ws->subscriptions));
+
+    web3_response_sink_t* sink = ws->pending;
+    if (sink && sink->err == ESP_OK) {
+        sink->err = ESP_ERR_INVALID_STATE;
+    }
+    ws->pending = NULL;
+    ws->pending_subscription = NULL;
+    xSemaphoreGive(ws->state_lock);
+
+    if (sink) {
+        xSemaphoreGive(ws->response_ready);
+    }
+}
+
+static void web3_ws_event_handler(void* handler_args, esp_event_base_t base, int32_t event_id, void* event_data) {
+    struct web3_ws* ws = (struct web3_ws*)handler_args;
+    esp_websocket_event_data_t* data = (esp_websocket_event_data_t*)event_data;
+
+    switch (event_id) {
+        case WEBSOCKET_EVENT_CONNECTED:
+            ESP_LOGI(TAG, "WebSocket connected");
+            xSemaphoreGive(ws->connected);
+            break;
+
+        case WEBSOCKET_EVENT_DISCONNECTED:
+        case WEBSOCKET_EVENT_CLOSED:
+            ESP_LOGW(TAG, "WebSocket disconnected");
+            web3_sink_reset(&ws->frame);
+            web3_ws_on_disconnected(ws);
+            break;
+
+        case WEBSOCKET_EVENT_DATA:
+            // 只处理文本帧及其后续分片，ping/pong/close由客户端自己处理
+            if (data->op_code != WS_OP_TEXT && data->op_code != WS_OP_CONTINUATION) {
+                break;
+            }
+            if (data->op_code == WS_OP_TEXT && data->payload_offset == 0) {
+                web3_sink_reset(&ws->frame);
+            }
+            if (data->data_len > 0) {
+                web3_sink_write(&ws->frame, data->data_ptr, data->data_len);
+            }
+
+            // 帧内最后一段且为消息的最后一帧时整条消息到齐
+            if (data->payload_offset + data->data_len >= data->payload_len && data->fin) {
+                if (ws->frame.err != ESP_OK) {
+                    ESP_LOGE(TAG, "Message dropped: %s", esp_err_to_name(ws->frame.err));
+                } else if (ws->frame.length > 0) {
+                    web3_ws_dispatch(ws, ws->frame.buffer, ws->frame.length);
+                }
+                web3_sink_reset(&ws->frame);
+            }
+            break;
+
+        case WEBSOCKET_EVENT_ERROR:
+            ESP_LOGE(TAG, "WebSocket error");
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void web3_ws_free(struct web3_ws* ws) {
+    if (ws->client) {
+        esp_websocket_client_destroy(ws->client);
+    }
+    if (ws->request_lock) {
+        vSemaphoreDelete(ws->request_lock);
+    }
+    if (ws->state_lock) {
+        vSemaphoreDelete(ws->state_lock);
+    }
+    if (ws->callback_lock) {
+        vSemaphoreDelete(ws->callback_lock);
+    }
+    if (ws->response_ready) {
+        vSemaphoreDelete(ws->response_ready);
+    }
+    if (ws->connected) {
+        vSemaphoreDelete(ws->connected);
+    }
+    web3_sink_free(&ws->frame);
+    free(ws);
+}
+
+static const web3_transport_ops_t WEB3_WS_OPS;
+
+esp_err_t web3_transport_ws_create(const char* url, web3_transport_t** out) {
+    if (!web3_ws_is_url(url) || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    struct web3_ws* ws = calloc(1, sizeof(*ws));
+    if (!ws) {
+        return ESP_ERR_NO_MEM;
+    }
+    ws->base.ops = &WEB3_WS_OPS;
+    web3_sink_init_growable(&ws->frame, 0);
+    ws->request_lock = xSemaphoreCreateMutex();
+    ws->state_lock = xSemaphoreCreateMutex();
+    ws->callback_lock = xSemaphoreCreateMutex();
+    ws->response_ready = xSemaphoreCreateBinary();
+    ws->connected = xSemaphoreCreateBinary();
+    if (!ws->request_lock || !ws->state_lock || !ws->callback_lock || !ws->response_ready || !ws->connected) {
+        web3_ws_free(ws);
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_websocket_client_config_t config = {
+        .uri = url,
+        .buffer_size = WEB3_WS_RX_BUFFER,
+        .network_timeout_ms = WEB3_WS_TIMEOUT_MS,
+        // 与HTTP传输相同，wss连接跳过证书验证
+        .skip_cert_common_name_check = strncmp(url, "wss://", 6) == 0,
+    };
+    ws->client = esp_websocket_client_init(&config);
+    if (!ws->client) {
+        ESP_LOGE(TAG, "Failed to initialize WebSocket client");
+        web3_ws_free(ws);
+        return ESP_FAIL;
+    }
+    esp_websocket_register_events(ws->client, WEBSOCKET_EVENT_ANY, web3_ws_event_handler, ws);
+
+    esp_err_t err = esp_websocket_client_start(ws->client);
+    if (err == ESP_OK && xSemaphoreTake(ws->connected, pdMS_TO_TICKS(WEB3_WS_TIMEOUT_MS)) != pdTRUE) {
+        err = ESP_ERR_TIMEOUT;
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to connect to %s: %s", url, esp_err_to_name(err));
+        esp_websocket_client_stop(ws->client);
+        web3_ws_free(ws);
+        return err;
+    }
+
+    *out = &ws->base;
+    return ESP_OK;
+}
+
+static esp_err_t web3_ws_request(struct web3_ws* ws, const char* body, size_t body_len,
+                                 web3_response_sink_t* sink, web3_ws_subscription_t* subscription) {
+    uint64_t first_id = 0, last_id = 0;
+    if (!web3_ws_message_ids(body, body_len, &first_id, &last_id)) {
+        ESP_LOGE(TAG, "Request body has no numeric id");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(ws->request_lock, portMAX_DELAY);
+
+    if (!esp_websocket_client_is_connected(ws->client)) {
+        xSemaphoreGive(ws->request_lock);
+        ESP_LOGE(TAG, "WebSocket not connected");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // 清除上一个超时请求留下的信号，再登记本次请求
+    xSemaphoreTake(ws->response_ready, 0);
+    xSemaphoreTake(ws->state_lock, portMAX_DELAY);
+    ws->pending = sink;
+    ws->pending_first_id = first_id;
+    ws->pending_last_id = last_id;
+    ws->pending_subscription = subscription;
+    xSemaphoreGive(ws->state_lock);
+
+    ESP_LOGI(TAG, "发送请求: %.*s", (int)body_len, body);
+    esp_err_t err = ESP_OK;
+    if (esp_websocket_client_send_text(ws->client, body, (int)body_len, pdMS_TO_TICKS(WEB3_WS_TIMEOUT_MS)) < 0) {
+        ESP_LOGE(TAG, "Failed to send request");
+        err = ESP_FAIL;
+    } else if (xSemaphoreTake(ws->response_ready, pdMS_TO_TICKS(WEB3_WS_TIMEOUT_MS)) != pdTRUE) {
+        ESP_LOGE(TAG, "No response within %d ms", WEB3_WS_TIMEOUT_MS);
+        err = ESP_ERR_TIMEOUT;
+    }
+
+    // 失败时撤销登记；之后迟到的响应id与下一个请求不同，在接收任务中丢弃
+    xSemaphoreTake(ws->state_lock, portMAX_DELAY);
+    if (ws->pending == sink) {
+        ws->pending = NULL;
+        ws->pending_subscription = NULL;
+    }
+    xSemaphoreGive(ws->state_lock);
+    xSemaphoreGive(ws->request_lock);
+
+    if (err == ESP_OK && sink->err != ESP_OK) {
+        err = sink->err;
+    }
+    if (err == ESP_OK && sink->length == 0) {
+        err = ESP_FAIL;
+    }
+    return err;
+}
+
+static esp_err_t web3_ws_perform(web3_transport_t* transport, const char* body, size_t body_len,
+                                 web3_response_sink_t* sink) {
+    return web3_ws_request((struct web3_ws*)transport, body, body_len, sink, NULL);
+}
+
+static void web3_ws_destroy(web3_transport_t* transport) {
+    struct web3_ws* ws = (struct web3_ws*)transport;
+    esp_websocket_client_close(ws->client, pdMS_TO_TICKS(1000));
+    web3_ws_free(ws);
+}
+
+static const web3_transport_ops_t WEB3_WS_OPS = {
+    .name = "websocket",
+    .perform = web3_ws_perform,
+    .destroy = web3_ws_destroy,
+};
+
+// 上下文使用WebSocket后端时返回连接，否则返回NULL
+static struct web3_ws* web3_ws_of(web3_context_t* context) {
+    if (!context->transport || context->transport->ops != &WEB3_WS_OPS) {
+        return NULL;
+    }
+    return (struct web3_ws*)context->transport;
+}
+
+esp_err_t web3_subscribe(web3_context_t* context, const char* params, web3_subscription_handler_t handler,
+                         void* user_ctx, char subscription_id[WEB3_SUBSCRIPTION_ID_LEN]) {
+    if (!context || !params || !handler || !subscription_id) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct web3_ws* ws = web3_ws_of(context);
+    if (!ws) {
+        ESP_LOGD(TAG, "eth_subscribe requires a ws:// or wss:// URL");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    // 先占用槽位，订阅ID在接收任务处理响应时写入
+    web3_ws_subscription_t* sub = NULL;
+    xSemaphoreTake(ws->state_lock, portMAX_DELAY);
+    for (size_t i = 0; i < WEB3_WS_MAX_SUBSCRIPTIONS; i++) {
+        if (!ws->subscriptions[i].active && !ws->subscriptions[i].pending) {
+            sub = &ws->subscriptions[i];
+            memset(sub, 0, sizeof(*sub));
+            sub->pending = true;
+            sub->handler = handler;
+            sub->user_ctx = user_ctx;
+            break;
+        }
+    }
+    xSemaphoreGive(ws->state_lock);
+    if (!sub) {
+        ESP_LOGE(TAG, "Too many subscriptions (max %d)", WEB3_WS_MAX_SUBSCRIPTIONS);
+        return ESP_ERR_NO_MEM;
+    }
+
+    char* body = NULL;
+    size_t body_len = 0;
+    char response[256];
+    web3_response_sink_t sink;
+    web3_sink_init_fixed(&sink, response, sizeof(response));
+    esp_err_t err = web3_render_request("eth_subscribe", params, &body, &body_len);
+    if (err == ESP_OK) {
+        err = web3_ws_request(ws, body, body_len, &sink, sub);
+        free(body);
+    }
+
+    xSemaphoreTake(ws->state_lock, portMAX_DELAY);
+    sub->pending = false;
+    if (err == ESP_OK && sub->active) {
+        memcpy(subscription_id, sub->id, WEB3_SUBSCRIPTION_ID_LEN);
+    } else {
+        if (err == ESP_OK) {
+            ESP_LOGE(TAG, "eth_subscribe rejected: %s", response);
+            err = ESP_FAIL;
+        }
+        memset(sub, 0, sizeof(*sub));
+    }
+    xSemaphoreGive(ws->state_lock);
+
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Subscribed %s as %s", params, subscription_id);
+    }
+    return err;
+}
+
+esp_err_t web3_unsubscribe(web3_context_t* context, const char* subscription_id) {
+    if (!context || !subscription_id) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct web3_ws* ws = web3_ws_of(context);
+    if (!ws) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    // 先注销回调，之后到达的通知直接丢弃
+    bool found = false;
+    xSemaphoreTake(ws->state_lock, portMAX_DELAY);
+    for (size_t i = 0; i < WEB3_WS_MAX_SUBSCRIPTIONS; i++) {
+        if (ws->subscriptions[i].active && strcmp(ws->subscriptions[i].id, subscription_id) == 0) {
+            memset(&ws->subscriptions[i], 0, sizeof(ws->subscriptions[i]));
+            found = true;
+            break;
+        }
+    }
+    xSemaphoreGive(ws->state_lock);
+    if (!found) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    // 等待接收任务中可能正在执行的回调返回，之后调用者可以释放user_ctx
+    xSemaphoreTake(ws->callback_lock, portMAX_DELAY);
+    xSemaphoreGive(ws->callback_lock);
+
+    char params[WEB3_SUBSCRIPTION_ID_LEN + 8];
+    snprintf(params, sizeof(params), "[\"%s\"]", subscription_id);
+    char response[128];
+    return web3_send_request(context, "eth_unsubscribe", params, response, sizeof(response));
+}
+
+bool web3_is_subscribed(web3_context_t* context, const char* subscription_id) {
+    struct web3_ws* ws = context && subscription_id ? web3_ws_of(context) : NULL;
+    if (!ws) {
+        return false;
+    }
+
+    bool found = false;
+    xSemaphoreTake(ws->state_lock, portMAX_DELAY);
+    for (size_t i = 0; i < WEB3_WS_MAX_SUBSCRIPTIONS; i++) {
+        if (ws->subscriptions[i].active && strcmp(ws->subscriptions[i].id, subscription_id) == 0) {
+            found = true;
+            break;
+        }
+    }
+    xSemaphoreGive(ws->state_lock);
+    return found;
+}
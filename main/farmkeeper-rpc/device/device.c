@@ -1,7 +1,12 @@
 #include "device.h"
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <esp_log.h>
 #include <esp_random.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
 #include <mbedtls/pk.h>
 #include <mbedtls/ecdsa.h>
 #include <mbedtls/error.h>
@@ -10,6 +15,11 @@
 #include "../ethereum-lib/eth_abi.h"
 #include "../ethereum-lib/eth_rpc.h"
 #include "../ethereum-lib/eth_sign.h"
+#include "../ethereum-lib/eth_tx.h"
+#include "../ethereum-lib/eth_types.h"
+#include "../ethereum-lib/eth_uint256.h"
+#include "../ethereum-lib/web3_transport.h"
+#include "device_challenge_contract.h"
 
 static const char *TAG = "FARMKEEPER_DEVICE";
 
@@ -19,142 +29,58 @@ static bool is_initialized = false;
 
 // 使用静态缓冲区来避免动态内存分配
 static uint8_t s_encoded_buffer[1024];
-static char s_hex_buffer[2048];
 static uint8_t s_binary_result[4096]; // Add this missing buffer declaration
-static char s_result_buffer[1024]; // 减小不必要的缓冲区大小
+static uint8_t s_raw_tx[1024];      // 本地签名后的原始交易
+static eth_signer_t s_signer;       // 设备私钥只在初始化时解析一次
 
-// RPC 请求构造器 用来检查设备是否有挑战
-static esp_err_t encode_has_challenge_call(uint8_t *output, size_t output_len, size_t *bytes_written) {
-    if (!output || !bytes_written) {
-        return ESP_ERR_INVALID_ARG;
-    }
-    
-    // Device ID 参数
-    uint8_t device_id_bytes[32] = {0}; 
-    uint32_t device_id = device_config.device_id;
-    
-    // Convert device_id to big-endian and store in the last 4 bytes
-    device_id_bytes[28] = (device_id >> 24) & 0xFF;
-    device_id_bytes[29] = (device_id >> 16) & 0xFF;
-    device_id_bytes[30] = (device_id >> 8) & 0xFF;
-    device_id_bytes[31] = device_id & 0xFF;
-    
-    // Define the parameter
-    abi_param_t param = ABI_UINT(256, device_id_bytes);
-    
-    return abi_encode_function_call(
-        device_config.web3_ctx,
-        "hasChallenge(uint256)",
-        &param, 
-        1, 
-        output, 
-        output_len, 
-        bytes_written
-    );
-}
+// 合约地址和设备地址在初始化时解析为二进制，只在JSON-RPC线路上转换为十六进制
+static eth_address_t s_contract_address;
+static eth_address_t s_device_address;
 
-// 该函数会构造GetDeviceChallenge函数的ABI编码数据
-static esp_err_t encode_get_challenge_call(uint8_t *output, size_t output_len, size_t *bytes_written) {
-    if (!output || !bytes_written) {
-        return ESP_ERR_INVALID_ARG;
-    }
-    
-    // Device ID parameter
-    uint8_t device_id_bytes[32] = {0};
-    uint32_t device_id = device_config.device_id;
-    
-    // Convert device_id to big-endian and store in the last 4 bytes
-    device_id_bytes[28] = (device_id >> 24) & 0xFF;
-    device_id_bytes[29] = (device_id >> 16) & 0xFF;
-    device_id_bytes[30] = (device_id >> 8) & 0xFF;
-    device_id_bytes[31] = device_id & 0xFF;
-    
-    // Define the parameter
-    abi_param_t param = ABI_UINT(256, device_id_bytes);
-    
-    // Encode the function call
-    return abi_encode_function_call(
-        device_config.web3_ctx,
-        "getDeviceChallenge(uint256)",
-        &param, 
-        1, 
-        output, 
-        output_len, 
-        bytes_written
-    );
-}
+// 合约调用数据由 abi/DeviceChallenge.json 生成的绑定编码，设备ID在初始化时转换一次
+static uint256_t s_device_id;
 
-// Original function - add a renamed version to keep it available but not active
-static esp_err_t encode_verify_challenge_call_original(uint8_t *message_hash, uint8_t *r, uint8_t *s, uint8_t v,
-                                            uint8_t *output, size_t output_len, size_t *bytes_written) {
-    // Keep the original implementation
-    return ESP_ERR_NOT_SUPPORTED; // Not using this anymore
-}
+// 轮询用的只读调用参数固定，请求体在初始化时生成一次，之后每次轮询直接发送
+static eth_call_plan_t s_has_challenge_plan;
+static eth_call_plan_t s_get_challenge_plan;
 
-// New simplified version that matches our actual usage in farmkeeper_device_verify_challenge
-static esp_err_t encode_verify_challenge_call(uint8_t *signature, size_t signature_len, 
-                                             uint8_t *output, size_t output_len, size_t *bytes_written) {
-    if (!signature || !output || !bytes_written || signature_len != 65) {
-        return ESP_ERR_INVALID_ARG;
-    }
-    
-    // Device ID parameter
-    uint8_t device_id_bytes[32] = {0};
-    uint32_t device_id = device_config.device_id;
-    
-    // Convert device_id to big-endian and store in the last 4 bytes
-    device_id_bytes[28] = (device_id >> 24) & 0xFF;
-    device_id_bytes[29] = (device_id >> 16) & 0xFF;
-    device_id_bytes[30] = (device_id >> 8) & 0xFF;
-    device_id_bytes[31] = device_id & 0xFF;
-    
-    // Define the parameters - we're now using the 2-parameter version (deviceId, bytes signature)
-    abi_param_t params[2] = {
-        ABI_UINT(256, device_id_bytes),   // Device ID as uint256
-        ABI_BYTES(signature, signature_len)  // Full signature as bytes
-    };
-    
-    // Encode the function call with the EXACT function signature from the smart contract
-    return abi_encode_function_call(
-        device_config.web3_ctx,
-        "verifyDeviceChallenge(uint256,bytes)",
-        params,
-        2,
-        output,
-        output_len,
-        bytes_written
-    );
-}
+// 挑战事件监听: 优先使用节点上的过滤器，节点不支持时按区块范围查询日志
+static const eth_hash_t s_challenge_topic = DEVICE_CHALLENGE_DEVICE_CHALLENGE_CREATED_TOPIC;
+static eth_hash_t s_device_topic;                  // indexed的deviceId (32字节大端序)
+typedef enum {
+    WATCH_LOGS,          // 轮询eth_blockNumber + eth_getLogs
+    WATCH_FILTER,        // 轮询eth_getFilterChanges
+    WATCH_SUBSCRIPTION,  // WebSocket推送 (eth_subscribe "logs")
+} watch_mode_t;
 
-// Function to encode the resetDeviceChallenge function call data
-static esp_err_t encode_reset_challenge_call(uint8_t *output, size_t output_len, size_t *bytes_written) {
-    if (!output || !bytes_written) {
-        return ESP_ERR_INVALID_ARG;
+static bool s_watch_active = false;
+static watch_mode_t s_watch_mode = WATCH_LOGS;
+static char s_watch_filter_id[ETH_FILTER_ID_LEN];
+static char s_watch_subscription_id[WEB3_SUBSCRIPTION_ID_LEN];
+static SemaphoreHandle_t s_watch_signal;           // 订阅回调收到事件时释放
+static uint64_t s_watch_next_block;                // eth_getLogs模式下一次查询的起始区块
+
+// 编码调用数据并生成调用计划
+static esp_err_t build_call_plans(void) {
+    size_t encoded_len = 0;
+    esp_err_t err = device_challenge_encode_has_challenge(&s_device_id, s_encoded_buffer,
+                                                          sizeof(s_encoded_buffer), &encoded_len);
+    if (err == ESP_OK) {
+        err = eth_call_plan_init(&s_has_challenge_plan, s_contract_address, s_encoded_buffer, encoded_len);
+    }
+    if (err != ESP_OK) {
+        return err;
     }
     
-    // Device ID parameter
-    uint8_t device_id_bytes[32] = {0};
-    uint32_t device_id = device_config.device_id;
-    
-    // Convert device_id to big-endian and store in the last 4 bytes
-    device_id_bytes[28] = (device_id >> 24) & 0xFF;
-    device_id_bytes[29] = (device_id >> 16) & 0xFF;
-    device_id_bytes[30] = (device_id >> 8) & 0xFF;
-    device_id_bytes[31] = device_id & 0xFF;
-    
-    // Define the parameter
-    abi_param_t param = ABI_UINT(256, device_id_bytes);
-    
-    // Encode the function call
-    return abi_encode_function_call(
-        device_config.web3_ctx,
-        "resetDeviceChallenge(uint256)",
-        &param, 
-        1, 
-        output, 
-        output_len, 
-        bytes_written
-    );
+    err = device_challenge_encode_get_device_challenge(&s_device_id, s_encoded_buffer,
+                                                       sizeof(s_encoded_buffer), &encoded_len);
+    if (err == ESP_OK) {
+        err = eth_call_plan_init(&s_get_challenge_plan, s_contract_address, s_encoded_buffer, encoded_len);
+    }
+    if (err != ESP_OK) {
+        eth_call_plan_free(&s_has_challenge_plan);
+    }
+    return err;
 }
 
 /*
@@ -167,9 +93,49 @@ esp_err_t farmkeeper_device_init(const farmkeeper_device_config_t *config) {
         return ESP_ERR_INVALID_ARG;
     }
     
+    // 重复初始化时先用旧配置卸载事件过滤器
+    farmkeeper_device_watch_stop();
+    
     // 数据拷贝到静态配置结构体
     memcpy(&device_config, config, sizeof(farmkeeper_device_config_t));
     
+    if (eth_address_from_hex(config->contract_address, s_contract_address) != ESP_OK) {
+        ESP_LOGE(TAG, "合约地址无效: %s", config->contract_address);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (eth_address_from_hex(config->device_address, s_device_address) != ESP_OK) {
+        ESP_LOGE(TAG, "设备地址无效: %s", config->device_address);
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    // 解析设备私钥并建立签名上下文，之后每次签名直接复用
+    if (s_signer.initialized) {
+        eth_signer_free(&s_signer);
+    }
+    esp_err_t signer_err = eth_signer_init(&s_signer, config->device_private_key);
+    if (signer_err != ESP_OK) {
+        ESP_LOGE(TAG, "设备私钥无效: %s", esp_err_to_name(signer_err));
+        return signer_err;
+    }
+    
+    if (memcmp(s_signer.address, s_device_address, ETH_ADDRESS_LEN) != 0) {
+        char signer_address[ETH_ADDRESS_HEX_LEN];
+        eth_address_to_hex(s_signer.address, signer_address);
+        ESP_LOGW(TAG, "私钥对应地址 %s 与配置的设备地址不一致", signer_address);
+    }
+    
+    uint256_set_u64(&s_device_id, config->device_id);
+    uint256_to_be_bytes(&s_device_id, s_device_topic);
+    
+    // 重复初始化时先释放旧的调用计划
+    eth_call_plan_free(&s_has_challenge_plan);
+    eth_call_plan_free(&s_get_challenge_plan);
+    esp_err_t plan_err = build_call_plans();
+    if (plan_err != ESP_OK) {
+        ESP_LOGE(TAG, "生成调用计划失败: %s", esp_err_to_name(plan_err));
+        return plan_err;
+    }
+    
     // 标记为已初始化
     is_initialized = true;
     
@@ -189,91 +155,24 @@ esp_err_t farmkeeper_device_has_challenge(bool *has_challenge) {
     
     *has_challenge = false;
     
-    size_t encoded_len = 0;
-    // 将编码缓冲区前256清零
-    memset(s_encoded_buffer, 0, 256);  
-    
-    esp_err_t err = encode_has_challenge_call(s_encoded_buffer, 256, &encoded_len);
+    // Call the contract - 发送预生成的请求体，返回值直接解码为二进制
+    // 失效的keep-alive连接由web3层在新连接上重发，这里不再重试
+    size_t result_len = 0;
+    esp_err_t err = eth_call_plan_execute(device_config.web3_ctx, &s_has_challenge_plan,
+                                          s_binary_result, sizeof(s_binary_result), &result_len);
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to encode hasChallenge call: %s", esp_err_to_name(err));
+        ESP_LOGE(TAG, "eth_call failed: %s", esp_err_to_name(err));
         return err;
     }
+    ESP_LOGD(TAG, "Contract response: %d bytes", (int)result_len);
     
-    // Convert to hex for eth_call - using static buffer
-    memset(s_hex_buffer, 0, 512);  // Only use what we need
-    err = abi_binary_to_hex(s_encoded_buffer, encoded_len, s_hex_buffer, 512);
+    err = device_challenge_decode_has_challenge(s_binary_result, result_len, has_challenge);
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to convert binary to hex: %s", esp_err_to_name(err));
+        ESP_LOGE(TAG, "Failed to decode hasChallenge result: %s", esp_err_to_name(err));
         return err;
     }
-    
-    // Add error recovery - try up to 3 times
-    int retry_count = 0;
-    const int MAX_RETRIES = 3;
-    
-    while (retry_count < MAX_RETRIES) {
-        // Call the contract - using static buffer
-        memset(s_result_buffer, 0, 256);  // Only use what we need
-        err = eth_call(device_config.web3_ctx, device_config.contract_address, s_hex_buffer, "latest", s_result_buffer, 256);
-        
-        if (err == ESP_OK) {
-            ESP_LOGI(TAG, "Contract response: %s", s_result_buffer);
-            
-            // Try both standard response and simple boolean response formats
-            
-            // Simple bool response: "0x0000...0001" (true) or "0x0000...0000" (false)
-            if (strlen(s_result_buffer) >= 66) { // Full 32-byte response ("0x" + 64 chars)
-                // Check if any non-zero byte exists in the result
-                for (int i = 2; i < 66; i++) {
-                    if (s_result_buffer[i] != '0') {
-                        *has_challenge = true;
-                        ESP_LOGI(TAG, "Device has challenge: YES (non-zero value in result)");
-                        return ESP_OK;
-                    }
-                }
-                
-                // All zeros means false
-                *has_challenge = false;
-                ESP_LOGI(TAG, "Device has challenge: NO (all zeros in result)");
-                return ESP_OK;
-            }
-            // Compressed response: "0x01" (true) or "0x00" or "0x" (false)
-            else if (strcmp(s_result_buffer, "0x01") == 0 || 
-                    strcmp(s_result_buffer, "0x1") == 0) {
-                *has_challenge = true;
-                ESP_LOGI(TAG, "Device has challenge: YES (compact true response)");
-                return ESP_OK;
-            }
-            else if (strcmp(s_result_buffer, "0x00") == 0 || 
-                     strcmp(s_result_buffer, "0x0") == 0 ||
-                     strcmp(s_result_buffer, "0x") == 0) {
-                *has_challenge = false;
-                ESP_LOGI(TAG, "Device has challenge: NO (compact false response)");
-                return ESP_OK;
-            }
-            // Try to handle the specific case for this contract
-            else if (strlen(s_result_buffer) > 2) {
-                // String value - assuming any non-empty, non-zero response means true
-                *has_challenge = true;
-                ESP_LOGI(TAG, "Device has challenge: YES (non-empty string response)");
-                return ESP_OK;
-            }
-            else {
-                // Default assumption - no response means no challenge
-                *has_challenge = false;
-                ESP_LOGI(TAG, "Device has challenge: NO (unrecognized format, defaulting to false)");
-                return ESP_OK;
-            }
-        } else {
-            ESP_LOGE(TAG, "eth_call failed: %s", esp_err_to_name(err));
-            retry_count++;
-            vTaskDelay(pdMS_TO_TICKS(1000)); // Wait 1 second before retry
-            continue;
-        }
-    }
-    
-    ESP_LOGE(TAG, "Failed to check for challenge after %d retries", MAX_RETRIES);
-    return ESP_FAIL;
+    ESP_LOGI(TAG, "Device has challenge: %s", *has_challenge ? "YES" : "NO");
+    return ESP_OK;
 }
 
 // 获取挑战内容
@@ -285,76 +184,68 @@ esp_err_t farmkeeper_device_get_challenge(char *challenge, size_t challenge_len)
     // 清空挑战缓存内容
     memset(challenge, 0, challenge_len);
     
-    // Encode the function call data - using static buffer
-    size_t encoded_len = 0;
-    memset(s_encoded_buffer, 0, sizeof(s_encoded_buffer));
-    
-    // 构造 GetDeviceChallenge 函数 ABI编码数据
-    esp_err_t err = encode_get_challenge_call(s_encoded_buffer, sizeof(s_encoded_buffer), &encoded_len);
+    // 调用合约，请求体在初始化时已生成，返回数据在接收时直接解码到二进制缓冲区
+    size_t binary_len = 0;
+    esp_err_t err = eth_call_plan_execute(device_config.web3_ctx, &s_get_challenge_plan,
+                                          s_binary_result, sizeof(s_binary_result), &binary_len);
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to encode getDeviceChallenge call: %s", esp_err_to_name(err));
+        ESP_LOGE(TAG, "eth_call failed: %s", esp_err_to_name(err));
         return err;
     }
     
-    // 将挑战编码结果转换为十六进制字符串 - 便于进行 eth_call
-    memset(s_hex_buffer, 0, sizeof(s_hex_buffer));
-    err = abi_binary_to_hex(s_encoded_buffer, encoded_len, s_hex_buffer, sizeof(s_hex_buffer));
+    ESP_LOGI(TAG, "GetChallengeDeviceData调用成功，长度: %d", (int)binary_len);
+    
+    // 解码返回的字符串，得到指向结果缓冲区的视图，不分配内存
+    const char *challenge_str = NULL;
+    size_t str_len = 0;
+    err = device_challenge_decode_get_device_challenge(s_binary_result, binary_len, &challenge_str, &str_len);
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to convert binary to hex: %s", esp_err_to_name(err));
+        ESP_LOGE(TAG, "Failed to decode string return value: %s", esp_err_to_name(err));
         return err;
     }
     
-    // Call the contract - using static buffer
-    memset(s_result_buffer, 0, sizeof(s_result_buffer));
-    err = eth_call(device_config.web3_ctx, device_config.contract_address, s_hex_buffer, "latest", s_result_buffer, sizeof(s_result_buffer));
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "eth_call failed: %s", esp_err_to_name(err));
-        return err;
+    // Copy the decoded string to the output buffer
+    if (str_len >= challenge_len) {
+        ESP_LOGW(TAG, "Challenge string truncated");
+        str_len = challenge_len - 1;
     }
+    memcpy(challenge, challenge_str, str_len);
+    challenge[str_len] = '\0';
     
-    // Parse the result - should be an ABI-encoded string
-    ESP_LOGI(TAG, "GetChallengeDeviceData调用成功，长度: %d", strlen(s_result_buffer));
+    ESP_LOGI(TAG, "Retrieved challenge: %s", challenge);
     
-    // Convert hex to binary - using static buffer
-    memset(s_binary_result, 0, sizeof(s_binary_result));
-    size_t binary_len = 0;
+    return ESP_OK;
+}
+
+// 本地签名交易并通过eth_sendRawTransaction发送，不再需要节点的eth_signTransaction
+static esp_err_t sign_and_send_transaction(const uint8_t *data, size_t data_len,
+                                           uint64_t gas_limit, uint64_t gas_price, uint64_t nonce,
+                                           eth_hash_t tx_hash) {
+    eth_legacy_tx_t tx = {
+        .nonce = nonce,
+        .gas_price = gas_price,
+        .gas_limit = gas_limit,
+        .to = s_contract_address,
+        .value = NULL, // No ETH value
+        .value_len = 0,
+        .data = data,
+        .data_len = data_len,
+        .chain_id = device_config.chain_id,
+    };
     
-    err = abi_hex_to_binary(s_result_buffer, s_binary_result, sizeof(s_binary_result), &binary_len);
+    size_t raw_len = 0;
+    esp_err_t err = eth_tx_sign_legacy_with_signer(&tx, &s_signer, s_raw_tx, sizeof(s_raw_tx), &raw_len);
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to convert hex to binary: %s", esp_err_to_name(err));
+        ESP_LOGE(TAG, "Failed to sign transaction: %s", esp_err_to_name(err));
         return err;
     }
     
-    // 对返回的字符串进行解码
-    abi_decoded_value_t decoded_value = {0};
-    size_t decoded_count = 0;
-    
-    err = abi_decode_returns(s_binary_result, binary_len, &decoded_value, 1, &decoded_count);
-    if (err != ESP_OK || decoded_count != 1) {
-        ESP_LOGE(TAG, "Failed to decode string return value: %s", esp_err_to_name(err));
-        return (err != ESP_OK) ? err : ESP_FAIL;
-    }
-    
-    // Copy the decoded string to the output buffer
-    if (decoded_value.value.string) {
-        size_t str_len = strlen(decoded_value.value.string);
-        if (str_len < challenge_len) {
-            strcpy(challenge, decoded_value.value.string);
-        } else {
-            ESP_LOGW(TAG, "Challenge string truncated");
-            strncpy(challenge, decoded_value.value.string, challenge_len - 1);
-            challenge[challenge_len - 1] = '\0';
-        }
-        
-        // Free the decoded string
-        abi_free_decoded_value(&decoded_value);
-    } else {
-        ESP_LOGE(TAG, "Decoded string is NULL");
-        return ESP_FAIL;
+    err = eth_rpc_send_raw_transaction(device_config.web3_ctx, s_raw_tx, raw_len, tx_hash);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to send transaction: %s", esp_err_to_name(err));
+        return err;
     }
     
-    ESP_LOGI(TAG, "Retrieved challenge: %s", challenge);
-    
     return ESP_OK;
 }
 
@@ -370,74 +261,43 @@ esp_err_t farmkeeper_device_reset_challenge_flag(void) {
     size_t encoded_len = 0;
     memset(s_encoded_buffer, 0, sizeof(s_encoded_buffer));
     
-    esp_err_t err = encode_reset_challenge_call(s_encoded_buffer, sizeof(s_encoded_buffer), &encoded_len);
+    esp_err_t err = device_challenge_encode_reset_device_challenge(&s_device_id, s_encoded_buffer,
+                                                                   sizeof(s_encoded_buffer), &encoded_len);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to encode resetDeviceChallenge call: %s", esp_err_to_name(err));
         return err;
     }
     
-    // Convert to hex for transaction
-    memset(s_hex_buffer, 0, sizeof(s_hex_buffer));
-    err = abi_binary_to_hex(s_encoded_buffer, encoded_len, s_hex_buffer, sizeof(s_hex_buffer));
+    // Get nonce and gas price for the transaction in one batched round trip
+    uint64_t nonce = 0;
+    uint256_t price;
+    err = eth_rpc_get_nonce_and_gas_price(device_config.web3_ctx, s_device_address, &nonce, &price);
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to convert binary to hex: %s", esp_err_to_name(err));
+        ESP_LOGE(TAG, "Failed to get nonce and gas price: %s", esp_err_to_name(err));
         return err;
     }
-
-    // Get nonce for the transaction
-    const char* from_address = device_config.device_address;
-    char nonce[32] = {0};
-    err = eth_getTransactionCount(device_config.web3_ctx, from_address, nonce, sizeof(nonce));
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to get nonce: %s", esp_err_to_name(err));
-        return err;
-    }
-    
-    // Get gas price
-    char gas_price[64] = {0};
-    err = get_eth_gasPrice(device_config.web3_ctx, gas_price, sizeof(gas_price));
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to get gas price: %s", esp_err_to_name(err));
-        strcpy(gas_price, "0x1000000000"); // Fallback price
-    }
-    
-    // Increase gas price by 30% to ensure transaction goes through
-    char *endptr;
-    unsigned long long parsed_price = strtoull(gas_price + 2, &endptr, 16);
-    parsed_price = parsed_price * 13 / 10; // Increase by 30%
-    snprintf(gas_price, sizeof(gas_price), "0x%llx", parsed_price);
-    
-    ESP_LOGI(TAG, "Using gas price: %s", gas_price);
-    
-    // Sign the transaction
-    char signed_tx[1024] = {0};
-    err = eth_signTransaction(
-        device_config.web3_ctx,
-        from_address,
-        device_config.contract_address,
-        "0x500000", // Gas limit
-        gas_price,
-        "0x0", // No ETH value
-        s_hex_buffer,
-        nonce,
-        signed_tx,
-        sizeof(signed_tx)
-    );
     
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to sign transaction: %s", esp_err_to_name(err));
-        return err;
+    // Increase gas price by 30% to ensure transaction goes through (exact 256-bit math)
+    uint64_t parsed_price = 0;
+    bool overflow = uint256_mul_u64(&price, 13, &price);
+    uint256_divmod_u32(&price, 10, &price, NULL);
+    if (overflow || !uint256_to_u64(&price, &parsed_price)) {
+        ESP_LOGE(TAG, "Gas price out of range");
+        return ESP_ERR_INVALID_RESPONSE;
     }
     
-    // Send the transaction
-    char tx_hash[128] = {0};
-    err = eth_sendRawTransaction(device_config.web3_ctx, signed_tx, tx_hash, sizeof(tx_hash));
+    ESP_LOGI(TAG, "Using gas price: 0x%llx", (unsigned long long)parsed_price);
+    
+    // Sign locally and send the transaction
+    eth_hash_t tx_hash;
+    err = sign_and_send_transaction(s_encoded_buffer, encoded_len, 0x500000, parsed_price, nonce, tx_hash);
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to send transaction: %s", esp_err_to_name(err));
         return err;
     }
     
-    ESP_LOGI(TAG, "Reset challenge transaction sent, hash: %s", tx_hash);
+    char tx_hash_hex[ETH_HASH_HEX_LEN];
+    eth_hash_to_hex(tx_hash, tx_hash_hex);
+    ESP_LOGI(TAG, "Reset challenge transaction sent, hash: %s", tx_hash_hex);
     
     // Wait for transaction confirmation
     int confirmation_attempts = 0;
@@ -448,16 +308,17 @@ esp_err_t farmkeeper_device_reset_challenge_flag(void) {
         vTaskDelay(pdMS_TO_TICKS(1000)); // Wait 1 second
         confirmation_attempts++;
         
-        char receipt[2048] = {0};
-        err = eth_get_transaction_receipt(device_config.web3_ctx, tx_hash, receipt, sizeof(receipt));
+        eth_receipt_t receipt;
+        err = eth_rpc_get_transaction_receipt(device_config.web3_ctx, tx_hash, &receipt);
         
-        if (err == ESP_OK) {
+        if (err == ESP_OK && receipt.found) {
             // Check transaction status properly
-            if (strstr(receipt, "\"status\":\"0x1\"") != NULL) {
-                ESP_LOGI(TAG, "Challenge flag reset successful!");
+            if (receipt.success) {
+                ESP_LOGI(TAG, "Challenge flag reset successful! (block %llu, gas used %llu)",
+                         (unsigned long long)receipt.block_number, (unsigned long long)receipt.gas_used);
                 confirmed = true;
                 break;
-            } else if (strstr(receipt, "\"status\":\"0x0\"") != NULL) {
+            } else {
                 ESP_LOGE(TAG, "Challenge flag reset transaction failed on-chain!");
                 return ESP_FAIL;
             }
@@ -468,7 +329,7 @@ esp_err_t farmkeeper_device_reset_challenge_flag(void) {
     }
     
     if (!confirmed) {
-        ESP_LOGW(TAG, "Reset transaction sent but confirmation timed out. Tx hash: %s", tx_hash);
+        ESP_LOGW(TAG, "Reset transaction sent but confirmation timed out. Tx hash: %s", tx_hash_hex);
     }
     
     return confirmed ? ESP_OK : ESP_ERR_TIMEOUT;
@@ -489,18 +350,15 @@ esp_err_t farmkeeper_device_verify_challenge(const char *challenge) {
     
     ESP_LOGI(TAG, "签名并验证挑战: %s", challenge);
     
-    // Create a signature using the challenge text
+    // Create a signature using the challenge text (EIP-191 personal message)
     uint8_t signature[65] = {0};
-    size_t signature_len = 0;
+    size_t signature_len = sizeof(signature);
     
-    // Use the eth_sign_personal_message function from eth_sign.h
-    esp_err_t err = eth_sign_personal_message(
-        device_config.device_private_key,
+    esp_err_t err = eth_signer_sign_personal_message(
+        &s_signer,
         (const uint8_t*)challenge,
         strlen(challenge),
-        signature,
-        sizeof(signature),
-        &signature_len
+        signature
     );
     
     if (err != ESP_OK) {
@@ -516,65 +374,48 @@ esp_err_t farmkeeper_device_verify_challenge(const char *challenge) {
         ESP_LOGE(TAG, "无效的签名长度: %d (必须为65字节)", signature_len);
         return ESP_ERR_INVALID_SIZE;
     }
-    
+
+    // 发送交易前在本地恢复签名地址，避免合约校验失败浪费一笔交易的gas
+    err = eth_verify_personal_message(device_config.device_address, (const uint8_t*)challenge,
+                                      strlen(challenge), signature, signature_len);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "本地签名校验失败，签名地址与设备地址 %s 不一致: %s",
+                 device_config.device_address, esp_err_to_name(err));
+        return err;
+    }
+
     // Encode the function call with our signature
     size_t encoded_len = 0;
     memset(s_encoded_buffer, 0, sizeof(s_encoded_buffer));
     
-    err = encode_verify_challenge_call(signature, signature_len, s_encoded_buffer, sizeof(s_encoded_buffer), &encoded_len);
+    err = device_challenge_encode_verify_device_challenge(&s_device_id, signature, signature_len,
+                                                          s_encoded_buffer, sizeof(s_encoded_buffer), &encoded_len);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "编码验证挑战调用失败: %s", esp_err_to_name(err));
         return err;
     }
     
-    // Convert to hex for transaction
-    memset(s_hex_buffer, 0, sizeof(s_hex_buffer));
-    err = abi_binary_to_hex(s_encoded_buffer, encoded_len, s_hex_buffer, sizeof(s_hex_buffer));
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "二进制转十六进制失败: %s", esp_err_to_name(err));
-        return err;
-    }
-    
     // IMPORTANT: Skip simulation that keeps failing
     ESP_LOGI(TAG, "BYPASSING simulation check and sending transaction directly...");
 
     // Get nonce for the transaction
-    const char* from_address = device_config.device_address;
-    char nonce[32] = {0};
-    err = eth_getTransactionCount(device_config.web3_ctx, from_address, nonce, sizeof(nonce));
+    uint64_t nonce = 0;
+    err = eth_rpc_get_transaction_count(device_config.web3_ctx, s_device_address, &nonce);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to get nonce: %s", esp_err_to_name(err));
         return err;
     }
     
-    // Sign and send the transaction with high gas limit to ensure it gets processed
-    char signed_tx[1024] = {0};
-    err = eth_signTransaction(
-        device_config.web3_ctx,
-        from_address,
-        device_config.contract_address,
-        "0x500000", // High gas limit
-        "0x3b9acaaa", // Standard gas price
-        "0x0", // No ETH value
-        s_hex_buffer,
-        nonce,
-        signed_tx,
-        sizeof(signed_tx)
-    );
-    
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to sign transaction: %s", esp_err_to_name(err));
-        return err;
-    }
-    
-    char tx_hash[128] = {0};
-    err = eth_sendRawTransaction(device_config.web3_ctx, signed_tx, tx_hash, sizeof(tx_hash));
+    // Sign locally and send the transaction with high gas limit to ensure it gets processed
+    eth_hash_t tx_hash;
+    err = sign_and_send_transaction(s_encoded_buffer, encoded_len, 0x500000, 0x3b9acaaa, nonce, tx_hash);
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to send transaction: %s", esp_err_to_name(err));
         return err;
     }
     
-    ESP_LOGI(TAG, "Challenge verification transaction sent, hash: %s", tx_hash);
+    char tx_hash_hex[ETH_HASH_HEX_LEN];
+    eth_hash_to_hex(tx_hash, tx_hash_hex);
+    ESP_LOGI(TAG, "Challenge verification transaction sent, hash: %s", tx_hash_hex);
     
     return ESP_OK;
 }
@@ -616,3 +457,185 @@ esp_err_t farmkeeper_device_check_and_respond_challenge(void) {
     ESP_LOGI(TAG, "Successfully responded to challenge");
     return ESP_OK;
 }
+
+// 只匹配本合约、本设备的DeviceChallengeCreated事件
+static void build_watch_filter(eth_log_filter_t *filter, uint64_t from_block, uint64_t to_block) {
+    memset(filter, 0, sizeof(*filter));
+    filter->address = s_contract_address;
+    filter->topics[0] = s_challenge_topic;
+    filter->topics[1] = s_device_topic;
+    filter->from_block = from_block;
+    filter->to_block = to_block;
+}
+
+static esp_err_t on_challenge_log(void *user_ctx, const eth_log_t *log) {
+    if (log->removed) {
+        return ESP_OK;
+    }
+    ESP_LOGI(TAG, "DeviceChallengeCreated in block %llu", (unsigned long long)log->block_number);
+    *(bool *)user_ctx = true;
+    return ESP_OK;
+}
+
+// 在WebSocket接收任务中执行，只解析并发出信号
+static void on_challenge_notification(void *user_ctx, char *result, size_t result_len) {
+    eth_log_t log;
+    if (eth_rpc_parse_log(result, result_len, &log) != ESP_OK) {
+        ESP_LOGW(TAG, "Malformed challenge notification");
+        return;
+    }
+    bool seen = false;
+    on_challenge_log(&seen, &log);
+    if (seen) {
+        xSemaphoreGive(s_watch_signal);
+    }
+}
+
+// 切换到eth_getLogs模式，从当前区块之后开始查询
+static esp_err_t watch_fall_back_to_logs(void) {
+    uint64_t head = 0;
+    esp_err_t err = eth_get_block_number(device_config.web3_ctx, &head);
+    if (err != ESP_OK) {
+        return err;
+    }
+    s_watch_mode = WATCH_LOGS;
+    s_watch_next_block = head + 1;
+    return ESP_OK;
+}
+
+// 依次尝试订阅、过滤器、eth_getLogs，HTTP传输直接跳过订阅
+static esp_err_t watch_install(void) {
+    eth_log_filter_t filter;
+    build_watch_filter(&filter, ETH_BLOCK_LATEST, ETH_BLOCK_LATEST);
+    
+    if (!s_watch_signal) {
+        s_watch_signal = xSemaphoreCreateBinary();
+    }
+    if (s_watch_signal) {
+        xSemaphoreTake(s_watch_signal, 0);
+        esp_err_t err = eth_rpc_subscribe_logs(device_config.web3_ctx, &filter, on_challenge_notification,
+                                               NULL, s_watch_subscription_id);
+        if (err == ESP_OK) {
+            s_watch_mode = WATCH_SUBSCRIPTION;
+            ESP_LOGI(TAG, "Watching challenge events with subscription %s", s_watch_subscription_id);
+            return ESP_OK;
+        }
+        if (err != ESP_ERR_NOT_SUPPORTED) {
+            ESP_LOGW(TAG, "eth_subscribe failed (%s), polling instead", esp_err_to_name(err));
+        }
+    }
+    
+    esp_err_t err = eth_rpc_new_filter(device_config.web3_ctx, &filter, s_watch_filter_id);
+    if (err == ESP_OK) {
+        s_watch_mode = WATCH_FILTER;
+        ESP_LOGI(TAG, "Watching challenge events with filter %s", s_watch_filter_id);
+        return ESP_OK;
+    }
+    ESP_LOGW(TAG, "eth_newFilter unavailable (%s), polling eth_getLogs instead", esp_err_to_name(err));
+    return watch_fall_back_to_logs();
+}
+
+esp_err_t farmkeeper_device_watch_start(void) {
+    if (!is_initialized) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!FARMKEEPER_CHALLENGE_EVENTS) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    farmkeeper_device_watch_stop();
+    
+    esp_err_t err = watch_install();
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start challenge watcher: %s", esp_err_to_name(err));
+        return err;
+    }
+    
+    s_watch_active = true;
+    return ESP_OK;
+}
+
+esp_err_t farmkeeper_device_watch_poll(bool *challenge_seen) {
+    if (!s_watch_active || !challenge_seen) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *challenge_seen = false;
+    
+    eth_log_filter_t filter;
+    esp_err_t err;
+    if (s_watch_mode == WATCH_SUBSCRIPTION) {
+        if (web3_is_subscribed(device_config.web3_ctx, s_watch_subscription_id)) {
+            *challenge_seen = xSemaphoreTake(s_watch_signal, 0) == pdTRUE;
+            return ESP_OK;
+        }
+        
+        // 连接断开过，订阅随之失效，处理方式与过滤器被回收相同
+        ESP_LOGW(TAG, "Challenge subscription lost, resubscribing");
+        *challenge_seen = true;
+        return watch_install();
+    }
+    
+    if (s_watch_mode == WATCH_FILTER) {
+        err = eth_rpc_get_filter_changes(device_config.web3_ctx, s_watch_filter_id,
+                                         on_challenge_log, challenge_seen, NULL);
+        if (err != ESP_ERR_NOT_FOUND) {
+            return err;
+        }
+        
+        // 过滤器被节点回收 (长时间未查询或节点重启)，期间的事件已丢失，
+        // 重新安装后报告一次，由调用者用hasChallenge确认实际状态
+        ESP_LOGW(TAG, "Challenge filter expired, reinstalling");
+        *challenge_seen = true;
+        build_watch_filter(&filter, ETH_BLOCK_LATEST, ETH_BLOCK_LATEST);
+        if (eth_rpc_new_filter(device_config.web3_ctx, &filter, s_watch_filter_id) == ESP_OK) {
+            return ESP_OK;
+        }
+        return watch_fall_back_to_logs();
+    }
+    
+    // 新区块到来前不查询日志，空闲时每次轮询只有一个eth_blockNumber请求
+    uint64_t head = 0;
+    err = eth_get_block_number(device_config.web3_ctx, &head);
+    if (err != ESP_OK || head < s_watch_next_block) {
+        return err;
+    }
+    
+    build_watch_filter(&filter, s_watch_next_block, head);
+    err = eth_rpc_get_logs(device_config.web3_ctx, &filter, on_challenge_log, challenge_seen, NULL);
+    if (err == ESP_OK) {
+        s_watch_next_block = head + 1;
+    }
+    return err;
+}
+
+esp_err_t farmkeeper_device_watch_wait(uint32_t timeout_ms, bool *challenge_seen) {
+    if (!s_watch_active || !challenge_seen) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    // 订阅模式下事件到达立即返回，超时后再确认订阅是否还在
+    if (s_watch_mode == WATCH_SUBSCRIPTION &&
+        xSemaphoreTake(s_watch_signal, pdMS_TO_TICKS(timeout_ms)) == pdTRUE) {
+        *challenge_seen = true;
+        return ESP_OK;
+    }
+    // 轮询间隔通常长于节点的keep-alive空闲超时，等待期间保持HTTP连接，查询时不必重新握手
+    while (s_watch_mode != WATCH_SUBSCRIPTION && timeout_ms > 0) {
+        uint32_t slice_ms = timeout_ms < WEB3_HTTP_KEEPALIVE_MS ? timeout_ms : WEB3_HTTP_KEEPALIVE_MS;
+        vTaskDelay(pdMS_TO_TICKS(slice_ms));
+        timeout_ms -= slice_ms;
+        if (timeout_ms > 0) {
+            web3_keep_alive(device_config.web3_ctx);
+        }
+    }
+    return farmkeeper_device_watch_poll(challenge_seen);
+}
+
+void farmkeeper_device_watch_stop(void) {
+    if (s_watch_active && s_watch_mode == WATCH_FILTER) {
+        eth_rpc_uninstall_filter(device_config.web3_ctx, s_watch_filter_id);
+    } else if (s_watch_active && s_watch_mode == WATCH_SUBSCRIPTION) {
+        web3_unsubscribe(device_config.web3_ctx, s_watch_subscription_id);
+    }
+    s_watch_active = false;
+    s_watch_mode = WATCH_LOGS;
+}
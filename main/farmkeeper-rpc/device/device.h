@@ -6,6 +6,24 @@
 #include "ethereum-lib/web3.h"
 #include "esp_err.h"
 
+/*
+ * DeviceChallengeCreated(uint256 indexed deviceId, string challenge) is declared in
+ * abi/DeviceChallenge.json but has not been checked against the deployed contract's ABI.
+ * Event-driven detection stays off until it has been: with 0 the watcher reports
+ * ESP_ERR_NOT_SUPPORTED and callers fall back to polling hasChallenge.
+ */
+#ifndef FARMKEEPER_CHALLENGE_EVENTS
+#define FARMKEEPER_CHALLENGE_EVENTS 0
+#endif
+
+/*
+ * With events enabled, still confirm with hasChallenge after this many idle watch waits,
+ * so a contract that never emits the event cannot hide a challenge indefinitely.
+ */
+#ifndef FARMKEEPER_CHALLENGE_BACKSTOP_WAITS
+#define FARMKEEPER_CHALLENGE_BACKSTOP_WAITS 4
+#endif
+
 /**
  * @brief Device challenge configuration structure
  */
@@ -15,6 +33,7 @@ typedef struct {
     const char *device_private_key; // Device private key for signing
     const char *device_address;     // Device Ethereum address (derived from private key)
     uint32_t device_id;             // Device ID in the FarmKeeper system
+    uint64_t chain_id;              // EIP-155 chain ID used for local transaction signing (0 = pre-EIP-155)
     uint32_t poll_interval_ms;      // How often to check for challenges (milliseconds)
 } farmkeeper_device_config_t;
 
@@ -67,4 +86,51 @@ esp_err_t farmkeeper_device_verify_challenge(const char *challenge);
  */
 esp_err_t farmkeeper_device_reset_challenge_flag(void);
 
+/**
+ * @brief Start watching DeviceChallengeCreated events for this device
+ *
+ * On a WebSocket context the node pushes matching logs through eth_subscribe. Otherwise
+ * installs an eth_newFilter on the contract for the challenge event topic and this
+ * device ID; nodes without filter support fall back to eth_getLogs polling from a
+ * checkpointed block. Start the watcher before the initial hasChallenge check so that
+ * a challenge created in between is not missed.
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED when FARMKEEPER_CHALLENGE_EVENTS is 0,
+ *         or an error code
+ */
+esp_err_t farmkeeper_device_watch_start(void);
+
+/**
+ * @brief Poll the challenge watcher once
+ *
+ * Idle polls are a single eth_getFilterChanges (or eth_blockNumber) request and do not
+ * execute the contract. A log only signals that something changed; confirm with
+ * farmkeeper_device_has_challenge before responding.
+ *
+ * @param challenge_seen Set to true if a matching event appeared since the last poll, or
+ *                       if the node dropped the filter or subscription and events may
+ *                       have been missed
+ * @return ESP_OK on success or an error code
+ */
+esp_err_t farmkeeper_device_watch_poll(bool *challenge_seen);
+
+/**
+ * @brief Wait up to timeout_ms for a challenge event
+ *
+ * With a subscription this returns as soon as the node pushes a matching log. In the
+ * polling modes it sleeps for timeout_ms and then polls once. During the sleep it calls
+ * web3_keep_alive every WEB3_HTTP_KEEPALIVE_MS, so the poll reuses the HTTP connection
+ * instead of reconnecting after the node's idle timeout.
+ *
+ * @param timeout_ms Longest time to block
+ * @param challenge_seen Same meaning as in farmkeeper_device_watch_poll
+ * @return ESP_OK on success or an error code
+ */
+esp_err_t farmkeeper_device_watch_wait(uint32_t timeout_ms, bool *challenge_seen);
+
+/**
+ * @brief Stop the challenge watcher and uninstall its filter or subscription
+ */
+void farmkeeper_device_watch_stop(void);
+
 #endif /* FARMKEEPER_DEVICE_H */
@@ -0,0 +1,37 @@
+#include "farmkeeper_abi.h"
+#include <stdbool.h>
+#include <esp_log.h>
+
+static const char *TAG = "FARMKEEPER_ABI";
+
+// 构建时由EMBED_TXTFILES嵌入flash的合约编译产物 (末尾追加了'\0')
+extern const char FarmKeeper_json[];
+extern const uint32_t FarmKeeper_json_length;
+
+static abi_index_t s_index;
+static bool s_loaded = false;
+
+esp_err_t farmkeeper_abi_init(void) {
+    if (s_loaded) {
+        return ESP_OK;
+    }
+    
+    esp_err_t err = abi_index_load(&s_index, FarmKeeper_json, FarmKeeper_json_length);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to index FarmKeeper ABI: %s", esp_err_to_name(err));
+        return err;
+    }
+    
+    s_loaded = true;
+    ESP_LOGI(TAG, "FarmKeeper ABI: %d entries indexed (%d bytes RAM)",
+             (int)s_index.count, (int)s_index.memory_used);
+    return ESP_OK;
+}
+
+const abi_index_t *farmkeeper_abi_get(void) {
+    return s_loaded ? &s_index : NULL;
+}
+
+const abi_index_entry_t *farmkeeper_abi_function(const char *name) {
+    return s_loaded ? abi_index_find(&s_index, ABI_ENTRY_FUNCTION, name) : NULL;
+}
@@ -0,0 +1,31 @@
+#ifndef FARMKEEPER_ABI_H
+#define FARMKEEPER_ABI_H
+
+#include "esp_err.h"
+#include "ethereum-lib/eth_abi_index.h"
+
+/**
+ * @brief Build the FarmKeeper ABI index from the JSON embedded in flash
+ *
+ * Scans main/abi/FarmKeeper.json (embedded with EMBED_TXTFILES) once; later calls are no-ops.
+ *
+ * @return ESP_OK on success or an error code
+ */
+esp_err_t farmkeeper_abi_init(void);
+
+/**
+ * @brief Get the FarmKeeper ABI index
+ *
+ * @return Index built by farmkeeper_abi_init, or NULL if it has not been initialized
+ */
+const abi_index_t *farmkeeper_abi_get(void);
+
+/**
+ * @brief Look up a FarmKeeper function by name
+ *
+ * @param name Function name, e.g. "addFarm"
+ * @return Index entry (signature, selector, input/output types), or NULL if not found
+ */
+const abi_index_entry_t *farmkeeper_abi_function(const char *name);
+
+#endif /* FARMKEEPER_ABI_H */
@@ -1,17 +1,29 @@
 #include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <esp_system.h>
 #include <esp_log.h>
+#include <esp_timer.h>
+#include <esp_cpu.h>
 #include <nvs_flash.h>
 #include <esp_wifi.h>
 #include <esp_event.h>
 #include "ethereum-lib/web3.h"
+#include "ethereum-lib/web3_transport.h"
 #include "ethereum-lib/eth_rpc.h"
 #include "ethereum-lib/net_test.h"
 #include "ethereum-lib/eth_abi.h"
+#include "ethereum-lib/eth_keccak.h"
+#include "ethereum-lib/eth_sign.h"
+#include "ethereum-lib/eth_json.h"
+#include "ethereum-lib/eth_hex.h"
+#include "ethereum-lib/eth_units.h"
+#include "ethereum-lib/eth_multicall.h"
 #include "farmkeeper-rpc/device/device.h"
+#include "farmkeeper-rpc/farmkeeper_abi.h"
+#include "farmkeeper_contract.h"
 
 #include "cJSON.h"
 static const char *TAG = "ETHEREUM_TEST";
@@ -109,45 +121,23 @@ void test_transaction_signing(web3_context_t* context) {
     const char* value = "0xDE0B6B3A7640000"; // 转账金额 1 ETH (1 ETH = 10^18 Wei)
     const char* gas = "0x5208"; // 21000 gas - 标准转账所需的gas量
     
-    // 获取账户nonce
-    char nonce[32] = {0};
-    esp_err_t err = eth_getTransactionCount(context, from_address, nonce, sizeof(nonce));
+    // 一次批量请求获取账户nonce和当前gas价格，结果直接是数值
+    eth_address_t from;
+    eth_address_from_hex(from_address, from);
+    uint64_t nonce_value = 0;
+    uint256_t gas_price_value;
+    esp_err_t err = eth_rpc_get_nonce_and_gas_price(context, from, &nonce_value, &gas_price_value);
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "获取nonce失败: %s", esp_err_to_name(err));
+        ESP_LOGE(TAG, "获取nonce和gas价格失败: %s", esp_err_to_name(err));
         return;
     }
-    ESP_LOGI(TAG, "当前账户nonce: %s", nonce);
     
-    // 获取当前gas价格
-    char gas_price[64] = {0};
-    err = get_eth_gasPrice(context, gas_price, sizeof(gas_price));
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "获取gas价格失败: %s", esp_err_to_name(err));
-        return;
-    }
-    
-    // 正确地提取十六进制gas价格部分
-    char gas_price_hex[32] = {0};
-    if (strncmp(gas_price, "0x", 2) == 0) {
-        // 找到十六进制字符串的结束位置 (空格或括号处)
-        char* end = strchr(gas_price, ' ');
-        if (!end) {
-            end = strchr(gas_price, '(');
-        }
-        
-        if (end) {
-            size_t hex_len = end - gas_price;
-            strncpy(gas_price_hex, gas_price, hex_len);
-            gas_price_hex[hex_len] = '\0';
-        } else {
-            // 如果没找到分隔符，复制整个字符串
-            strcpy(gas_price_hex, gas_price);
-        }
-    } else {
-        // 如果不是以0x开头，使用默认值
-        strcpy(gas_price_hex, "0x1");
-    }
-    ESP_LOGI(TAG, "当前gas价格 (仅十六进制部分): %s", gas_price_hex);
+    // eth_signTransaction由节点签名，参数仍需十六进制
+    char nonce[32];
+    snprintf(nonce, sizeof(nonce), "0x%llx", (unsigned long long)nonce_value);
+    char gas_price_hex[UINT256_HEX_BUF_LEN];
+    uint256_to_hex(&gas_price_value, gas_price_hex, sizeof(gas_price_hex));
+    ESP_LOGI(TAG, "当前账户nonce: %s, gas价格: %s", nonce, gas_price_hex);
     
     // 对于简单的ETH转账，data字段为空
     const char* data = "0x"; // 或NULL
@@ -295,6 +285,350 @@ void test_abi_encoding(web3_context_t* context) {
 
 }
 
+// 测试本地Keccak256的正确性并测量吞吐量 (MB/s)
+void test_keccak_benchmark(void) {
+    ESP_LOGI(TAG, "测试Keccak256...");
+    
+    // 已知向量: transfer(address,uint256) 的选择器为 a9059cbb
+    uint8_t selector[4] = {0};
+    abi_encode_function_selector(NULL, "transfer(address,uint256)", selector);
+    if (selector[0] != 0xa9 || selector[1] != 0x05 || selector[2] != 0x9c || selector[3] != 0xbb) {
+        ESP_LOGE(TAG, "Keccak256选择器校验失败: %02x%02x%02x%02x",
+                 selector[0], selector[1], selector[2], selector[3]);
+        return;
+    }
+    
+    const size_t block_len = 4096;
+    const int iterations = 256;
+    uint8_t *data = malloc(block_len);
+    if (!data) {
+        ESP_LOGE(TAG, "分配测试缓冲区失败");
+        return;
+    }
+    for (size_t i = 0; i < block_len; i++) {
+        data[i] = (uint8_t)i;
+    }
+    
+    uint8_t hash[ETH_KECCAK256_HASH_LEN];
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        eth_keccak256(data, block_len, hash);
+    }
+    int64_t elapsed_us = esp_timer_get_time() - start;
+    free(data);
+    
+    double mb = (double)block_len * iterations / (1024.0 * 1024.0);
+    ESP_LOGI(TAG, "Keccak256: %d x %d 字节, 耗时 %lld us, %.2f MB/s",
+             iterations, (int)block_len, elapsed_us, mb / (elapsed_us / 1000000.0));
+    
+    // 短输入 (函数签名) 的单次耗时
+    start = esp_timer_get_time();
+    for (int i = 0; i < 1000; i++) {
+        abi_encode_function_selector(NULL, "hasChallenge(uint256)", selector);
+    }
+    elapsed_us = esp_timer_get_time() - start;
+    ESP_LOGI(TAG, "函数选择器: 平均 %.2f us/次", elapsed_us / 1000.0);
+}
+
+// 测试secp256k1签名速度: 复用签名器 vs 每次解析私钥
+void test_sign_benchmark(void) {
+    ESP_LOGI(TAG, "测试secp256k1签名...");
+    
+    // EIP-155示例私钥，对应地址 0x9d8a62f656a8d1615c1294fd71e9cfb3e4855a4f
+    const char *private_key = "4646464646464646464646464646464646464646464646464646464646464646";
+    const uint8_t expected_address[20] = {
+        0x9d, 0x8a, 0x62, 0xf6, 0x56, 0xa8, 0xd1, 0x61, 0x5c, 0x12,
+        0x94, 0xfd, 0x71, 0xe9, 0xcf, 0xb3, 0xe4, 0x85, 0x5a, 0x4f
+    };
+    
+    eth_signer_t signer;
+    esp_err_t err = eth_signer_init(&signer, private_key);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "初始化签名器失败: %s", esp_err_to_name(err));
+        return;
+    }
+    if (memcmp(signer.address, expected_address, sizeof(expected_address)) != 0) {
+        ESP_LOGE(TAG, "私钥推导的地址不正确");
+        eth_signer_free(&signer);
+        return;
+    }
+    
+    const int iterations = 20;
+    uint8_t hash[ETH_KECCAK256_HASH_LEN];
+    uint8_t signature[65];
+    
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        eth_keccak256((const uint8_t *)&i, sizeof(i), hash);
+        err = eth_signer_sign_hash(&signer, hash, signature);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "签名失败: %s", esp_err_to_name(err));
+            break;
+        }
+    }
+    int64_t reused_us = esp_timer_get_time() - start;
+    eth_signer_free(&signer);
+    
+    start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        eth_keccak256((const uint8_t *)&i, sizeof(i), hash);
+        err = eth_sign_hash(private_key, hash, signature);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "签名失败: %s", esp_err_to_name(err));
+            break;
+        }
+    }
+    int64_t oneshot_us = esp_timer_get_time() - start;
+    
+    ESP_LOGI(TAG, "复用签名器: %.2f 次/秒 (%lld us/次)",
+             iterations * 1000000.0 / reused_us, reused_us / iterations);
+    ESP_LOGI(TAG, "每次解析私钥: %.2f 次/秒 (%lld us/次)",
+             iterations * 1000000.0 / oneshot_us, oneshot_us / iterations);
+}
+
+// cJSON分配计数，用于对比两种解析方式的堆分配次数
+static int s_cjson_alloc_count = 0;
+
+static void *counting_malloc(size_t size) {
+    s_cjson_alloc_count++;
+    return malloc(size);
+}
+
+// 测试JSON-RPC响应解析: 流式解析 vs cJSON
+void test_json_benchmark(void) {
+    ESP_LOGI(TAG, "测试JSON-RPC响应解析...");
+    
+    // 构造一个典型的eth_call响应 (约1KB十六进制结果)
+    const size_t hex_len = 1024;
+    char *response = malloc(hex_len + 64);
+    if (!response) {
+        ESP_LOGE(TAG, "分配测试缓冲区失败");
+        return;
+    }
+    int len = snprintf(response, 64, "{\"jsonrpc\":\"2.0\",\"id\":42,\"result\":\"0x");
+    for (size_t i = 0; i < hex_len; i++) {
+        response[len++] = "0123456789abcdef"[i % 16];
+    }
+    len += snprintf(response + len, 8, "\"}");
+    
+    char *out = malloc(hex_len + 8);
+    if (!out) {
+        free(response);
+        ESP_LOGE(TAG, "分配测试缓冲区失败");
+        return;
+    }
+    
+    const int iterations = 1000;
+    
+    // cJSON: 构建整棵树再取result
+    cJSON_Hooks hooks = { .malloc_fn = counting_malloc, .free_fn = free };
+    cJSON_InitHooks(&hooks);
+    s_cjson_alloc_count = 0;
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        cJSON *json = cJSON_Parse(response);
+        cJSON *result = json ? cJSON_GetObjectItem(json, "result") : NULL;
+        if (result && cJSON_IsString(result)) {
+            strncpy(out, result->valuestring, hex_len + 7);
+        }
+        cJSON_Delete(json);
+    }
+    int64_t cjson_us = esp_timer_get_time() - start;
+    int cjson_allocs = s_cjson_alloc_count;
+    cJSON_InitHooks(NULL);
+    
+    // 流式解析: 直接在接收缓冲区上定位result
+    size_t heap_before = esp_get_free_heap_size();
+    start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        eth_rpc_response_t resp;
+        if (eth_json_parse_response(response, len, &resp) == ESP_OK) {
+            eth_json_token_copy_string(&resp.result, out, hex_len + 8);
+        }
+    }
+    int64_t stream_us = esp_timer_get_time() - start;
+    size_t heap_after = esp_get_free_heap_size();
+    
+    free(out);
+    free(response);
+    
+    double mb = (double)len * iterations / (1024.0 * 1024.0);
+    ESP_LOGI(TAG, "cJSON: %.2f MB/s, %lld us/次, 堆分配 %d 次/响应",
+             mb / (cjson_us / 1000000.0), cjson_us / iterations, cjson_allocs / iterations);
+    ESP_LOGI(TAG, "流式解析: %.2f MB/s, %lld us/次, 堆变化 %d 字节",
+             mb / (stream_us / 1000000.0), stream_us / iterations, (int)heap_before - (int)heap_after);
+}
+
+// 原先逐字节sprintf/sscanf的十六进制转换，仅作为基准对照
+static void legacy_binary_to_hex(const uint8_t *binary, size_t binary_len, char *hex) {
+    hex[0] = '0';
+    hex[1] = 'x';
+    for (size_t i = 0; i < binary_len; i++) {
+        sprintf(hex + 2 + i * 2, "%02x", binary[i]);
+    }
+}
+
+static void legacy_hex_to_binary(const char *hex, uint8_t *binary, size_t binary_len) {
+    hex += 2;
+    for (size_t i = 0; i < binary_len; i++) {
+        char byte_str[3] = {hex[i * 2], hex[i * 2 + 1], 0};
+        unsigned int byte_val;
+        sscanf(byte_str, "%02x", &byte_val);
+        binary[i] = (uint8_t)byte_val;
+    }
+}
+
+// 测试十六进制编解码: 查表实现 vs sprintf/sscanf，结果以 字节/周期 表示
+void test_hex_benchmark(void) {
+    ESP_LOGI(TAG, "测试十六进制编解码...");
+    
+    const size_t bin_len = 1024;
+    const int iterations = 64;
+    uint8_t *bin = malloc(bin_len);
+    uint8_t *decoded = malloc(bin_len);
+    char *hex = malloc(ETH_HEX_ENCODED_LEN(bin_len));
+    char *legacy_hex = malloc(ETH_HEX_ENCODED_LEN(bin_len));
+    if (!bin || !decoded || !hex || !legacy_hex) {
+        ESP_LOGE(TAG, "分配测试缓冲区失败");
+        goto cleanup;
+    }
+    for (size_t i = 0; i < bin_len; i++) {
+        bin[i] = (uint8_t)(i * 131 + 7);
+    }
+    
+    // 结果必须与原实现一致
+    size_t written = 0;
+    legacy_binary_to_hex(bin, bin_len, legacy_hex);
+    if (eth_hex_encode(bin, bin_len, hex, ETH_HEX_ENCODED_LEN(bin_len), true) != ESP_OK ||
+        strcmp(hex, legacy_hex) != 0 ||
+        eth_hex_decode(hex, strlen(hex), decoded, bin_len, &written) != ESP_OK ||
+        written != bin_len || memcmp(decoded, bin, bin_len) != 0) {
+        ESP_LOGE(TAG, "十六进制编解码结果与原实现不一致");
+        goto cleanup;
+    }
+    
+    uint32_t start = esp_cpu_get_cycle_count();
+    for (int i = 0; i < iterations; i++) {
+        legacy_binary_to_hex(bin, bin_len, legacy_hex);
+    }
+    uint32_t legacy_encode_cycles = esp_cpu_get_cycle_count() - start;
+    
+    start = esp_cpu_get_cycle_count();
+    for (int i = 0; i < iterations; i++) {
+        eth_hex_encode(bin, bin_len, hex, ETH_HEX_ENCODED_LEN(bin_len), true);
+    }
+    uint32_t encode_cycles = esp_cpu_get_cycle_count() - start;
+    
+    start = esp_cpu_get_cycle_count();
+    for (int i = 0; i < iterations; i++) {
+        legacy_hex_to_binary(hex, decoded, bin_len);
+    }
+    uint32_t legacy_decode_cycles = esp_cpu_get_cycle_count() - start;
+    
+    start = esp_cpu_get_cycle_count();
+    for (int i = 0; i < iterations; i++) {
+        eth_hex_decode(hex, bin_len * 2 + 2, decoded, bin_len, &written);
+    }
+    uint32_t decode_cycles = esp_cpu_get_cycle_count() - start;
+    
+    double total = (double)bin_len * iterations;
+    ESP_LOGI(TAG, "编码: sprintf %.4f 字节/周期, 查表 %.4f 字节/周期 (%.1fx)",
+             total / legacy_encode_cycles, total / encode_cycles, (double)legacy_encode_cycles / encode_cycles);
+    ESP_LOGI(TAG, "解码: sscanf %.4f 字节/周期, 查表 %.4f 字节/周期 (%.1fx)",
+             total / legacy_decode_cycles, total / decode_cycles, (double)legacy_decode_cycles / decode_cycles);
+    
+cleanup:
+    free(bin);
+    free(decoded);
+    free(hex);
+    free(legacy_hex);
+}
+
+// 测试代币单位换算: 批量格式化余额 (仪表盘刷新场景) 与解析
+void test_units_benchmark(void) {
+    ESP_LOGI(TAG, "测试代币单位换算...");
+    
+    uint256_t wei;
+    char text[ETH_UNITS_BUF_LEN];
+    
+    // 已知向量: 1.25 ETH 与 6位小数的USDC
+    if (eth_units_parse("1.25", 4, ETH_ETHER_DECIMALS, &wei) != ESP_OK ||
+        eth_units_format(&wei, ETH_ETHER_DECIMALS, ETH_UNITS_FULL_PRECISION, text, sizeof(text)) != ESP_OK ||
+        strcmp(text, "1.25") != 0) {
+        ESP_LOGE(TAG, "ETH单位换算校验失败: %s", text);
+        return;
+    }
+    if (eth_units_parse("1234.000001", 11, 6, &wei) != ESP_OK || wei.limbs[0] != 1234000001ULL ||
+        eth_units_format(&wei, 6, 2, text, sizeof(text)) != ESP_OK || strcmp(text, "1234.00") != 0) {
+        ESP_LOGE(TAG, "USDC单位换算校验失败: %s", text);
+        return;
+    }
+    
+    const int count = 1000;
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < count; i++) {
+        uint256_set_u64(&wei, 1234567890123456789ULL + (uint64_t)i * 1000003ULL);
+        uint256_mul_u64(&wei, 1000, &wei);
+        eth_units_format(&wei, ETH_ETHER_DECIMALS, ETH_UNITS_FULL_PRECISION, text, sizeof(text));
+    }
+    int64_t format_us = esp_timer_get_time() - start;
+    
+    start = esp_timer_get_time();
+    for (int i = 0; i < count; i++) {
+        eth_units_parse("1234567.890123456789012345", 26, ETH_ETHER_DECIMALS, &wei);
+    }
+    int64_t parse_us = esp_timer_get_time() - start;
+    
+    ESP_LOGI(TAG, "格式化 %d 个余额: %lld us (%.2f us/个), 最后一个: %s ETH",
+             count, format_us, (double)format_us / count, text);
+    ESP_LOGI(TAG, "解析: %.2f us/次", (double)parse_us / count);
+}
+
+// mock后端的响应: 每个请求都返回1 ETH余额
+static esp_err_t mock_balance_handler(void* user_ctx, const char* body, size_t body_len,
+                                      web3_response_sink_t* sink) {
+    static const char response[] = "{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":\"0xde0b6b3a7640000\"}";
+    (*(int*)user_ctx)++;
+    return web3_sink_write(sink, response, sizeof(response) - 1);
+}
+
+// 测试请求路径本身的开销: 通过进程内mock后端查询余额，不经过网络
+void test_transport_mock_benchmark(void) {
+    ESP_LOGI(TAG, "测试mock传输后端...");
+    
+    int handled = 0;
+    web3_transport_t* transport = NULL;
+    web3_context_t mock_context;
+    if (web3_transport_mock_create(mock_balance_handler, &handled, &transport) != ESP_OK ||
+        web3_init_with_transport(&mock_context, "mock://", transport) != ESP_OK) {
+        ESP_LOGE(TAG, "mock后端初始化失败");
+        return;
+    }
+    
+    eth_address_t address;
+    eth_address_from_hex("0x5FbDB2315678afecb367f032d93F642f64180aa3", address);
+    uint256_t balance;
+    char text[ETH_UNITS_BUF_LEN];
+    if (eth_rpc_get_balance(&mock_context, address, &balance) != ESP_OK ||
+        eth_units_format(&balance, ETH_ETHER_DECIMALS, ETH_UNITS_FULL_PRECISION, text, sizeof(text)) != ESP_OK ||
+        strcmp(text, "1") != 0) {
+        ESP_LOGE(TAG, "mock余额校验失败");
+        web3_cleanup(&mock_context);
+        return;
+    }
+    
+    const int count = 1000;
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < count; i++) {
+        eth_rpc_get_balance(&mock_context, address, &balance);
+    }
+    int64_t elapsed_us = esp_timer_get_time() - start;
+    
+    ESP_LOGI(TAG, "eth_getBalance %d 次 (mock): %lld us (%.2f us/次), 回调 %d 次",
+             count, elapsed_us, (double)elapsed_us / count, handled);
+    web3_cleanup(&mock_context);
+}
+
 // 测试调用合约函数获取作者信息
 void test_get_author_info(web3_context_t* context) {
     ESP_LOGI(TAG, "测试调用合约函数获取作者信息...");
@@ -302,13 +636,20 @@ void test_get_author_info(web3_context_t* context) {
     // 合约地址
     const char* contract_address = "0x8aCd85898458400f7Db866d53FCFF6f0D49741FF";
     
+    // 从嵌入的ABI索引中取得函数签名和返回值类型
+    const abi_index_entry_t* fn = farmkeeper_abi_function("getAuthorInformation");
+    if (!fn) {
+        ESP_LOGE(TAG, "ABI中没有getAuthorInformation");
+        return;
+    }
+    
     // 创建函数调用数据 - getAuthorInformation()
     // 无需参数，仅需函数选择器
     uint8_t encoded[4] = {0}; // 只需要4字节的函数选择器
     size_t encoded_len = 0;
     esp_err_t err = abi_encode_function_call(
         context,
-        "getAuthorInformation()",
+        fn->signature,
         NULL, // 无参数
         0,
         encoded,
@@ -391,37 +732,87 @@ void test_get_author_info(web3_context_t* context) {
         return;
     }
     
-    // 解码返回的三个字符串
-    abi_decoded_value_t decoded_values[3] = {0}; // 三个字符串
-    size_t decoded_count = 0;
-    
-    // 在解码前清空结构体
-    memset(decoded_values, 0, sizeof(decoded_values));
-    
-    err = abi_decode_returns(binary_data, binary_len, decoded_values, 3, &decoded_count);
+    // 按ABI中的返回值类型解码三个字符串，结果直接指向binary_data
+    abi_value_t returns;
+    err = abi_decode(fn->outputs, binary_data, binary_len, &returns);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "解码返回值失败: %s", esp_err_to_name(err));
         cJSON_Delete(json);
         return;
     }
     
-    ESP_LOGI(TAG, "成功解码 %d 个返回值", decoded_count);
+    ESP_LOGI(TAG, "成功解码 %d 个返回值", (int)returns.length);
     
     // 显示解码后的字符串
-    for (size_t i = 0; i < decoded_count; i++) {
-        if (decoded_values[i].value.string) {
-            ESP_LOGI(TAG, "返回值 %d: %s", i+1, decoded_values[i].value.string);
-        } else {
-            ESP_LOGI(TAG, "返回值 %d: <null>", i+1);
+    for (size_t i = 0; i < returns.length; i++) {
+        abi_value_t value;
+        if (abi_value_at(&returns, i, &value) == ESP_OK) {
+            ESP_LOGI(TAG, "返回值 %d: %.*s", (int)(i + 1), (int)value.length, (const char*)value.data);
         }
     }
     
-    // 释放分配的内存
-    for (size_t i = 0; i < decoded_count; i++) {
-        abi_free_decoded_value(&decoded_values[i]);
+    cJSON_Delete(json);
+}
+
+// 测试通过Multicall3一次读取FarmKeeper的多个只读函数
+void test_multicall_reads(web3_context_t* context) {
+    ESP_LOGI(TAG, "测试Multicall3批量读取...");
+    
+    eth_address_t farmkeeper;
+    eth_address_from_hex("0x8aCd85898458400f7Db866d53FCFF6f0D49741FF", farmkeeper);
+    
+    // 五个无参数的只读函数，调用数据都只有4字节选择器
+    uint8_t call_data[5][4];
+    size_t call_len = 0;
+    farmkeeper_encode_owner(call_data[0], 4, &call_len);
+    farmkeeper_encode_contract_name(call_data[1], 4, &call_len);
+    farmkeeper_encode_farm_contract(call_data[2], 4, &call_len);
+    farmkeeper_encode_device_contract(call_data[3], 4, &call_len);
+    farmkeeper_encode_fkt_token(call_data[4], 4, &call_len);
+    
+    eth_multicall_call_t calls[5];
+    for (size_t i = 0; i < 5; i++) {
+        calls[i] = (eth_multicall_call_t){
+            .target = farmkeeper, .allow_failure = true,
+            .call_data = call_data[i], .call_data_len = sizeof(call_data[i]),
+        };
     }
     
-    cJSON_Delete(json);
+    eth_multicall_result_t results[5];
+    uint8_t buf[1024];
+    int64_t start = esp_timer_get_time();
+    esp_err_t err = eth_multicall_aggregate3(context, ETH_MULTICALL3_ADDRESS, calls, 5, buf, sizeof(buf), results);
+    int64_t elapsed = esp_timer_get_time() - start;
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Multicall3调用失败: %s", esp_err_to_name(err));
+        return;
+    }
+    ESP_LOGI(TAG, "5个调用合并为1个请求，耗时 %lld us", (long long)elapsed);
+    
+    static const char* labels[] = { "owner", "contractName", "farmContract", "deviceContract", "FKTToken" };
+    for (size_t i = 0; i < 5; i++) {
+        if (!results[i].success) {
+            ESP_LOGW(TAG, "调用 %d 失败 (revert数据 %d 字节)", (int)i, (int)results[i].return_data_len);
+            continue;
+        }
+        if (i == 1) {
+            const char* name = NULL;
+            size_t name_len = 0;
+            if (farmkeeper_decode_contract_name(results[i].return_data, results[i].return_data_len,
+                                                &name, &name_len) == ESP_OK) {
+                ESP_LOGI(TAG, "%s: %.*s", labels[i], (int)name_len, name);
+            }
+            continue;
+        }
+        
+        // 其余四个函数都返回address，解码方式相同
+        eth_address_t address;
+        char address_hex[ETH_ADDRESS_HEX_LEN];
+        if (farmkeeper_decode_owner(results[i].return_data, results[i].return_data_len, address) == ESP_OK) {
+            eth_address_to_hex(address, address_hex);
+            ESP_LOGI(TAG, "%s: %s", labels[i], address_hex);
+        }
+    }
 }
 
 // 测试调用addFarm合约方法
@@ -445,22 +836,38 @@ void test_add_farm(web3_context_t* context) {
     longitude_bytes[30] = 0xD6;
     longitude_bytes[29] = 0x87;
     
-    // 定义Location结构体的参数数组
-    abi_param_t location_params[2] = {
+    const abi_index_entry_t* fn = farmkeeper_abi_function("addFarm");
+    if (!fn) {
+        ESP_LOGE(TAG, "ABI中没有addFarm");
+        return;
+    }
+    
+    // 定义Location结构体，作为一个元组参数传入
+    abi_param_t location_fields[2] = {
         ABI_UINT(256, latitude_bytes),     // 纬度
         ABI_UINT(256, longitude_bytes)     // 经度
     };
+    abi_param_t location_params[1] = {
+        ABI_TUPLE(location_fields, 2)
+    };
     
-    // 编码函数调用
-    uint8_t encoded[512] = {0};
+    // 先计算精确的编码长度，再编码函数调用
+    size_t params_size = 0;
+    esp_err_t err = abi_encoded_size(location_params, 1, &params_size);
+    if (err != ESP_OK || 4 + params_size > 512) {
+        ESP_LOGE(TAG, "计算addFarm编码长度失败: %s", esp_err_to_name(err));
+        return;
+    }
+    
+    uint8_t encoded[512];
     size_t encoded_len = 0;
-    esp_err_t err = abi_encode_function_call(
+    err = abi_encode_function_call(
         context,
-        "addFarm((uint256,uint256))",  // 带结构体类型的函数签名
+        fn->signature,  // "addFarm((uint256,uint256))"，来自ABI索引
         location_params,
-        2,
+        1,
         encoded,
-        sizeof(encoded),
+        4 + params_size,
         &encoded_len
     );
     
@@ -479,42 +886,23 @@ void test_add_farm(web3_context_t* context) {
     
     ESP_LOGI(TAG, "编码后的函数调用数据: %s", hex_data);
     
-    // 获取发送者地址和nonce
+    // 获取发送者地址，并批量获取nonce和gas价格
     const char* from_address = test_accounts[0].address;
     
-    char nonce[32] = {0};
-    err = eth_getTransactionCount(context, from_address, nonce, sizeof(nonce));
+    eth_address_t from;
+    eth_address_from_hex(from_address, from);
+    uint64_t nonce_value = 0;
+    uint256_t gas_price_value;
+    err = eth_rpc_get_nonce_and_gas_price(context, from, &nonce_value, &gas_price_value);
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "获取nonce失败: %s", esp_err_to_name(err));
+        ESP_LOGE(TAG, "获取nonce和gas价格失败: %s", esp_err_to_name(err));
         return;
     }
     
-    // 获取gas价格
-    char gas_price[64] = {0};
-    err = get_eth_gasPrice(context, gas_price, sizeof(gas_price));
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "获取gas价格失败: %s", esp_err_to_name(err));
-        return;
-    }
-    
-    // 提取十六进制gas价格
-    char gas_price_hex[32] = {0};
-    if (strncmp(gas_price, "0x", 2) == 0) {
-        char* end = strchr(gas_price, ' ');
-        if (!end) {
-            end = strchr(gas_price, '(');
-        }
-        
-        if (end) {
-            size_t hex_len = end - gas_price;
-            strncpy(gas_price_hex, gas_price, hex_len);
-            gas_price_hex[hex_len] = '\0';
-        } else {
-            strcpy(gas_price_hex, gas_price);
-        }
-    } else {
-        strcpy(gas_price_hex, "0x1");
-    }
+    char nonce[32];
+    snprintf(nonce, sizeof(nonce), "0x%llx", (unsigned long long)nonce_value);
+    char gas_price_hex[UINT256_HEX_BUF_LEN];
+    uint256_to_hex(&gas_price_value, gas_price_hex, sizeof(gas_price_hex));
     
     // 为合约交互设置更高的gas限制
     const char* gas = "0x100000"; // 为合约调用设置更高的gas限制
@@ -574,6 +962,7 @@ void test_device_challenge(web3_context_t* context) {
         .device_private_key = test_accounts[0].private_key,  // Use test account #0 as the device  // Removed 0x prefix
         .device_address = test_accounts[0].address,
         .device_id = 0,  // Device ID in the blockchain
+        .chain_id = 31337,  // Anvil local chain
         .poll_interval_ms = 30000  // Check every 30 seconds
     };
     
@@ -640,7 +1029,8 @@ void device_challenge_monitor_task(void *pvParameter) {
     web3_context_t context;
     
     // 使用静态字符串而非局部变量指针
-    const char* eth_url = "http://192.168.1.100:8545"; // RPC URL
+    // WebSocket连接上挑战事件由节点推送；Anvil/Hardhat在同一端口同时提供HTTP和WebSocket
+    const char* eth_url = "ws://192.168.1.100:8545"; // RPC URL
     ESP_LOGI(TAG, "设备挑战监听任务启动，初始化Web3...");
     esp_err_t err = web3_init(&context, eth_url);
     if (err != ESP_OK) {
@@ -656,6 +1046,7 @@ void device_challenge_monitor_task(void *pvParameter) {
         .device_private_key = input_config->device_private_key,
         .device_address = input_config->device_address,  
         .device_id = input_config->device_id,
+        .chain_id = input_config->chain_id,
         .poll_interval_ms = input_config->poll_interval_ms
     };
     
@@ -671,15 +1062,43 @@ void device_challenge_monitor_task(void *pvParameter) {
     ESP_LOGI(TAG, "开始持续监听链上挑战...");
     
     // 设置检查间隔
-    const int CHECK_INTERVAL_MS = 3000; // 每3秒检查一次
+    const int CHECK_INTERVAL_MS = 3000; // 无事件监听时每3秒检查一次
     int attempts = 0;
-    const int MAX_ATTEMPTS = 100; // 最多尝试100次，防止无限循环
+    const int MAX_ATTEMPTS = 100; // 最多调用100次hasChallenge，防止无限循环
+    
+    // 先安装挑战事件监听，再做第一次hasChallenge检查: 之前创建的挑战由检查发现，之后的由事件发现。
+    // 订阅模式下事件到达立即唤醒；轮询模式下空闲时每次只是一个eth_getFilterChanges，不执行合约，
+    // 日志不会丢失，可以使用配置的较长间隔。事件监听默认关闭 (FARMKEEPER_CHALLENGE_EVENTS)
+    esp_err_t watch_err = farmkeeper_device_watch_start();
+    bool watching = watch_err == ESP_OK;
+    int interval_ms = (watching && device_config.poll_interval_ms > 0) ? (int)device_config.poll_interval_ms
+                                                                      : CHECK_INTERVAL_MS;
+    if (!watching && watch_err != ESP_ERR_NOT_SUPPORTED) {
+        ESP_LOGW(TAG, "挑战事件监听启动失败，改为定时调用hasChallenge");
+    }
+    bool need_check = true;
+    int idle_waits = 0;
     
     // 主循环 - 持续检查并响应链上挑战，成功后自动退出
     while (attempts < MAX_ATTEMPTS) {
-        attempts++;
         bool has_challenge = false;
         
+        // 有新事件 (或未启用监听) 时才调用合约确认挑战状态；合约不发出事件时
+        // 每FARMKEEPER_CHALLENGE_BACKSTOP_WAITS次空闲等待后仍调用一次hasChallenge兜底
+        if (watching && !need_check) {
+            err = farmkeeper_device_watch_wait((uint32_t)interval_ms, &need_check);
+            if (err != ESP_OK) {
+                ESP_LOGW(TAG, "查询挑战事件失败: %s", esp_err_to_name(err));
+                need_check = true;
+            }
+            if (!need_check && ++idle_waits >= FARMKEEPER_CHALLENGE_BACKSTOP_WAITS) {
+                need_check = true;
+            }
+            continue;
+        }
+        idle_waits = 0;
+        attempts++;
+        
         // 检查是否有挑战
         err = farmkeeper_device_has_challenge(&has_challenge);
         if (err != ESP_OK) {
@@ -687,6 +1106,7 @@ void device_challenge_monitor_task(void *pvParameter) {
             vTaskDelay(pdMS_TO_TICKS(5000)); // 错误后等待5秒
             continue;
         }
+        need_check = has_challenge;  // 挑战处理失败时下一轮继续检查
         
         if (has_challenge) {
             ESP_LOGI(TAG, "检测到链上挑战，正在处理...");
@@ -723,12 +1143,15 @@ void device_challenge_monitor_task(void *pvParameter) {
             ESP_LOGI(TAG, "设备ID %d 无挑战，等待下次检查...", device_config.device_id);
         }
         
-        // 等待下次检查
-        vTaskDelay(pdMS_TO_TICKS(CHECK_INTERVAL_MS));
+        // 等待下次检查 (启用监听且无待处理挑战时由下一轮的事件查询等待)
+        if (!watching || need_check) {
+            vTaskDelay(pdMS_TO_TICKS(CHECK_INTERVAL_MS));
+        }
     }
     
     // 清理资源并退出
     ESP_LOGI(TAG, "设备挑战监听任务结束");
+    farmkeeper_device_watch_stop();
     web3_cleanup(&context);
     vTaskDelete(NULL);
 }
@@ -762,22 +1185,31 @@ void ethereum_test_task(void *pvParameter)
     }
     
     
-    /* 获取以太坊客户端版本 */
-    char client_version[128] = {0};
-    err = eth_get_client_version(&context, client_version, sizeof(client_version));
-    if (err == ESP_OK) {
-        ESP_LOGI(TAG, "以太坊客户端版本: %s", client_version);
-    } else {
-        ESP_LOGE(TAG, "获取客户端版本失败: %s", esp_err_to_name(err));
-    }
-
-    /* 获取网络ID */
-    char network_id[32] = {0};
-    err = eth_get_net_version(&context, network_id, sizeof(network_id));
-    if (err == ESP_OK) {
-        ESP_LOGI(TAG, "网络ID: %s", network_id);
-    } else {
-        ESP_LOGE(TAG, "获取网络ID失败: %s", esp_err_to_name(err));
+    /* 获取以太坊客户端版本和网络ID (合并为一次批量请求) */
+    char version_response[256] = {0};
+    char net_version_response[128] = {0};
+    web3_batch_entry_t boot_batch[2] = {
+        { .method = "web3_clientVersion", .params = NULL,
+          .result = version_response, .result_len = sizeof(version_response) },
+        { .method = "net_version", .params = NULL,
+          .result = net_version_response, .result_len = sizeof(net_version_response) },
+    };
+    web3_send_batch(&context, boot_batch, 2);
+    
+    for (size_t i = 0; i < 2; i++) {
+        if (boot_batch[i].err != ESP_OK) {
+            ESP_LOGE(TAG, "%s 请求失败: %s", boot_batch[i].method, esp_err_to_name(boot_batch[i].err));
+            continue;
+        }
+        
+        cJSON *json = cJSON_Parse(boot_batch[i].result);
+        cJSON *result_obj = json ? cJSON_GetObjectItem(json, "result") : NULL;
+        if (result_obj && cJSON_IsString(result_obj)) {
+            ESP_LOGI(TAG, "%s: %s", i == 0 ? "以太坊客户端版本" : "网络ID", result_obj->valuestring);
+        } else {
+            ESP_LOGE(TAG, "%s 响应解析失败", boot_batch[i].method);
+        }
+        cJSON_Delete(json);
     }
     
     // /* 测试交易签名功能 */
@@ -788,6 +1220,14 @@ void ethereum_test_task(void *pvParameter)
     
     // /* 测试ABI编码 */
     // test_abi_encoding(&context);
+    
+    // /* 测试本地Keccak256性能 */
+    // test_keccak_benchmark();
+    // test_sign_benchmark();
+    // test_json_benchmark();
+    // test_hex_benchmark();
+    // test_units_benchmark();
+    // test_transport_mock_benchmark();
 
     // /* 增加延迟，避免连续的RPC调用可能导致的内存或同步问题 */
     // vTaskDelay(pdMS_TO_TICKS(500));
@@ -798,12 +1238,26 @@ void ethereum_test_task(void *pvParameter)
     /* 增加延迟 */
     vTaskDelay(pdMS_TO_TICKS(500));
     
+    // /* 测试Multicall3批量读取 */
+    // test_multicall_reads(&context);
+    
     // /* 测试调用addFarm合约方法 */
     // test_add_farm(&context);
     
     // /* 测试设备挑战功能 */
     // test_device_challenge(&context);
     
+    /* 请求体写入统计 */
+    web3_request_stats_t request_stats;
+    if (web3_get_request_stats(&request_stats) == ESP_OK) {
+        ESP_LOGI(TAG, "请求体: %lu 个, 堆分配 %lu 次, 共 %llu 字节",
+                 (unsigned long)request_stats.requests, (unsigned long)request_stats.heap_allocations,
+                 (unsigned long long)request_stats.bytes_written);
+        ESP_LOGI(TAG, "连接: 新建 %lu 次, 复用 %lu 次, 空闲重连 %lu 次, 失效重发 %lu 次",
+                 (unsigned long)request_stats.connections_opened, (unsigned long)request_stats.connections_reused,
+                 (unsigned long)request_stats.idle_reconnects, (unsigned long)request_stats.stale_replays);
+    }
+    
     /* 清理web3上下文 */
     web3_cleanup(&context);
     vTaskDelete(NULL);
@@ -819,6 +1273,11 @@ void app_main(void)
     }
     ESP_ERROR_CHECK(ret);
     
+    /* 索引嵌入的FarmKeeper ABI */
+    if (farmkeeper_abi_init() != ESP_OK) {
+        ESP_LOGW(TAG, "FarmKeeper ABI索引失败，依赖ABI的测试将跳过");
+    }
+    
     /* 初始化WiFi */
     wifi_init_sta();
     
@@ -829,7 +1288,8 @@ void app_main(void)
         .device_private_key = "2a871d0798f97d79848a013d4936a73bf4cc922c825d33c1cf7073dff6d409c6", 
         .device_address = "0xa0Ee7A142d267C1f36714E4a8F75612F20a79720", 
         .device_id = 0,
-        .poll_interval_ms = 3000
+        .chain_id = 31337,  // Anvil本地链
+        .poll_interval_ms = 30000  // 启用FARMKEEPER_CHALLENGE_EVENTS时挑战事件的查询间隔，事件由节点保存，间隔长也不会漏掉
     };
     
     // Create a higher-priority task for device monitoring to ensure it gets CPU time
@@ -0,0 +1,606 @@
+#!/usr/bin/env python3
+"""
+ABI绑定生成器
+
+读取合约ABI JSON (ABI数组本身，或者含"abi"字段的Hardhat/Foundry编译产物)，
+为每个函数生成类型化的C编码/解码函数，为每个事件生成topic0常量:
+
+    esp_err_t <prefix>_encode_<name>(<参数>, uint8_t* out, size_t out_len, size_t* written);
+    esp_err_t <prefix>_decode_<name>(const uint8_t* data, size_t data_len, <返回值指针>);
+    #define <PREFIX>_<EVENT>_TOPIC { 0x.., ... }   // eth_hash_t初始化列表，用于日志过滤
+
+函数选择器在生成时计算为常量，运行时不再计算签名哈希，也不拼接签名字符串。
+生成结果只依赖eth_abi的 abi_encode_call_with_selector 和 abi_decode。返回值全是单字类型
+(uintN/intN≤64/bool/address/bytesN) 时解码函数直接按字读取并做与abi_decode相同的填充检查，
+不在每次调用时解析类型串；含动态/复合类型或int>64视图时才调用abi_decode。
+
+用法: abigen.py <abi.json> <prefix> <out_dir>
+输出: <out_dir>/<prefix>_contract.h 和 <out_dir>/<prefix>_contract.c
+"""
+
+import json
+import os
+import re
+import sys
+
+# ---------------------------------------------------------------------------
+# Keccak-256 (以太坊使用的原始Keccak，不同于hashlib.sha3_256的FIPS-202填充)
+
+_RC = [
+    0x0000000000000001, 0x0000000000008082, 0x800000000000808A, 0x8000000080008000,
+    0x000000000000808B, 0x0000000080000001, 0x8000000080008081, 0x8000000000008009,
+    0x000000000000008A, 0x0000000000000088, 0x0000000080008009, 0x000000008000000A,
+    0x000000008000808B, 0x800000000000008B, 0x8000000000008089, 0x8000000000008003,
+    0x8000000000008002, 0x8000000000000080, 0x000000000000800A, 0x800000008000000A,
+    0x8000000080008081, 0x8000000000008080, 0x0000000080000001, 0x8000000080008008,
+]
+_ROT = [
+    [0, 36, 3, 41, 18],
+    [1, 44, 10, 45, 2],
+    [62, 6, 43, 15, 61],
+    [28, 55, 25, 21, 56],
+    [27, 20, 39, 8, 14],
+]
+_MASK = (1 << 64) - 1
+
+
+def _rol(v, n):
+    return ((v << n) | (v >> (64 - n))) & _MASK if n else v
+
+
+def _keccak_f(a):
+    for rc in _RC:
+        c = [a[x][0] ^ a[x][1] ^ a[x][2] ^ a[x][3] ^ a[x][4] for x in range(5)]
+        d = [c[(x - 1) % 5] ^ _rol(c[(x + 1) % 5], 1) for x in range(5)]
+        a = [[a[x][y] ^ d[x] for y in range(5)] for x in range(5)]
+        b = [[0] * 5 for _ in range(5)]
+        for x in range(5):
+            for y in range(5):
+                b[y][(2 * x + 3 * y) % 5] = _rol(a[x][y], _ROT[x][y])
+        a = [[b[x][y] ^ (~b[(x + 1) % 5][y] & b[(x + 2) % 5][y]) for y in range(5)] for x in range(5)]
+        a[0][0] ^= rc
+    return a
+
+
+def keccak256(data):
+    rate = 136
+    msg = bytearray(data) + b"\x01"
+    msg += b"\x00" * (-len(msg) % rate)
+    msg[-1] |= 0x80
+    a = [[0] * 5 for _ in range(5)]
+    for off in range(0, len(msg), rate):
+        block = msg[off:off + rate]
+        for i in range(rate // 8):
+            a[i % 5][i // 5] ^= int.from_bytes(block[8 * i:8 * i + 8], "little")
+        a = _keccak_f(a)
+    out = b"".join(a[i % 5][i // 5].to_bytes(8, "little") for i in range(4))
+    return out
+
+
+# ---------------------------------------------------------------------------
+# ABI类型
+
+_C_KEYWORDS = {
+    "auto", "break", "case", "char", "const", "continue", "default", "do", "double", "else", "enum",
+    "extern", "float", "for", "goto", "if", "inline", "int", "long", "register", "restrict", "return",
+    "short", "signed", "sizeof", "static", "struct", "switch", "typedef", "union", "unsigned", "void",
+    "volatile", "while", "bool", "true", "false",
+}
+# 生成函数自身使用的参数名
+_RESERVED = {"out", "out_len", "written", "data", "data_len", "params", "err", "returns", "value"}
+
+
+def canonical_type(param):
+    """展开tuple后的规范类型，如 (uint256,uint256)[]"""
+    t = param["type"]
+    if t.startswith("tuple"):
+        inner = ",".join(canonical_type(c) for c in param.get("components", []))
+        return "(" + inner + ")" + t[5:]
+    return t
+
+
+def snake_case(name):
+    s = re.sub(r"([a-z0-9])([A-Z])", r"\1_\2", name)
+    s = re.sub(r"([A-Z]+)([A-Z][a-z])", r"\1_\2", s)
+    return s.strip("_").lower()
+
+
+def c_names(params, fallback):
+    """为参数生成不冲突的C标识符"""
+    names = []
+    for i, p in enumerate(params):
+        n = snake_case(p.get("name") or "")
+        if not n:
+            n = fallback if len(params) == 1 else "%s%d" % (fallback, i)
+        if n in _C_KEYWORDS or n in _RESERVED:
+            n += "_arg"
+        while n in names:
+            n += "_"
+        names.append(n)
+    return names
+
+
+class Scalar:
+    """顶层参数/返回值的C表示"""
+
+    def __init__(self, abi_type):
+        self.type = abi_type
+        m = re.fullmatch(r"(u?int)(\d*)", abi_type)
+        self.kind = None
+        self.bits = 0
+        if abi_type.endswith("]") or abi_type.startswith("("):
+            self.kind = "composite"
+        elif m:
+            self.kind = m.group(1)
+            self.bits = int(m.group(2) or 256)
+        elif abi_type in ("address", "bool", "string", "bytes"):
+            self.kind = abi_type
+        elif re.fullmatch(r"bytes\d+", abi_type):
+            self.kind = "bytesN"
+            self.bits = int(abi_type[5:]) * 8
+        else:
+            raise ValueError("unsupported ABI type: " + abi_type)
+
+
+def input_decl(s, n):
+    if s.kind == "uint":
+        return ["uint64_t %s" % n] if s.bits <= 64 else ["const uint256_t* %s" % n]
+    if s.kind == "int":
+        return ["int64_t %s" % n] if s.bits <= 64 else ["const uint8_t %s[32]" % n]
+    if s.kind == "address":
+        return ["const eth_address_t %s" % n]
+    if s.kind == "bool":
+        return ["bool %s" % n]
+    if s.kind == "bytesN":
+        return ["const uint8_t %s[%d]" % (n, s.bits // 8)]
+    if s.kind == "bytes":
+        return ["const uint8_t* %s" % n, "size_t %s_len" % n]
+    if s.kind == "string":
+        return ["const char* %s" % n]
+    return ["const abi_param_t* %s" % n]
+
+
+def input_doc(s, n):
+    if s.kind == "int" and s.bits > 64:
+        return "%s %s (32字节大端补码)" % (n, s.type)
+    if s.kind == "composite":
+        return "%s %s (用ABI_TUPLE/ABI_ARRAY构造)" % (n, s.type)
+    return "%s %s" % (n, s.type)
+
+
+def input_encode(s, n):
+    """返回 (准备语句, abi_param_t初始化器)"""
+    prep = []
+    if s.kind == "uint" and s.bits <= 64:
+        if s.bits < 64:
+            prep.append("if (%s >> %d) {" % (n, s.bits))
+            prep.append("    return ESP_ERR_INVALID_ARG;")
+            prep.append("}")
+        prep.append("uint8_t %s_be[8];" % n)
+        prep.append("abigen_put_u64(%s_be, %s);" % (n, n))
+        return prep, "ABI_UINT(64, %s_be)" % n
+    if s.kind == "uint":
+        if s.bits < 256:
+            prep.append("if (uint256_bit_length(%s) > %d) {" % (n, s.bits))
+            prep.append("    return ESP_ERR_INVALID_ARG;")
+            prep.append("}")
+        prep.append("uint8_t %s_be[32];" % n)
+        prep.append("uint256_to_be_bytes(%s, %s_be);" % (n, n))
+        return prep, "ABI_UINT(256, %s_be)" % n
+    if s.kind == "int" and s.bits <= 64:
+        if s.bits < 64:
+            lim = 1 << (s.bits - 1)
+            prep.append("if (%s < -%dLL || %s > %dLL) {" % (n, lim, n, lim - 1))
+            prep.append("    return ESP_ERR_INVALID_ARG;")
+            prep.append("}")
+        prep.append("uint8_t %s_be[8];" % n)
+        prep.append("abigen_put_u64(%s_be, (uint64_t)%s);" % (n, n))
+        return prep, "ABI_INT(64, %s_be)" % n
+    if s.kind == "int":
+        return prep, "ABI_INT(256, %s)" % n
+    if s.kind == "address":
+        return prep, "ABI_ADDRESS(%s)" % n
+    if s.kind == "bool":
+        return prep, "ABI_BOOL(&%s)" % n
+    if s.kind == "bytesN":
+        return prep, "ABI_BYTES_FIXED(%s, %d)" % (n, s.bits // 8)
+    if s.kind == "bytes":
+        return prep, "ABI_BYTES(%s, %s_len)" % (n, n)
+    if s.kind == "string":
+        return prep, "ABI_STRING(%s)" % n
+    return prep, "*%s" % n
+
+
+def input_null_checks(s, n):
+    if s.kind in ("address", "bytesN", "string", "composite") or (s.kind in ("uint", "int") and s.bits > 64):
+        return [n]
+    if s.kind == "bytes":
+        return ["(%s || %s_len == 0)" % (n, n)]
+    return []
+
+
+def output_decl(s, n):
+    if s.kind == "uint":
+        return ["uint64_t* %s" % n] if s.bits <= 64 else ["uint256_t* %s" % n]
+    if s.kind == "int" and s.bits <= 64:
+        return ["int64_t* %s" % n]
+    if s.kind == "address":
+        return ["eth_address_t %s" % n]
+    if s.kind == "bool":
+        return ["bool* %s" % n]
+    if s.kind == "bytesN":
+        return ["uint8_t %s[%d]" % (n, s.bits // 8)]
+    if s.kind == "bytes":
+        return ["const uint8_t** %s" % n, "size_t* %s_len" % n]
+    if s.kind == "string":
+        return ["const char** %s" % n, "size_t* %s_len" % n]
+    return ["abi_value_t* %s" % n]
+
+
+def output_doc(s, n):
+    if s.kind in ("bytes", "string"):
+        return "%s %s (指向data的视图，不以'\\0'结尾)" % (n, s.type)
+    if s.kind == "composite" or (s.kind == "int" and s.bits > 64):
+        return "%s %s (值视图，用abi_value_at等读取)" % (n, s.type)
+    return "%s %s" % (n, s.type)
+
+
+def output_read(s, n):
+    """从abi_value_t value读取到输出参数的语句"""
+    if s.kind == "uint" and s.bits <= 64:
+        return ["err = abi_value_to_u64(&value, %s);" % n]
+    if s.kind == "uint":
+        return ["err = abi_value_to_uint256(&value, %s);" % n]
+    if s.kind == "int" and s.bits <= 64:
+        return ["err = abi_value_to_i64(&value, %s);" % n]
+    if s.kind == "bool":
+        return ["err = abi_value_to_bool(&value, %s);" % n]
+    if s.kind == "address":
+        return ["memcpy(%s, value.data, ETH_ADDRESS_LEN);" % n]
+    if s.kind == "bytesN":
+        return ["memcpy(%s, value.data, %d);" % (n, s.bits // 8)]
+    if s.kind == "bytes":
+        return ["*%s = value.data;" % n, "*%s_len = value.length;" % n]
+    if s.kind == "string":
+        return ["*%s = (const char*)value.data;" % n, "*%s_len = value.length;" % n]
+    return ["*%s = value;" % n]
+
+
+def is_word_output(s):
+    """返回值占一个字且能直接读到输出参数 (无需abi_value_t视图)"""
+    return s.kind in ("uint", "bool", "address", "bytesN") or (s.kind == "int" and s.bits <= 64)
+
+
+def output_word_read(s, n, off):
+    """从data + off处的一个字直接读取输出参数，填充检查与abi_decode相同"""
+    word = "data + %d" % off if off else "data"
+    if s.kind == "bool":
+        return ["if (!abigen_all_bytes(%s, 31, 0x00) || data[%d] > 1) {" % (word, off + 31),
+                "    return ESP_ERR_INVALID_RESPONSE;",
+                "}",
+                "*%s = data[%d] != 0;" % (n, off + 31)]
+    if s.kind == "address":
+        return ["if (!abigen_all_bytes(%s, 12, 0x00)) {" % word,
+                "    return ESP_ERR_INVALID_RESPONSE;",
+                "}",
+                "memcpy(%s, data + %d, ETH_ADDRESS_LEN);" % (n, off + 12)]
+    if s.kind == "bytesN":
+        k = s.bits // 8
+        lines = []
+        if k < 32:
+            lines += ["if (!abigen_all_bytes(data + %d, %d, 0x00)) {" % (off + k, 32 - k),
+                      "    return ESP_ERR_INVALID_RESPONSE;",
+                      "}"]
+        return lines + ["memcpy(%s, %s, %d);" % (n, word, k)]
+    pad = 32 - s.bits // 8
+    lines = []
+    if pad:
+        fill = "(data[%d] & 0x80) ? 0xFF : 0x00" % (off + pad) if s.kind == "int" else "0x00"
+        lines += ["if (!abigen_all_bytes(%s, %d, %s)) {" % (word, pad, fill),
+                  "    return ESP_ERR_INVALID_RESPONSE;",
+                  "}"]
+    if s.kind == "int":
+        return lines + ["*%s = (int64_t)abigen_get_u64(data + %d);" % (n, off + 24)]
+    if s.bits <= 64:
+        return lines + ["*%s = abigen_get_u64(data + %d);" % (n, off + 24)]
+    return lines + ["err = uint256_from_be_bytes(%s, 32, %s);" % (word, n)]
+
+
+# ---------------------------------------------------------------------------
+# 代码生成
+
+def load_abi(path):
+    with open(path, encoding="utf-8") as f:
+        doc = json.load(f)
+    return doc["abi"] if isinstance(doc, dict) else doc
+
+
+def load_functions(abi):
+    functions = [e for e in abi if e.get("type") == "function"]
+
+    # 重载函数按ABI中的顺序加序号后缀
+    counts = {}
+    for fn in functions:
+        counts[fn["name"]] = counts.get(fn["name"], 0) + 1
+    seen = {}
+    for fn in functions:
+        base = snake_case(fn["name"])
+        if counts[fn["name"]] > 1:
+            seen[fn["name"]] = seen.get(fn["name"], 0) + 1
+            base += "_%d" % seen[fn["name"]]
+        fn["c_name"] = base
+        fn["signature"] = fn["name"] + "(" + ",".join(canonical_type(p) for p in fn.get("inputs", [])) + ")"
+        fn["outputs_type"] = "(" + ",".join(canonical_type(p) for p in fn.get("outputs", [])) + ")"
+        fn["selector"] = keccak256(fn["signature"].encode())[:4]
+    return functions
+
+
+def load_events(abi):
+    events = [e for e in abi if e.get("type") == "event"]
+    for ev in events:
+        inputs = ev.get("inputs", [])
+        ev["c_name"] = snake_case(ev["name"])
+        ev["signature"] = ev["name"] + "(" + ",".join(canonical_type(p) for p in inputs) + ")"
+        ev["data_type"] = "(" + ",".join(canonical_type(p) for p in inputs if not p.get("indexed")) + ")"
+        ev["indexed"] = [canonical_type(p) for p in inputs if p.get("indexed")]
+        ev["topic"] = keccak256(ev["signature"].encode())
+    return events
+
+
+def wrap_params(head, args, indent):
+    """参数过多时按repo风格换行对齐"""
+    line = head + ", ".join(args) + ")"
+    if len(line) <= 110:
+        return [line]
+    lines = [head + args[0] + ","]
+    pad = " " * (len(head) + indent)
+    for i, a in enumerate(args[1:]):
+        lines.append(pad + a + ("," if i < len(args) - 2 else ")"))
+    return lines
+
+
+def gen_header(functions, events, prefix, source_name):
+    guard = prefix.upper() + "_CONTRACT_H"
+    P = prefix.upper()
+    out = []
+    out.append("/*")
+    out.append("    由 tools/abigen.py 从 %s 生成，不要手动修改" % source_name)
+    out.append("")
+    out.append("    每个函数的选择器都是常量，编码时不计算签名哈希。编码函数在out不足时")
+    out.append("    返回ESP_ERR_INVALID_SIZE；解码函数返回与abi_decode相同的错误码，")
+    out.append("    bytes/string/复合类型的结果是指向data的视图，data需在使用期间保持有效。")
+    out.append("")
+    out.append("*/")
+    out.append("")
+    out.append("#ifndef " + guard)
+    out.append("#define " + guard)
+    out.append("")
+    out.append("#include <stdint.h>")
+    out.append("#include <stddef.h>")
+    out.append("#include <stdbool.h>")
+    out.append("#include <esp_err.h>")
+    out.append('#include "eth_abi.h"')
+    out.append('#include "eth_types.h"')
+    out.append('#include "eth_uint256.h"')
+    out.append("")
+
+    for fn in functions:
+        FN = P + "_" + fn["c_name"].upper()
+        sel = fn["selector"]
+        out.append("// %s -> %s" % (fn["signature"], fn["outputs_type"]))
+        out.append('#define %s_SIGNATURE "%s"' % (FN, fn["signature"]))
+        out.append('#define %s_OUTPUTS "%s"' % (FN, fn["outputs_type"]))
+        out.append("#define %s_SELECTOR 0x%sU" % (FN, sel.hex()))
+        out.append("")
+
+    # 事件: topic0作为eth_hash_t的初始化列表，DATA为非indexed参数的类型 (日志data的解码类型)
+    for ev in events:
+        EV = P + "_" + ev["c_name"].upper()
+        topic = ", ".join("0x%02x" % b for b in ev["topic"])
+        out.append("// event %s, indexed: %s" % (ev["signature"], ", ".join(ev["indexed"]) or "-"))
+        out.append('#define %s_EVENT_SIGNATURE "%s"' % (EV, ev["signature"]))
+        out.append('#define %s_EVENT_DATA "%s"' % (EV, ev["data_type"]))
+        out.append("#define %s_TOPIC { %s }" % (EV, topic))
+        out.append("")
+
+    for fn in functions:
+        inputs = fn.get("inputs", [])
+        in_names = c_names(inputs, "arg")
+        in_scalars = [Scalar(canonical_type(p)) for p in inputs]
+        out.append("/**")
+        out.append(" * @brief 编码 %s 调用数据" % fn["signature"])
+        if inputs:
+            out.append(" *")
+        for s, n in zip(in_scalars, in_names):
+            out.append(" * @param %s" % input_doc(s, n))
+        out.append(" */")
+        args = [d for s, n in zip(in_scalars, in_names) for d in input_decl(s, n)]
+        args += ["uint8_t* out", "size_t out_len", "size_t* written"]
+        lines = wrap_params("esp_err_t %s_encode_%s(" % (prefix, fn["c_name"]), args, 0)
+        lines[-1] += ";"
+        out.extend(lines)
+        out.append("")
+
+        outputs = fn.get("outputs", [])
+        if not outputs:
+            continue
+        out_names = c_names(outputs, "result")
+        out_scalars = [Scalar(canonical_type(p)) for p in outputs]
+        out.append("/**")
+        out.append(" * @brief 解码 %s 的返回值 %s" % (fn["name"], fn["outputs_type"]))
+        out.append(" *")
+        for s, n in zip(out_scalars, out_names):
+            out.append(" * @param %s" % output_doc(s, n))
+        out.append(" */")
+        args = ["const uint8_t* data", "size_t data_len"]
+        args += [d for s, n in zip(out_scalars, out_names) for d in output_decl(s, n)]
+        lines = wrap_params("esp_err_t %s_decode_%s(" % (prefix, fn["c_name"]), args, 0)
+        lines[-1] += ";"
+        out.extend(lines)
+        out.append("")
+
+    out.append("#endif /* %s */" % guard)
+    out.append("")
+    return "\n".join(out)
+
+
+def gen_source(functions, prefix, source_name):
+    P = prefix.upper()
+    out = []
+    out.append("// 由 tools/abigen.py 从 %s 生成，不要手动修改" % source_name)
+    out.append("")
+    out.append('#include "%s_contract.h"' % prefix)
+    out.append("#include <string.h>")
+    small_ints = any(Scalar(canonical_type(p)).kind in ("uint", "int") and Scalar(canonical_type(p)).bits <= 64
+                     for fn in functions for p in fn.get("inputs", []))
+    if small_ints:
+        out.append("")
+        out.append("static inline void abigen_put_u64(uint8_t out[8], uint64_t v) {")
+        out.append("    for (int i = 7; i >= 0; i--, v >>= 8) {")
+        out.append("        out[i] = (uint8_t)v;")
+        out.append("    }")
+        out.append("}")
+    word_outputs = [[Scalar(canonical_type(p)) for p in fn.get("outputs", [])] for fn in functions]
+    word_outputs = [o for o in word_outputs if o and all(is_word_output(s) for s in o)]
+    if word_outputs:
+        out.append("")
+        out.append("static inline bool abigen_all_bytes(const uint8_t* p, size_t n, uint8_t fill) {")
+        out.append("    for (size_t i = 0; i < n; i++) {")
+        out.append("        if (p[i] != fill) {")
+        out.append("            return false;")
+        out.append("        }")
+        out.append("    }")
+        out.append("    return true;")
+        out.append("}")
+    if any(s.kind in ("uint", "int") and s.bits <= 64 for o in word_outputs for s in o):
+        out.append("")
+        out.append("static inline uint64_t abigen_get_u64(const uint8_t in[8]) {")
+        out.append("    uint64_t v = 0;")
+        out.append("    for (int i = 0; i < 8; i++) {")
+        out.append("        v = (v << 8) | in[i];")
+        out.append("    }")
+        out.append("    return v;")
+        out.append("}")
+
+    for fn in functions:
+        FN = P + "_" + fn["c_name"].upper()
+        inputs = fn.get("inputs", [])
+        in_names = c_names(inputs, "arg")
+        in_scalars = [Scalar(canonical_type(p)) for p in inputs]
+
+        args = [d for s, n in zip(in_scalars, in_names) for d in input_decl(s, n)]
+        args += ["uint8_t* out", "size_t out_len", "size_t* written"]
+        out.append("")
+        lines = wrap_params("esp_err_t %s_encode_%s(" % (prefix, fn["c_name"]), args, 0)
+        lines[-1] += " {"
+        out.extend(lines)
+        checks = ["out", "written"] + [c for s, n in zip(in_scalars, in_names) for c in input_null_checks(s, n)]
+        out.append("    if (%s) {" % " || ".join("!" + c for c in checks))
+        out.append("        return ESP_ERR_INVALID_ARG;")
+        out.append("    }")
+        out.append("")
+        inits = []
+        for s, n in zip(in_scalars, in_names):
+            prep, init = input_encode(s, n)
+            out.extend("    " + l for l in prep)
+            inits.append(init)
+        if inits:
+            out.append("")
+        out.append("    static const uint8_t selector[4] = { %s };" % ", ".join("0x%02x" % b for b in fn["selector"]))
+        if inits:
+            out.append("    const abi_param_t params[%d] = {" % len(inits))
+            out.extend("        %s," % i for i in inits)
+            out.append("    };")
+            out.append("    return abi_encode_call_with_selector(selector, params, %d, out, out_len, written);" % len(inits))
+        else:
+            out.append("    return abi_encode_call_with_selector(selector, NULL, 0, out, out_len, written);")
+        out.append("}")
+
+        outputs = fn.get("outputs", [])
+        if not outputs:
+            continue
+        out_names = c_names(outputs, "result")
+        out_scalars = [Scalar(canonical_type(p)) for p in outputs]
+        args = ["const uint8_t* data", "size_t data_len"]
+        args += [d for s, n in zip(out_scalars, out_names) for d in output_decl(s, n)]
+        out.append("")
+        lines = wrap_params("esp_err_t %s_decode_%s(" % (prefix, fn["c_name"]), args, 0)
+        lines[-1] += " {"
+        out.extend(lines)
+        checks = ["data"] + [d.split()[-1].split("[")[0] for s, n in zip(out_scalars, out_names) for d in output_decl(s, n)]
+        out.append("    if (%s) {" % " || ".join("!" + c for c in checks))
+        out.append("        return ESP_ERR_INVALID_ARG;")
+        out.append("    }")
+        out.append("")
+        if all(is_word_output(s) for s in out_scalars):
+            # 全是单字返回值：头部就是全部编码，直接读字，不在每次调用时解析类型串
+            if any(s.kind == "uint" and s.bits > 64 for s in out_scalars[:-1]):
+                out.append("    esp_err_t err;")
+            out.append("    if (data_len < %d) {" % (32 * len(outputs)))
+            out.append("        return ESP_ERR_INVALID_SIZE;")
+            out.append("    }")
+            for i, (s, n) in enumerate(zip(out_scalars, out_names)):
+                reads = output_word_read(s, n, 32 * i)
+                last = i == len(outputs) - 1
+                if reads[-1].startswith("err =") and last:
+                    reads[-1] = "return " + reads[-1][len("err = "):]
+                out.extend("    " + l for l in reads)
+                if reads[-1].startswith("err ="):
+                    out.append("    if (err != ESP_OK) {")
+                    out.append("        return err;")
+                    out.append("    }")
+                if last and not reads[-1].startswith("return"):
+                    out.append("    return ESP_OK;")
+            out.append("}")
+            continue
+        out.append("    abi_value_t returns, value;")
+        out.append("    esp_err_t err = abi_decode(%s_OUTPUTS, data, data_len, &returns);" % FN)
+        out.append("    if (err != ESP_OK) {")
+        out.append("        return err;")
+        out.append("    }")
+        for i, (s, n) in enumerate(zip(out_scalars, out_names)):
+            out.append("")
+            out.append("    if ((err = abi_value_at(&returns, %d, &value)) != ESP_OK) {" % i)
+            out.append("        return err;")
+            out.append("    }")
+            reads = output_read(s, n)
+            last = i == len(outputs) - 1
+            if reads[0].startswith("err =") and last:
+                out.append("    return " + reads[0][len("err = "):])
+                continue
+            out.extend("    " + l for l in reads)
+            if reads[0].startswith("err ="):
+                out.append("    if (err != ESP_OK) {")
+                out.append("        return err;")
+                out.append("    }")
+            if last:
+                out.append("    return ESP_OK;")
+        out.append("}")
+
+    out.append("")
+    return "\n".join(out)
+
+
+def main(argv):
+    if len(argv) != 4:
+        sys.stderr.write("usage: abigen.py <abi.json> <prefix> <out_dir>\n")
+        return 2
+    path, prefix, out_dir = argv[1], argv[2], argv[3]
+    abi = load_abi(path)
+    functions = load_functions(abi)
+    events = load_events(abi)
+    source_name = os.path.basename(path)
+
+    os.makedirs(out_dir, exist_ok=True)
+    files = {
+        prefix + "_contract.h": gen_header(functions, events, prefix, source_name),
+        prefix + "_contract.c": gen_source(functions, prefix, source_name),
+    }
+    for name, text in files.items():
+        with open(os.path.join(out_dir, name), "w", encoding="utf-8") as f:
+            f.write(text)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
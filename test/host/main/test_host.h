@@ -0,0 +1,21 @@
+#ifndef TEST_HOST_H
+#define TEST_HOST_H
+
+#include <stdbool.h>
+
+// standin.py的地址，未运行时依赖它的用例被跳过
+#define STANDIN_HOST "127.0.0.1"
+#define STANDIN_HTTP_PORT 18545
+#define STANDIN_HTTP_URL "http://" STANDIN_HOST ":18545"
+#define STANDIN_WS_PORT 18546
+#define STANDIN_WS_URL "ws://" STANDIN_HOST ":18546"
+
+/**
+ * @brief 检查standin.py是否在port上监听
+ */
+bool standin_available(int port);
+
+void test_transport_run(void);
+void test_ws_run(void);
+
+#endif /* TEST_HOST_H */
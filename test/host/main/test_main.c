@@ -0,0 +1,40 @@
+/*
+    ethereum-lib主机测试 (ESP-IDF Linux目标)
+
+    cd test/host
+    idf.py --preview set-target linux build
+    python3 standin.py &
+    ./build/ethereum-lib-host-test.elf
+*/
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "unity.h"
+#include "test_host.h"
+
+bool standin_available(int port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+    };
+    inet_pton(AF_INET, STANDIN_HOST, &addr.sin_addr);
+    bool ok = connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0;
+    close(fd);
+    return ok;
+}
+
+void app_main(void)
+{
+    UNITY_BEGIN();
+    test_transport_run();
+    test_ws_run();
+    exit(UNITY_END());
+}
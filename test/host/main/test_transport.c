@@ -0,0 +1,214 @@
+// 传输后端: 进程内mock和原始socket HTTP/1.1 (对standin.py)
+
+#include <stdio.h>
+#include <string.h>
+#include "unity.h"
+#include "web3.h"
+#include "web3_transport.h"
+#include "eth_rpc.h"
+#include "eth_tx.h"
+#include "eth_types.h"
+#include "test_host.h"
+
+#define STANDIN_URL(path) STANDIN_HTTP_URL path
+
+static const char *ADDRESS = "0x5FbDB2315678afecb367f032d93F642f64180aa3";
+static const uint64_t ONE_ETH = 0xde0b6b3a7640000ULL;
+
+typedef struct {
+    int calls;
+    char last_body[512];
+    esp_err_t result;
+} mock_state_t;
+
+// 按请求的方法回复: 余额1 ETH，交易返回固定哈希
+static esp_err_t mock_handler(void *user_ctx, const char *body, size_t body_len, web3_response_sink_t *sink)
+{
+    static const char balance[] = "{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":\"0xde0b6b3a7640000\"}";
+    static const char tx_hash[] = "{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":"
+                                  "\"0x1111111111111111111111111111111111111111111111111111111111111111\"}";
+    mock_state_t *state = user_ctx;
+    state->calls++;
+    snprintf(state->last_body, sizeof(state->last_body), "%.*s", (int)body_len, body);
+    if (state->result != ESP_OK) {
+        return state->result;
+    }
+    if (strstr(state->last_body, "eth_sendRawTransaction")) {
+        return web3_sink_write(sink, tx_hash, sizeof(tx_hash) - 1);
+    }
+    return web3_sink_write(sink, balance, sizeof(balance) - 1);
+}
+
+static void init_mock(web3_context_t *context, mock_state_t *state)
+{
+    web3_transport_t *transport = NULL;
+    TEST_ASSERT_EQUAL(ESP_OK, web3_transport_mock_create(mock_handler, state, &transport));
+    TEST_ASSERT_EQUAL(ESP_OK, web3_init_with_transport(context, "mock://", transport));
+    TEST_ASSERT_EQUAL_STRING("mock", context->transport->ops->name);
+}
+
+static void test_mock_backend_serves_rpc(void)
+{
+    mock_state_t state = {0};
+    web3_context_t context;
+    init_mock(&context, &state);
+
+    eth_address_t address;
+    uint256_t balance;
+    eth_address_from_hex(ADDRESS, address);
+    TEST_ASSERT_EQUAL(ESP_OK, eth_rpc_get_balance(&context, address, &balance));
+    TEST_ASSERT_EQUAL_UINT64(ONE_ETH, balance.limbs[0]);
+    TEST_ASSERT_EQUAL(1, state.calls);
+    TEST_ASSERT_NOT_NULL(strstr(state.last_body, "\"method\":\"eth_getBalance\""));
+
+    web3_cleanup(&context);
+}
+
+static void test_mock_backend_error_is_returned(void)
+{
+    mock_state_t state = { .result = ESP_ERR_TIMEOUT };
+    web3_context_t context;
+    init_mock(&context, &state);
+
+    eth_address_t address;
+    uint256_t balance;
+    eth_address_from_hex(ADDRESS, address);
+    TEST_ASSERT_EQUAL(ESP_ERR_TIMEOUT, eth_rpc_get_balance(&context, address, &balance));
+
+    web3_cleanup(&context);
+}
+
+// EIP-155的示例交易: 本地签名后经mock后端发送
+static void test_mock_backend_signs_and_sends(void)
+{
+    static const char *expected_raw =
+        "0xf86c098504a817c800825208943535353535353535353535353535353535353535880de0b6b3a7640000"
+        "8025a028ef61340bd939bc2195fe537567866003e1a15d3c71ff63e1590620aa636276a067cbe9d8997f761a"
+        "ecb703304b3800ccf555c9f3dc64214b297fb1966a3b6d83";
+    uint8_t to[20];
+    memset(to, 0x35, sizeof(to));
+    const uint8_t value[] = { 0x0d, 0xe0, 0xb6, 0xb3, 0xa7, 0x64, 0x00, 0x00 };
+    eth_legacy_tx_t tx = {
+        .nonce = 9,
+        .gas_price = 20000000000ULL,
+        .gas_limit = 21000,
+        .to = to,
+        .value = value,
+        .value_len = sizeof(value),
+        .chain_id = 1,
+    };
+    uint8_t raw_tx[256];
+    size_t raw_len = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, eth_tx_sign_legacy(&tx, "4646464646464646464646464646464646464646464646464646464646464646",
+                                                 raw_tx, sizeof(raw_tx), &raw_len));
+
+    mock_state_t state = {0};
+    web3_context_t context;
+    init_mock(&context, &state);
+
+    eth_hash_t tx_hash;
+    TEST_ASSERT_EQUAL(ESP_OK, eth_rpc_send_raw_transaction(&context, raw_tx, raw_len, tx_hash));
+    TEST_ASSERT_NOT_NULL(strstr(state.last_body, expected_raw));
+    TEST_ASSERT_EQUAL_HEX8(0x11, tx_hash[0]);
+
+    web3_cleanup(&context);
+}
+
+static void test_default_backend_for_http_url(void)
+{
+    web3_context_t context;
+    TEST_ASSERT_EQUAL(ESP_OK, web3_init(&context, STANDIN_URL("")));
+#if CONFIG_IDF_TARGET_LINUX
+    TEST_ASSERT_EQUAL_STRING("socket", context.transport->ops->name);
+#else
+    TEST_ASSERT_EQUAL_STRING("esp_http_client", context.transport->ops->name);
+#endif
+    web3_cleanup(&context);
+}
+
+static void test_socket_backend_rejects_unsupported_urls(void)
+{
+    web3_transport_t *transport = NULL;
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_SUPPORTED, web3_transport_socket_create("https://127.0.0.1:8545", &transport));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, web3_transport_socket_create("ftp://127.0.0.1", &transport));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, web3_transport_socket_create("http://:8545", &transport));
+}
+
+// 用socket后端对url查询count次余额，返回期间连接统计的变化。
+// expected是最后一次查询的预期结果，之前的查询都应成功
+static void socket_balances(const char *url, int count, esp_err_t expected, web3_request_stats_t *delta)
+{
+    if (!standin_available(STANDIN_HTTP_PORT)) {
+        TEST_IGNORE_MESSAGE("standin.py is not running");
+    }
+
+    web3_transport_t *transport = NULL;
+    web3_context_t context;
+    TEST_ASSERT_EQUAL(ESP_OK, web3_transport_socket_create(url, &transport));
+    TEST_ASSERT_EQUAL(ESP_OK, web3_init_with_transport(&context, url, transport));
+
+    web3_request_stats_t before, after;
+    web3_get_request_stats(&before);
+    eth_address_t address;
+    eth_address_from_hex(ADDRESS, address);
+    for (int i = 0; i < count; i++) {
+        esp_err_t result = i == count - 1 ? expected : ESP_OK;
+        uint256_t balance = {0};
+        TEST_ASSERT_EQUAL(result, eth_rpc_get_balance(&context, address, &balance));
+        if (result == ESP_OK) {
+            TEST_ASSERT_EQUAL_UINT64(ONE_ETH, balance.limbs[0]);
+        }
+    }
+    web3_get_request_stats(&after);
+    web3_cleanup(&context);
+
+    delta->connections_opened = after.connections_opened - before.connections_opened;
+    delta->connections_reused = after.connections_reused - before.connections_reused;
+    delta->stale_replays = after.stale_replays - before.stale_replays;
+}
+
+static void test_socket_backend_reuses_connection(void)
+{
+    web3_request_stats_t delta;
+    socket_balances(STANDIN_URL("/"), 3, ESP_OK, &delta);
+    TEST_ASSERT_EQUAL_UINT32(1, delta.connections_opened);
+    TEST_ASSERT_EQUAL_UINT32(2, delta.connections_reused);
+}
+
+static void test_socket_backend_replays_on_stale_connection(void)
+{
+    web3_request_stats_t delta;
+    socket_balances(STANDIN_URL("/stale"), 2, ESP_OK, &delta);
+    TEST_ASSERT_EQUAL_UINT32(2, delta.connections_opened);
+    TEST_ASSERT_EQUAL_UINT32(1, delta.stale_replays);
+}
+
+static void test_socket_backend_reads_until_close(void)
+{
+    web3_request_stats_t delta;
+    socket_balances(STANDIN_URL("/eof"), 2, ESP_OK, &delta);
+    TEST_ASSERT_EQUAL_UINT32(2, delta.connections_opened);
+    TEST_ASSERT_EQUAL_UINT32(0, delta.stale_replays);
+}
+
+// 复用的连接上收到不支持的响应不是连接失效，不能在新连接上重发
+static void test_socket_backend_rejects_chunked(void)
+{
+    web3_request_stats_t delta;
+    socket_balances(STANDIN_URL("/chunked"), 2, ESP_ERR_NOT_SUPPORTED, &delta);
+    TEST_ASSERT_EQUAL_UINT32(1, delta.connections_opened);
+    TEST_ASSERT_EQUAL_UINT32(0, delta.stale_replays);
+}
+
+void test_transport_run(void)
+{
+    RUN_TEST(test_mock_backend_serves_rpc);
+    RUN_TEST(test_mock_backend_error_is_returned);
+    RUN_TEST(test_mock_backend_signs_and_sends);
+    RUN_TEST(test_default_backend_for_http_url);
+    RUN_TEST(test_socket_backend_rejects_unsupported_urls);
+    RUN_TEST(test_socket_backend_reuses_connection);
+    RUN_TEST(test_socket_backend_replays_on_stale_connection);
+    RUN_TEST(test_socket_backend_reads_until_close);
+    RUN_TEST(test_socket_backend_rejects_chunked);
+}
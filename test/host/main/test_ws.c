@@ -0,0 +1,155 @@
+// WebSocket后端 (对standin.py): 请求、迟到响应的丢弃和订阅
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "unity.h"
+#include "web3.h"
+#include "web3_transport.h"
+#include "eth_rpc.h"
+#include "test_host.h"
+
+typedef struct {
+    volatile int heads;
+    uint64_t number;
+} head_state_t;
+
+static void on_head(void *user_ctx, char *result, size_t result_len)
+{
+    head_state_t *state = user_ctx;
+    eth_hash_t hash;
+    if (eth_rpc_parse_new_head(result, result_len, &state->number, hash) == ESP_OK) {
+        state->heads++;
+    }
+}
+
+// 回调执行时间超过请求超时，期间主任务调用web3_unsubscribe
+typedef struct {
+    volatile int entered;
+    volatile int returned;
+} slow_state_t;
+
+static void on_head_slow(void *user_ctx, char *result, size_t result_len)
+{
+    slow_state_t *state = user_ctx;
+    state->entered = 1;
+    vTaskDelay(pdMS_TO_TICKS(WEB3_WS_TIMEOUT_MS * 3 / 2));
+    state->returned = 1;
+}
+
+static void init_ws(web3_context_t *context)
+{
+    if (!standin_available(STANDIN_WS_PORT)) {
+        TEST_IGNORE_MESSAGE("standin.py is not running");
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, web3_init(context, STANDIN_WS_URL));
+    TEST_ASSERT_EQUAL_STRING("websocket", context->transport->ops->name);
+}
+
+static void test_ws_backend_serves_rpc(void)
+{
+    web3_context_t context;
+    init_ws(&context);
+
+    uint64_t block_number = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, eth_get_block_number(&context, &block_number));
+    TEST_ASSERT_EQUAL_UINT64(0x2a, block_number);
+    web3_cleanup(&context);
+}
+
+// 超时请求的响应在下一个请求等待期间到达，不能被当作下一个请求的响应
+static void test_ws_backend_drops_late_response(void)
+{
+    web3_context_t context;
+    init_ws(&context);
+
+    char params[16];
+    char result[128];
+    snprintf(params, sizeof(params), "[%d]", WEB3_WS_TIMEOUT_MS * 3 / 2);
+    TEST_ASSERT_EQUAL(ESP_ERR_TIMEOUT, web3_send_request(&context, "test_delay", params, result, sizeof(result)));
+
+    char expected[32];
+    snprintf(params, sizeof(params), "[%d]", WEB3_WS_TIMEOUT_MS * 4 / 5);
+    snprintf(expected, sizeof(expected), "\"0x%x\"", WEB3_WS_TIMEOUT_MS * 4 / 5);
+    TEST_ASSERT_EQUAL(ESP_OK, web3_send_request(&context, "test_delay", params, result, sizeof(result)));
+    TEST_ASSERT_NOT_NULL(strstr(result, expected));
+    web3_cleanup(&context);
+}
+
+// 同一个预生成的请求体重复发送 (如调用计划的轮询) 时，每次发送都有新的id
+static void test_ws_backend_drops_late_response_to_resent_body(void)
+{
+    web3_context_t context;
+    init_ws(&context);
+
+    // standin在连接上第一次调用时延迟超过超时，第二次在超时之内
+    char params[32];
+    char *body = NULL;
+    size_t body_len = 0;
+    snprintf(params, sizeof(params), "[%d,%d]", WEB3_WS_TIMEOUT_MS * 3 / 2, WEB3_WS_TIMEOUT_MS * 4 / 5);
+    TEST_ASSERT_EQUAL(ESP_OK, web3_render_request("test_delay", params, &body, &body_len));
+
+    char result[128];
+    web3_response_sink_t sink;
+    web3_sink_init_fixed(&sink, result, sizeof(result));
+    TEST_ASSERT_EQUAL(ESP_ERR_TIMEOUT, web3_send_body_sink(&context, body, body_len, &sink));
+
+    char expected[32];
+    snprintf(expected, sizeof(expected), "\"0x%x\"", WEB3_WS_TIMEOUT_MS * 4 / 5);
+    TEST_ASSERT_EQUAL(ESP_OK, web3_send_body_sink(&context, body, body_len, &sink));
+    TEST_ASSERT_NOT_NULL(strstr(result, expected));
+    free(body);
+    web3_cleanup(&context);
+}
+
+static void test_ws_subscription_notifies_until_unsubscribed(void)
+{
+    web3_context_t context;
+    init_ws(&context);
+
+    head_state_t state = {0};
+    char subscription_id[WEB3_SUBSCRIPTION_ID_LEN];
+    TEST_ASSERT_EQUAL(ESP_OK, eth_rpc_subscribe_new_heads(&context, on_head, &state, subscription_id));
+    TEST_ASSERT_TRUE(web3_is_subscribed(&context, subscription_id));
+    for (int i = 0; i < 100 && state.heads == 0; i++) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    TEST_ASSERT_EQUAL(1, state.heads);
+    TEST_ASSERT_EQUAL_UINT64(0x2a, state.number);
+
+    TEST_ASSERT_EQUAL(ESP_OK, web3_unsubscribe(&context, subscription_id));
+    TEST_ASSERT_FALSE(web3_is_subscribed(&context, subscription_id));
+    web3_cleanup(&context);
+}
+
+// web3_unsubscribe返回后回调不再使用user_ctx，调用者可以立即释放
+static void test_ws_unsubscribe_waits_for_running_callback(void)
+{
+    web3_context_t context;
+    init_ws(&context);
+
+    slow_state_t *state = calloc(1, sizeof(*state));
+    TEST_ASSERT_NOT_NULL(state);
+    char subscription_id[WEB3_SUBSCRIPTION_ID_LEN];
+    TEST_ASSERT_EQUAL(ESP_OK, eth_rpc_subscribe_new_heads(&context, on_head_slow, state, subscription_id));
+    for (int i = 0; i < 100 && !state->entered; i++) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    TEST_ASSERT_EQUAL(1, state->entered);
+
+    TEST_ASSERT_EQUAL(ESP_OK, web3_unsubscribe(&context, subscription_id));
+    TEST_ASSERT_EQUAL(1, state->returned);
+    free(state);
+    web3_cleanup(&context);
+}
+
+void test_ws_run(void)
+{
+    RUN_TEST(test_ws_backend_serves_rpc);
+    RUN_TEST(test_ws_backend_drops_late_response);
+    RUN_TEST(test_ws_backend_drops_late_response_to_resent_body);
+    RUN_TEST(test_ws_subscription_notifies_until_unsubscribed);
+    RUN_TEST(test_ws_unsubscribe_waits_for_running_callback);
+}
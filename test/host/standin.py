@@ -0,0 +1,211 @@
+#!/usr/bin/env python3
+"""
+主机测试用的以太坊节点替身
+
+只实现测试需要的少量JSON-RPC方法，不依赖第三方库:
+
+    HTTP  127.0.0.1:18545   原始socket后端的测试
+    路径决定连接行为:
+        /          正常keep-alive
+        /stale     回复后静默关闭连接 (不带Connection: close)，模拟节点空闲超时
+        /chunked   连接上的第一个请求正常回复，之后以chunked编码回复
+                   (后端应拒绝，且不在新连接上重发)
+        /eof       HTTP/1.0，无Content-Length，以关闭连接结束响应
+
+    WS    127.0.0.1:18546   WebSocket后端的测试
+        test_delay [ms, ...]
+                          连接上第n次调用在第n个ms毫秒后回复 (超出时取最后一个)，
+                          结果为该ms的十六进制，用于制造迟到的响应
+        eth_subscribe     回复订阅ID后立即推送一条newHeads通知
+        eth_unsubscribe   回复true
+
+用法: standin.py [http端口] [ws端口]
+"""
+
+import base64
+import hashlib
+import json
+import socketserver
+import struct
+import sys
+import threading
+
+BALANCE = "0xde0b6b3a7640000"   # 1 ETH
+BLOCK_NUMBER = "0x2a"
+BLOCK_HASH = "0x" + "ab" * 32
+SUBSCRIPTION_ID = "0x9cef478923ff08bf67fde6c64013158d"
+WS_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+
+def rpc_result(request):
+    method = request.get("method")
+    if method == "eth_getBalance":
+        return BALANCE
+    if method == "eth_blockNumber":
+        return BLOCK_NUMBER
+    return None
+
+
+def rpc_reply(request):
+    reply = {"jsonrpc": "2.0", "id": request.get("id")}
+    result = rpc_result(request)
+    if result is None:
+        reply["error"] = {"code": -32601, "message": "method not found"}
+    else:
+        reply["result"] = result
+    return reply
+
+
+def rpc_handle(body):
+    request = json.loads(body)
+    if isinstance(request, list):
+        return json.dumps([rpc_reply(r) for r in request]).encode()
+    return json.dumps(rpc_reply(request)).encode()
+
+
+class HttpHandler(socketserver.StreamRequestHandler):
+    def handle(self):
+        served = 0
+        while True:
+            line = self.rfile.readline()
+            if not line:
+                return
+            path = line.split()[1].decode()
+            length = 0
+            while True:
+                header = self.rfile.readline()
+                if header in (b"\r\n", b""):
+                    break
+                name, value = header.decode().split(":", 1)
+                if name.strip().lower() == "content-length":
+                    length = int(value)
+            response = rpc_handle(self.rfile.read(length))
+
+            served += 1
+            if path == "/chunked" and served > 1:
+                self.wfile.write(b"HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+                                 + b"%x\r\n" % len(response) + response + b"\r\n0\r\n\r\n")
+                continue
+            if path == "/eof":
+                self.wfile.write(b"HTTP/1.0 200 OK\r\nContent-Type: application/json\r\n\r\n" + response)
+                return
+            self.wfile.write(b"HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"
+                             + b"Content-Length: %d\r\n\r\n" % len(response) + response)
+            if path == "/stale":
+                return
+
+
+class WsHandler(socketserver.StreamRequestHandler):
+    """最小的RFC 6455服务端: 只处理文本帧、ping和close"""
+
+    def setup(self):
+        super().setup()
+        self.send_lock = threading.Lock()
+        self.delay_calls = 0
+
+    def handle(self):
+        key = None
+        self.rfile.readline()
+        while True:
+            header = self.rfile.readline()
+            if header in (b"\r\n", b""):
+                break
+            name, value = header.decode().split(":", 1)
+            if name.strip().lower() == "sec-websocket-key":
+                key = value.strip()
+        if key is None:
+            return
+        accept = base64.b64encode(hashlib.sha1((key + WS_GUID).encode()).digest()).decode()
+        self.wfile.write(("HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\n"
+                          "Connection: Upgrade\r\nSec-WebSocket-Accept: %s\r\n\r\n" % accept).encode())
+
+        message = b""
+        while True:
+            frame = self.read_frame()
+            if frame is None:
+                return
+            fin, opcode, payload = frame
+            if opcode == 0x8:
+                self.send_frame(0x8, payload[:2])
+                return
+            if opcode == 0x9:
+                self.send_frame(0xA, payload)
+                continue
+            if opcode not in (0x0, 0x1):
+                continue
+            message += payload
+            if fin:
+                self.handle_message(json.loads(message))
+                message = b""
+
+    def read_frame(self):
+        head = self.rfile.read(2)
+        if len(head) < 2:
+            return None
+        length = head[1] & 0x7F
+        if length == 126:
+            length = struct.unpack(">H", self.rfile.read(2))[0]
+        elif length == 127:
+            length = struct.unpack(">Q", self.rfile.read(8))[0]
+        mask = self.rfile.read(4) if head[1] & 0x80 else b"\0\0\0\0"
+        payload = bytes(b ^ mask[i % 4] for i, b in enumerate(self.rfile.read(length)))
+        return head[0] & 0x80, head[0] & 0x0F, payload
+
+    def send_frame(self, opcode, payload):
+        if len(payload) < 126:
+            head = struct.pack(">BB", 0x80 | opcode, len(payload))
+        elif len(payload) < 0x10000:
+            head = struct.pack(">BBH", 0x80 | opcode, 126, len(payload))
+        else:
+            head = struct.pack(">BBQ", 0x80 | opcode, 127, len(payload))
+        with self.send_lock:
+            try:
+                self.wfile.write(head + payload)
+            except OSError:
+                pass
+
+    def send_json(self, value):
+        self.send_frame(0x1, json.dumps(value).encode())
+
+    def handle_message(self, request):
+        if isinstance(request, list):
+            self.send_json([rpc_reply(r) for r in request])
+            return
+        method = request.get("method")
+        reply = {"jsonrpc": "2.0", "id": request.get("id")}
+        if method == "test_delay":
+            delays = request["params"]
+            delay_ms = delays[min(self.delay_calls, len(delays) - 1)]
+            self.delay_calls += 1
+            reply["result"] = hex(delay_ms)
+            threading.Timer(delay_ms / 1000.0, self.send_json, (reply,)).start()
+        elif method == "eth_subscribe":
+            reply["result"] = SUBSCRIPTION_ID
+            self.send_json(reply)
+            self.send_json({"jsonrpc": "2.0", "method": "eth_subscription",
+                            "params": {"subscription": SUBSCRIPTION_ID,
+                                       "result": {"number": BLOCK_NUMBER, "hash": BLOCK_HASH}}})
+        elif method == "eth_unsubscribe":
+            reply["result"] = True
+            self.send_json(reply)
+        else:
+            self.send_json(rpc_reply(request))
+
+
+class Server(socketserver.ThreadingTCPServer):
+    allow_reuse_address = True
+    daemon_threads = True
+
+
+def main():
+    http_port = int(sys.argv[1]) if len(sys.argv) > 1 else 18545
+    ws_port = int(sys.argv[2]) if len(sys.argv) > 2 else 18546
+    ws_server = Server(("127.0.0.1", ws_port), WsHandler)
+    threading.Thread(target=ws_server.serve_forever, daemon=True).start()
+    with Server(("127.0.0.1", http_port), HttpHandler) as server:
+        print("standin: http://127.0.0.1:%d ws://127.0.0.1:%d" % (http_port, ws_port), flush=True)
+        server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()